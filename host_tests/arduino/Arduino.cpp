@@ -0,0 +1,294 @@
+#include "Arduino.h"
+
+volatile uint8_t PORTB, DDRB, PINB;
+volatile uint8_t PORTC, DDRC, PINC;
+volatile uint8_t PORTD, DDRD, PIND;
+volatile uint8_t SREG;
+volatile uint8_t TCCR0A, TCCR0B, OCR0A, TIMSK0;
+volatile uint8_t TCCR1A, TCCR1B;
+volatile uint16_t OCR1A, TCNT1;
+
+HostTimerMask TIMSK1;
+void (*hostTimer1Vector)() = NULL;
+void (*hostCycleDelay)(unsigned int cycles) = NULL;
+
+HostPin hostPins[HOST_PINS];
+unsigned long hostTones = 0;
+unsigned int hostToneFrequency = 0;
+
+HardwareSerial Serial;
+
+static unsigned long long hostMicros = 0;
+static bool inTimer1 = false;
+
+// ----------------------------------------------------------------------------------------------------
+HostTimerMask &HostTimerMask::operator=(uint8_t bits)
+{
+  value = bits;
+
+  // Only the outermost write runs the vector; the vector's own writes just land
+  if (inTimer1 || hostTimer1Vector == NULL)
+  {
+    return *this;
+  }
+  inTimer1 = true;
+  while (value & _BV(OCIE1A))
+  {
+    hostTimer1Vector();
+  }
+  inTimer1 = false;
+  return *this;
+}
+
+// ----------------------------------------------------------------------------------------------------
+void hostAdvance(unsigned long us)
+{
+  hostMicros += us;
+}
+
+// ----------------------------------------------------------------------------------------------------
+void hostReset()
+{
+  hostMicros = 0;
+  for (byte pin = 0; pin < HOST_PINS; pin++)
+  {
+    hostPins[pin].mode = INPUT;
+    hostPins[pin].output = LOW;
+    hostPins[pin].input = HIGH;
+  }
+  hostTones = 0;
+  hostToneFrequency = 0;
+}
+
+// ----------------------------------------------------------------------------------------------------
+unsigned long millis()
+{
+  return hostMicros / 1000;
+}
+
+// ----------------------------------------------------------------------------------------------------
+unsigned long micros()
+{
+  return hostMicros;
+}
+
+// ----------------------------------------------------------------------------------------------------
+void delay(unsigned long ms)
+{
+  hostMicros += ms * 1000ULL;
+}
+
+// ----------------------------------------------------------------------------------------------------
+void delayMicroseconds(unsigned int us)
+{
+  hostMicros += us;
+}
+
+// ----------------------------------------------------------------------------------------------------
+void pinMode(uint8_t pin, uint8_t mode)
+{
+  if (pin < HOST_PINS)
+  {
+    hostPins[pin].mode = mode;
+  }
+}
+
+// ----------------------------------------------------------------------------------------------------
+void digitalWrite(uint8_t pin, uint8_t value)
+{
+  if (pin < HOST_PINS)
+  {
+    hostPins[pin].output = value ? HIGH : LOW;
+  }
+}
+
+// ----------------------------------------------------------------------------------------------------
+int digitalRead(uint8_t pin)
+{
+  return (pin < HOST_PINS) ? hostPins[pin].input : LOW;
+}
+
+// ----------------------------------------------------------------------------------------------------
+int analogRead(uint8_t pin)
+{
+  return (pin < HOST_PINS && hostPins[pin].input) ? 1023 : 0;
+}
+
+// ----------------------------------------------------------------------------------------------------
+void tone(uint8_t pin, unsigned int frequency, unsigned long duration)
+{
+  (void)pin;
+  (void)duration;
+  hostTones++;
+  hostToneFrequency = frequency;
+}
+
+// ----------------------------------------------------------------------------------------------------
+void noTone(uint8_t pin)
+{
+  (void)pin;
+  hostToneFrequency = 0;
+}
+
+// ----------------------------------------------------------------------------------------------------
+char *ultoa(unsigned long value, char *dest, int base)
+{
+  char digits[33];
+  byte n = 0;
+
+  do
+  {
+    byte d = value % base;
+
+    digits[n++] = (d < 10) ? '0' + d : 'a' + d - 10;
+    value /= base;
+  } while (value != 0);
+
+  char *p = dest;
+
+  while (n != 0)
+  {
+    *p++ = digits[--n];
+  }
+  *p = '\0';
+  return dest;
+}
+
+// ----------------------------------------------------------------------------------------------------
+char *ltoa(long value, char *dest, int base)
+{
+  if (value < 0 && base == 10)
+  {
+    dest[0] = '-';
+    ultoa(-(unsigned long)value, dest + 1, base);
+    return dest;
+  }
+  return ultoa((unsigned long)value, dest, base);
+}
+
+// ----------------------------------------------------------------------------------------------------
+char *utoa(unsigned int value, char *dest, int base)
+{
+  return ultoa(value, dest, base);
+}
+
+// ----------------------------------------------------------------------------------------------------
+char *itoa(int value, char *dest, int base)
+{
+  return ltoa(value, dest, base);
+}
+
+// ----------------------------------------------------------------------------------------------------
+char *dtostrf(double value, signed char width, unsigned char precision, char *dest)
+{
+  sprintf(dest, "%*.*f", width, precision, value);
+  return dest;
+}
+
+// ----------------------------------------------------------------------------------------------------
+String::String(unsigned char value, unsigned char base)
+{
+  char s[9];
+
+  text = ultoa(value, s, base);
+}
+
+// ----------------------------------------------------------------------------------------------------
+String::String(int value, unsigned char base)
+{
+  char s[34];
+
+  text = ltoa(value, s, base);
+}
+
+// ----------------------------------------------------------------------------------------------------
+String::String(unsigned int value, unsigned char base)
+{
+  char s[33];
+
+  text = ultoa(value, s, base);
+}
+
+// ----------------------------------------------------------------------------------------------------
+String::String(long value, unsigned char base)
+{
+  char s[34];
+
+  text = ltoa(value, s, base);
+}
+
+// ----------------------------------------------------------------------------------------------------
+String::String(unsigned long value, unsigned char base)
+{
+  char s[33];
+
+  text = ultoa(value, s, base);
+}
+
+// ----------------------------------------------------------------------------------------------------
+String::String(double value, unsigned char decimals)
+{
+  char s[40];
+
+  snprintf(s, sizeof(s), "%.*f", decimals, value);
+  text = s;
+}
+
+// ----------------------------------------------------------------------------------------------------
+int String::indexOf(char c) const
+{
+  size_t at = text.find(c);
+
+  return (at == std::string::npos) ? -1 : (int)at;
+}
+
+// ----------------------------------------------------------------------------------------------------
+size_t Print::write(const uint8_t *buffer, size_t size)
+{
+  size_t n = 0;
+
+  while (size--)
+  {
+    n += write(*buffer++);
+  }
+  return n;
+}
+
+// ----------------------------------------------------------------------------------------------------
+size_t Print::print(long value, int base)
+{
+  char s[34];
+
+  return write(ltoa(value, s, base));
+}
+
+// ----------------------------------------------------------------------------------------------------
+size_t Print::print(unsigned long value, int base)
+{
+  char s[33];
+
+  return write(ultoa(value, s, base));
+}
+
+// ----------------------------------------------------------------------------------------------------
+size_t Print::print(double value, int digits)
+{
+  char s[40];
+
+  snprintf(s, sizeof(s), "%.*f", digits, value);
+  return write(s);
+}
+
+// ----------------------------------------------------------------------------------------------------
+int HardwareSerial::read()
+{
+  if (received.empty())
+  {
+    return -1;
+  }
+
+  int c = (uint8_t)received[0];
+
+  received.erase(0, 1);
+  return c;
+}
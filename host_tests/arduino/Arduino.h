@@ -0,0 +1,202 @@
+#ifndef ARDUINO_H_
+#define ARDUINO_H_
+
+// Host stand-in for the Arduino AVR core, just enough of it for the clock
+// sketches and their modules to build and run under g++ on a PC.
+//
+// Time does not pass on its own: millis(), micros() and delay() run on a
+// virtual clock that the tests move with hostAdvance(). Pins are an array,
+// and the ports, DDR and PIN registers the drivers touch directly are plain
+// variables. Flash is ordinary memory, so PROGMEM and pgm_read_*() are no-ops.
+//
+// Timer1's compare interrupt is modelled as what the drivers rely on: setting
+// OCIE1A in TIMSK1 runs hostTimer1Vector until it clears the bit again, so
+// queued output drains in the order the AVR would send it, without threads.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+
+typedef uint8_t byte;
+typedef bool boolean;
+typedef unsigned int word;
+
+#define HIGH            1
+#define LOW             0
+#define INPUT           0
+#define OUTPUT          1
+#define INPUT_PULLUP    2
+
+#define A0              14
+#define A1              15
+#define A2              16
+#define A3              17
+#define A4              18
+#define A5              19
+#define SDA             18
+#define SCL             19
+#define HOST_PINS       20
+
+#define PI              3.1415926535897932384626433832795
+#define HALF_PI         1.5707963267948966192313216916398
+#define TWO_PI          6.283185307179586476925286766559
+#define DEG_TO_RAD      0.017453292519943295769236907684886
+
+#ifndef F_CPU
+#define F_CPU           16000000UL
+#endif
+
+#define _BV(bit)                (1 << (bit))
+#define bitRead(value, bit)     (((value) >> (bit)) & 0x01)
+#define constrain(x, lo, hi)    ((x) < (lo) ? (lo) : ((x) > (hi) ? (hi) : (x)))
+#define lowByte(w)              ((uint8_t)((w) & 0xFF))
+#define highByte(w)             ((uint8_t)((w) >> 8))
+
+// As templates rather than the core's macros, so they do not break the C++ headers
+template <class A, class B> inline auto min(A a, B b) -> decltype(a < b ? a : b) { return (a < b) ? a : b; }
+template <class A, class B> inline auto max(A a, B b) -> decltype(a < b ? a : b) { return (a < b) ? b : a; }
+
+// ----------------------------------------------------------------------------------------------------
+// Flash
+
+#define PROGMEM
+#define PGM_P                   const char *
+#define PSTR(s)                 (s)
+#define pgm_read_byte(p)        (*(const uint8_t *)(p))
+#define pgm_read_dword(p)       hostReadDword(p)
+#define pgm_read_ptr(p)         (*(void * const *)(p))
+
+// Flash pointers are 16 bits on the AVR, so the sketches read them with
+// pgm_read_word(); here the word read returns whatever the field holds.
+#define pgm_read_word(p)        hostReadField(p)
+
+template <class T> inline T hostReadField(const T *p) { return *p; }
+inline uint32_t hostReadDword(const void *p) { uint32_t v; memcpy(&v, p, sizeof(v)); return v; }
+#define memcpy_P                memcpy
+#define strcpy_P                strcpy
+#define strlen_P                strlen
+#define strcmp_P                strcmp
+
+class __FlashStringHelper;
+#define F(s)                    (reinterpret_cast<const __FlashStringHelper *>(s))
+
+// ----------------------------------------------------------------------------------------------------
+// Registers
+
+extern volatile uint8_t PORTB, DDRB, PINB;
+extern volatile uint8_t PORTC, DDRC, PINC;
+extern volatile uint8_t PORTD, DDRD, PIND;
+extern volatile uint8_t SREG;
+extern volatile uint8_t TCCR0A, TCCR0B, OCR0A, TIMSK0;
+extern volatile uint8_t TCCR1A, TCCR1B;
+extern volatile uint16_t OCR1A, TCNT1;
+
+// TIMSK1, which runs the compare interrupt while OCIE1A is set (see above)
+struct HostTimerMask
+{
+  volatile uint8_t value;
+
+  operator uint8_t() const { return value; }
+  HostTimerMask &operator=(uint8_t bits);
+  HostTimerMask &operator|=(uint8_t bits) { return *this = value | bits; }
+  HostTimerMask &operator&=(uint8_t bits) { return *this = value & bits; }
+};
+
+extern HostTimerMask TIMSK1;
+extern void (*hostTimer1Vector)();
+
+// TWCR, whose writes step the I2C bus model (see Wire.h)
+struct HostTwiControl
+{
+  volatile uint8_t value;
+
+  operator uint8_t() const { return value; }
+  HostTwiControl &operator=(uint8_t bits);
+};
+
+extern HostTwiControl TWCR;
+extern volatile uint8_t TWDR, TWSR;
+
+#define OCIE0A          1
+#define WGM01           1
+#define CS01            1
+#define CS00            0
+#define OCIE1A          1
+#define WGM12           3
+#define CS11            1
+#define TWIE            0
+#define TWEN            2
+#define TWSTO           4
+#define TWSTA           5
+#define TWEA            6
+#define TWINT           7
+
+#define SIGNAL(vector)          extern "C" void vector()
+#define ISR(vector, ...)        extern "C" void vector()
+#define TIMER0_COMPA_vect       hostTimer0CompaVect
+#define TIMER1_COMPA_vect       hostTimer1CompaVect
+
+inline void cli() {}
+inline void sei() {}
+inline void interrupts() {}
+inline void noInterrupts() {}
+
+// Called for each __builtin_avr_delay_cycles(), which the drivers use for pulse widths
+extern void (*hostCycleDelay)(unsigned int cycles);
+#define __builtin_avr_delay_cycles(n)   do { if (hostCycleDelay != NULL) hostCycleDelay(n); } while (0)
+
+// ----------------------------------------------------------------------------------------------------
+// The sketch
+
+extern void setup(void);
+extern void loop(void);
+
+// ----------------------------------------------------------------------------------------------------
+// Time, pins and tone
+
+extern unsigned long millis();
+extern unsigned long micros();
+extern void delay(unsigned long ms);
+extern void delayMicroseconds(unsigned int us);
+
+extern void pinMode(uint8_t pin, uint8_t mode);
+extern void digitalWrite(uint8_t pin, uint8_t value);
+extern int digitalRead(uint8_t pin);
+extern int analogRead(uint8_t pin);
+extern void tone(uint8_t pin, unsigned int frequency, unsigned long duration = 0);
+extern void noTone(uint8_t pin);
+
+// Moves the virtual clock on.
+extern void hostAdvance(unsigned long us);
+// Sets millis() and micros() to 0 and all pins to inputs reading high.
+extern void hostReset();
+
+typedef struct HostPin {
+  uint8_t mode;
+  uint8_t output;               // last digitalWrite()
+  uint8_t input;                // what digitalRead() returns, set by the tests
+} HostPin;
+
+extern HostPin hostPins[HOST_PINS];
+extern unsigned long hostTones;         // tone() calls
+extern unsigned int hostToneFrequency;  // 0 while silent
+
+// ----------------------------------------------------------------------------------------------------
+// Text
+
+// avr-libc conversions that glibc lacks
+extern char *itoa(int value, char *dest, int base);
+extern char *utoa(unsigned int value, char *dest, int base);
+extern char *ltoa(long value, char *dest, int base);
+extern char *ultoa(unsigned long value, char *dest, int base);
+extern char *dtostrf(double value, signed char width, unsigned char precision, char *dest);
+
+#include "binary.h"
+#include "WString.h"
+#include "Print.h"
+#include "HardwareSerial.h"
+
+#endif
@@ -0,0 +1,24 @@
+#ifndef EEPROM_H_
+#define EEPROM_H_
+
+// The ATmega328's 1 KB EEPROM, with a count of the writes so tests can check wear.
+
+#include "Arduino.h"
+
+#define HOST_EEPROM_SIZE 1024
+
+class EEPROMClass
+{
+  public:
+    uint8_t read(int address) const { return data[address]; }
+    void write(int address, uint8_t value) { data[address] = value; writes++; }
+    void update(int address, uint8_t value) { if (data[address] != value) write(address, value); }
+    uint16_t length() const { return HOST_EEPROM_SIZE; }
+
+    uint8_t data[HOST_EEPROM_SIZE];
+    unsigned long writes;
+};
+
+extern EEPROMClass EEPROM;
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef HARDWARESERIAL_H_
+#define HARDWARESERIAL_H_
+
+#include <string>
+#include "Print.h"
+
+class Stream : public Print
+{
+  public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+};
+
+// Serial port whose output collects in sent and whose input comes from
+// received. txRoom is what availableForWrite() reports, 63 bytes as on the
+// AVR unless a test wants a slower port.
+class HardwareSerial : public Stream
+{
+  public:
+    void begin(unsigned long baud) { (void)baud; }
+    void end() {}
+
+    virtual size_t write(uint8_t c) { sent += (char)c; return 1; }
+    using Print::write;
+    virtual int availableForWrite() { return txRoom; }
+
+    virtual int available() { return received.size(); }
+    virtual int read();
+    virtual int peek() { return received.empty() ? -1 : (uint8_t)received[0]; }
+
+    operator bool() const { return true; }
+
+    std::string sent;
+    std::string received;
+    int txRoom = 63;
+};
+
+extern HardwareSerial Serial;
+
+#endif
@@ -0,0 +1,206 @@
+#include "TimeLib.h"
+
+#define LEAP_YEAR(Y)  (((1970 + (Y)) % 4 == 0) && (((1970 + (Y)) % 100 != 0) || ((1970 + (Y)) % 400 == 0)))
+
+static const uint8_t monthDays[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+
+static time_t sysTime = 0;
+static unsigned long prevMillis = 0;
+static time_t nextSyncTime = 0;
+static time_t syncInterval = 300;
+static timeStatus_t status = timeNotSet;
+static getExternalTime getTime = NULL;
+
+// ----------------------------------------------------------------------------------------------------
+time_t makeTime(const tmElements_t &tm)
+{
+  time_t seconds = tm.Year * SECS_PER_DAY * 365;
+
+  for (int y = 0; y < tm.Year; y++)
+  {
+    if (LEAP_YEAR(y))
+    {
+      seconds += SECS_PER_DAY;
+    }
+  }
+  for (int m = 1; m < tm.Month; m++)
+  {
+    seconds += SECS_PER_DAY * ((m == 2 && LEAP_YEAR(tm.Year)) ? 29 : monthDays[m - 1]);
+  }
+  seconds += (tm.Day - 1) * SECS_PER_DAY;
+  seconds += tm.Hour * SECS_PER_HOUR;
+  seconds += tm.Minute * SECS_PER_MIN;
+  seconds += tm.Second;
+  return seconds;
+}
+
+// ----------------------------------------------------------------------------------------------------
+void breakTime(time_t t, tmElements_t &tm)
+{
+  tm.Second = t % 60;
+  t /= 60;
+  tm.Minute = t % 60;
+  t /= 60;
+  tm.Hour = t % 24;
+  t /= 24;
+  tm.Wday = ((t + 4) % 7) + 1;    // 1 January 1970 was a Thursday
+
+  uint8_t year = 0;
+  unsigned long days = 0;
+
+  while ((days += (LEAP_YEAR(year) ? 366 : 365)) <= (unsigned long)t)
+  {
+    year++;
+  }
+  tm.Year = year;
+  days -= LEAP_YEAR(year) ? 366 : 365;
+  t -= days;
+
+  uint8_t month;
+
+  for (month = 0; month < 12; month++)
+  {
+    uint8_t length = (month == 1 && LEAP_YEAR(year)) ? 29 : monthDays[month];
+
+    if (t < length)
+    {
+      break;
+    }
+    t -= length;
+  }
+  tm.Month = month + 1;
+  tm.Day = t + 1;
+}
+
+// ----------------------------------------------------------------------------------------------------
+time_t now()
+{
+  while (millis() - prevMillis >= 1000)
+  {
+    sysTime++;
+    prevMillis += 1000;
+  }
+  if (nextSyncTime <= sysTime && getTime != NULL)
+  {
+    time_t t = getTime();
+
+    if (t != 0)
+    {
+      setTime(t);
+    }
+    else
+    {
+      nextSyncTime = sysTime + syncInterval;
+      status = (status == timeNotSet) ? timeNotSet : timeNeedsSync;
+    }
+  }
+  return sysTime;
+}
+
+// ----------------------------------------------------------------------------------------------------
+void setTime(time_t t)
+{
+  sysTime = t;
+  nextSyncTime = t + syncInterval;
+  status = timeSet;
+  prevMillis = millis();
+}
+
+// ----------------------------------------------------------------------------------------------------
+void setTime(int hr, int min, int sec, int dy, int mnth, int yr)
+{
+  tmElements_t tm;
+
+  tm.Year = (yr > 99) ? CalendarYrToTm(yr) : y2kYearToTm(yr);
+  tm.Month = mnth;
+  tm.Day = dy;
+  tm.Hour = hr;
+  tm.Minute = min;
+  tm.Second = sec;
+  setTime(makeTime(tm));
+}
+
+// ----------------------------------------------------------------------------------------------------
+timeStatus_t timeStatus()
+{
+  now();
+  return status;
+}
+
+// ----------------------------------------------------------------------------------------------------
+void setSyncProvider(getExternalTime provider)
+{
+  getTime = provider;
+  nextSyncTime = sysTime;
+  now();
+}
+
+// ----------------------------------------------------------------------------------------------------
+void setSyncInterval(time_t interval)
+{
+  syncInterval = interval;
+  nextSyncTime = sysTime + syncInterval;
+}
+
+// ----------------------------------------------------------------------------------------------------
+int hour(time_t t)
+{
+  tmElements_t tm;
+
+  breakTime(t, tm);
+  return tm.Hour;
+}
+
+// ----------------------------------------------------------------------------------------------------
+int minute(time_t t)
+{
+  tmElements_t tm;
+
+  breakTime(t, tm);
+  return tm.Minute;
+}
+
+// ----------------------------------------------------------------------------------------------------
+int second(time_t t)
+{
+  tmElements_t tm;
+
+  breakTime(t, tm);
+  return tm.Second;
+}
+
+// ----------------------------------------------------------------------------------------------------
+int day(time_t t)
+{
+  tmElements_t tm;
+
+  breakTime(t, tm);
+  return tm.Day;
+}
+
+// ----------------------------------------------------------------------------------------------------
+int weekday(time_t t)
+{
+  tmElements_t tm;
+
+  breakTime(t, tm);
+  return tm.Wday;
+}
+
+// ----------------------------------------------------------------------------------------------------
+int month(time_t t)
+{
+  tmElements_t tm;
+
+  breakTime(t, tm);
+  return tm.Month;
+}
+
+// ----------------------------------------------------------------------------------------------------
+int year(time_t t)
+{
+  tmElements_t tm;
+
+  breakTime(t, tm);
+  return tmYearToCalendar(tm.Year);
+}
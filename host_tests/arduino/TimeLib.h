@@ -0,0 +1,57 @@
+#ifndef TIMELIB_H_
+#define TIMELIB_H_
+
+// Host copy of the Time library's interface: calendar conversions and a
+// system clock that counts on from millis() and resyncs from a provider.
+
+#include "Arduino.h"
+#include <sys/types.h>     // time_t; time.h would declare clock(), which the v7 sketch uses as a name
+
+typedef enum { timeNotSet, timeNeedsSync, timeSet } timeStatus_t;
+
+typedef struct {
+  uint8_t Second;
+  uint8_t Minute;
+  uint8_t Hour;
+  uint8_t Wday;     // day of week, Sunday is 1
+  uint8_t Day;
+  uint8_t Month;
+  uint8_t Year;     // offset from 1970
+} tmElements_t;
+
+typedef time_t (*getExternalTime)();
+
+#define SECS_PER_MIN            60UL
+#define SECS_PER_HOUR           3600UL
+#define SECS_PER_DAY            86400UL
+#define DAYS_PER_WEEK           7UL
+#define SECS_PER_WEEK           (SECS_PER_DAY * DAYS_PER_WEEK)
+
+#define tmYearToCalendar(Y)     ((Y) + 1970)
+#define CalendarYrToTm(Y)       ((Y) - 1970)
+#define tmYearToY2k(Y)          ((Y) - 30)
+#define y2kYearToTm(Y)          ((Y) + 30)
+
+#define elapsedSecsToday(t)     ((t) % SECS_PER_DAY)
+#define previousMidnight(t)     (((t) / SECS_PER_DAY) * SECS_PER_DAY)
+#define nextMidnight(t)         (previousMidnight(t) + SECS_PER_DAY)
+
+extern time_t makeTime(const tmElements_t &tm);
+extern void breakTime(time_t t, tmElements_t &tm);
+
+extern time_t now();
+extern void setTime(time_t t);
+extern void setTime(int hr, int min, int sec, int day, int month, int yr);
+extern timeStatus_t timeStatus();
+extern void setSyncProvider(getExternalTime provider);
+extern void setSyncInterval(time_t interval);
+
+extern int hour(time_t t);
+extern int minute(time_t t);
+extern int second(time_t t);
+extern int day(time_t t);
+extern int weekday(time_t t);
+extern int month(time_t t);
+extern int year(time_t t);
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef WSTRING_H_
+#define WSTRING_H_
+
+// The parts of the Arduino String class the sketches use, with the same
+// number formatting: String(char) is one character, String(int) its digits.
+
+#include <string>
+
+class String
+{
+  public:
+    String() {}
+    String(const char *s) : text(s ? s : "") {}
+    String(const std::string &s) : text(s) {}
+    explicit String(char c) : text(1, c) {}
+    explicit String(unsigned char value, unsigned char base = 10);
+    explicit String(int value, unsigned char base = 10);
+    explicit String(unsigned int value, unsigned char base = 10);
+    explicit String(long value, unsigned char base = 10);
+    explicit String(unsigned long value, unsigned char base = 10);
+    explicit String(double value, unsigned char decimals = 2);
+
+    unsigned int length() const { return text.size(); }
+    const char *c_str() const { return text.c_str(); }
+    char charAt(unsigned int index) const { return (index < text.size()) ? text[index] : 0; }
+    char operator[](unsigned int index) const { return charAt(index); }
+    String substring(unsigned int from) const { return String(text.substr(from)); }
+    String substring(unsigned int from, unsigned int to) const { return String(text.substr(from, to - from)); }
+    int indexOf(char c) const;
+    long toInt() const { return atol(text.c_str()); }
+    bool reserve(unsigned int size) { text.reserve(size); return true; }
+
+    String &operator+=(const String &s) { text += s.text; return *this; }
+    String &operator+=(const char *s) { text += s; return *this; }
+    String &operator+=(char c) { text += c; return *this; }
+    template <class T> String &operator+=(T value) { return *this += String(value); }
+
+    // The real class takes a number through its StringSumHelper
+    String &operator=(int value) { return *this = String(value); }
+
+    bool operator==(const String &s) const { return text == s.text; }
+    bool operator==(const char *s) const { return text == s; }
+    bool operator!=(const String &s) const { return text != s.text; }
+    bool operator!=(const char *s) const { return text != s; }
+
+  private:
+    std::string text;
+};
+
+inline String operator+(const String &a, const String &b) { String s(a); s += b; return s; }
+inline String operator+(const String &a, const char *b) { String s(a); s += b; return s; }
+inline String operator+(const char *a, const String &b) { String s(a); s += b; return s; }
+inline String operator+(const String &a, char c) { String s(a); s += c; return s; }
+inline String operator+(char c, const String &b) { String s(c); s += b; return s; }
+template <class T> inline String operator+(const String &a, T value) { return a + String(value); }
+
+#endif
@@ -0,0 +1,153 @@
+#include "Wire.h"
+#include <util/twi.h>
+
+TwoWire Wire;
+HostI2cDevice *hostI2cDevice = NULL;
+
+HostTwiControl TWCR;
+volatile uint8_t TWDR, TWSR;
+
+static bool twiActive = false;          // the TWI has sent a start and no stop since
+static bool twiAddressNext = false;     // its next byte is SLA+R/W
+
+// ----------------------------------------------------------------------------------------------------
+// Bus steps, each one byte's time
+static bool busStart(uint8_t address, bool read)
+{
+  hostAdvance(HOST_I2C_BYTE_US);
+  return hostI2cDevice != NULL && hostI2cDevice->start(address, read);
+}
+
+// ----------------------------------------------------------------------------------------------------
+static bool busWrite(uint8_t value)
+{
+  hostAdvance(HOST_I2C_BYTE_US);
+  return hostI2cDevice != NULL && hostI2cDevice->write(value);
+}
+
+// ----------------------------------------------------------------------------------------------------
+static uint8_t busRead()
+{
+  hostAdvance(HOST_I2C_BYTE_US);
+  return (hostI2cDevice != NULL) ? hostI2cDevice->read() : 0xFF;
+}
+
+// ----------------------------------------------------------------------------------------------------
+static void busStop()
+{
+  if (hostI2cDevice != NULL)
+  {
+    hostI2cDevice->stop();
+  }
+}
+
+// ----------------------------------------------------------------------------------------------------
+void TwoWire::beginTransmission(uint8_t address)
+{
+  this->address = address;
+  length = 0;
+}
+
+// ----------------------------------------------------------------------------------------------------
+size_t TwoWire::write(uint8_t value)
+{
+  if (length == BUFFER_LENGTH)
+  {
+    return 0;
+  }
+  buffer[length++] = value;
+  return 1;
+}
+
+// ----------------------------------------------------------------------------------------------------
+size_t TwoWire::write(const uint8_t *data, size_t count)
+{
+  size_t done = 0;
+
+  while (done < count && write(data[done]))
+  {
+    done++;
+  }
+  return done;
+}
+
+// ----------------------------------------------------------------------------------------------------
+// 0 if sent, 2 if the address was NACKed, 3 if a data byte was.
+uint8_t TwoWire::endTransmission(bool stop)
+{
+  uint8_t status = 0;
+
+  if (!busStart(address, false))
+  {
+    status = 2;
+  }
+  for (uint8_t i = 0; status == 0 && i < length; i++)
+  {
+    if (!busWrite(buffer[i]))
+    {
+      status = 3;
+    }
+  }
+  if (stop || status != 0)
+  {
+    busStop();
+  }
+  length = 0;
+  return status;
+}
+
+// ----------------------------------------------------------------------------------------------------
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t count)
+{
+  received = 0;
+  next = 0;
+  if (count > BUFFER_LENGTH)
+  {
+    count = BUFFER_LENGTH;
+  }
+  if (busStart(address, true))
+  {
+    while (received < count)
+    {
+      buffer[received++] = busRead();
+    }
+  }
+  busStop();
+  return received;
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Master transmitter steps: a start, then each TWINT write sends TWDR, the
+// first byte being SLA+R/W, and a stop. Each sets TWINT and TWSR at once.
+HostTwiControl &HostTwiControl::operator=(uint8_t bits)
+{
+  value = bits;
+  if (bits & _BV(TWSTO))
+  {
+    busStop();
+    twiActive = false;
+    twiAddressNext = false;
+    value &= ~_BV(TWSTO);
+  }
+  else if (bits & _BV(TWSTA))
+  {
+    TWSR = twiActive ? TW_REP_START : TW_START;
+    twiActive = true;
+    twiAddressNext = true;
+    value |= _BV(TWINT);
+  }
+  else if (bits & _BV(TWINT))
+  {
+    if (twiAddressNext)
+    {
+      TWSR = busStart(TWDR >> 1, TWDR & 1) ? TW_MT_SLA_ACK : TW_MT_SLA_NACK;
+      twiAddressNext = false;
+    }
+    else
+    {
+      TWSR = busWrite(TWDR) ? TW_MT_DATA_ACK : TW_MT_DATA_NACK;
+    }
+    value |= _BV(TWINT);
+  }
+  return *this;
+}
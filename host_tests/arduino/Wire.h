@@ -0,0 +1,57 @@
+#ifndef WIRE_H_
+#define WIRE_H_
+
+// The Wire interface on a model of the I2C bus. Nothing is on the bus until a
+// test attaches a device, so by default every address is NACKed.
+//
+// Drivers that skip Wire and step the TWI hardware through TWCR (see
+// Arduino.h and util/twi.h) reach the same device. Every byte on the bus,
+// address bytes included, moves the virtual clock on by 90 us, as at 100 kHz,
+// so a driver that polls a busy chip sees time pass.
+
+#include "Arduino.h"
+
+#define BUFFER_LENGTH   32
+#define HOST_I2C_BYTE_US  90
+
+// A chip on the bus, which the tests model.
+class HostI2cDevice
+{
+  public:
+    virtual ~HostI2cDevice() {}
+
+    // A start (or repeated start) for the 7 bit address; false NACKs it.
+    virtual bool start(uint8_t address, bool read) = 0;
+    // A byte from the master; false NACKs it.
+    virtual bool write(uint8_t value) = 0;
+    // A byte for the master.
+    virtual uint8_t read() = 0;
+    virtual void stop() = 0;
+};
+
+extern HostI2cDevice *hostI2cDevice;
+
+class TwoWire
+{
+  public:
+    void begin() {}
+    void setClock(unsigned long clock) { (void)clock; }
+    void beginTransmission(uint8_t address);
+    size_t write(uint8_t value);
+    size_t write(const uint8_t *data, size_t length);
+    uint8_t endTransmission(bool stop = true);
+    uint8_t requestFrom(uint8_t address, uint8_t count);
+    int available() { return received - next; }
+    int read() { return (next < received) ? buffer[next++] : -1; }
+
+  private:
+    uint8_t buffer[BUFFER_LENGTH];
+    uint8_t address;
+    uint8_t length;             // bytes queued for the transmission
+    uint8_t received;           // bytes from requestFrom()
+    uint8_t next;
+};
+
+extern TwoWire Wire;
+
+#endif
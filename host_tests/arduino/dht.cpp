@@ -0,0 +1,16 @@
+#include "dht.h"
+
+int (*hostDhtSample)(double *temperature, double *humidity) = NULL;
+unsigned long hostDhtReads = 0;
+
+// ----------------------------------------------------------------------------------------------------
+int dht::read(uint8_t pin)
+{
+  (void)pin;
+  hostDhtReads++;
+  if (hostDhtSample == NULL)
+  {
+    return DHTLIB_ERROR_TIMEOUT;
+  }
+  return hostDhtSample(&temperature, &humidity);
+}
@@ -0,0 +1,32 @@
+#ifndef DHT_H_
+#define DHT_H_
+
+// The DHTlib interface the v7 clock reads its DHT21 through. The readings
+// come from hostDhtSample, which a test points at its own sensor model.
+
+#include "Arduino.h"
+
+#define DHTLIB_OK               0
+#define DHTLIB_ERROR_CHECKSUM   -1
+#define DHTLIB_ERROR_TIMEOUT    -2
+
+class dht
+{
+  public:
+    int read11(uint8_t pin) { return read(pin); }
+    int read21(uint8_t pin) { return read(pin); }
+    int read22(uint8_t pin) { return read(pin); }
+
+    double humidity;
+    double temperature;
+
+  private:
+    int read(uint8_t pin);
+};
+
+// Fills in a reading and returns DHTLIB_OK or an error.
+extern int (*hostDhtSample)(double *temperature, double *humidity);
+// dht reads so far.
+extern unsigned long hostDhtReads;
+
+#endif
@@ -0,0 +1,19 @@
+#ifndef UTIL_TWI_H_
+#define UTIL_TWI_H_
+
+// avr-libc's TWI status codes, for drivers that step the TWI hardware
+// themselves. The registers are in Arduino.h.
+
+#include "Arduino.h"
+
+#define TW_STATUS_MASK      0xF8
+#define TW_STATUS           (TWSR & TW_STATUS_MASK)
+
+#define TW_START            0x08
+#define TW_REP_START        0x10
+#define TW_MT_SLA_ACK       0x18
+#define TW_MT_SLA_NACK      0x20
+#define TW_MT_DATA_ACK      0x28
+#define TW_MT_DATA_NACK     0x30
+
+#endif
@@ -0,0 +1,87 @@
+#include "Bench.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_MAX_CASES 32
+
+typedef struct BenchCase {
+  char name[32];
+  double value;
+} BenchCase;
+
+static BenchCase baseline[BENCH_MAX_CASES];
+static unsigned int baselineCount = 0;
+
+volatile unsigned long benchSink = 0;
+
+// ----------------------------------------------------------------------------------------------------
+static double seconds()
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// ----------------------------------------------------------------------------------------------------
+double benchNsPerCall(void (*body)(unsigned long i), unsigned long iterations)
+{
+  double best = 0;
+
+  for (int run = 0; run < BENCH_REPEATS; run++)
+  {
+    double start = seconds();
+
+    for (unsigned long i = 0; i < iterations; i++)
+    {
+      body(i);
+    }
+
+    double ns = (seconds() - start) * 1e9 / iterations;
+
+    if (run == 0 || ns < best)
+    {
+      best = ns;
+    }
+  }
+  return best;
+}
+
+// ----------------------------------------------------------------------------------------------------
+void benchBaseline(const char *path)
+{
+  FILE *file = fopen(path, "r");
+  char line[128];
+
+  baselineCount = 0;
+  if (file == NULL)
+  {
+    return;
+  }
+  while (fgets(line, sizeof(line), file) != NULL && baselineCount < BENCH_MAX_CASES)
+  {
+    BenchCase *c = &baseline[baselineCount];
+
+    if (line[0] != '#' && sscanf(line, "%31s %lf", c->name, &c->value) == 2)
+    {
+      baselineCount++;
+    }
+  }
+  fclose(file);
+}
+
+// ----------------------------------------------------------------------------------------------------
+void benchReport(const char *name, double value)
+{
+  printf("%-24s %10.2f", name, value);
+  for (unsigned int i = 0; i < baselineCount; i++)
+  {
+    if (strcmp(baseline[i].name, name) == 0)
+    {
+      printf("   # baseline %10.2f, %.2fx", baseline[i].value, value / baseline[i].value);
+      break;
+    }
+  }
+  printf("\n");
+}
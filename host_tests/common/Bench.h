@@ -0,0 +1,26 @@
+#ifndef BENCH_H_
+#define BENCH_H_
+
+// Timing for the host benchmarks. A benchmark prints one line per case,
+//
+//   name  value
+//
+// which is also the format of the baseline files committed next to it, so a
+// run's output can replace its baseline. Lines starting with # are comments.
+
+// Calls body(0...iterations-1) and returns the time per call in ns, the best
+// of BENCH_REPEATS runs so a busy machine does not count against the code.
+#define BENCH_REPEATS 7
+
+extern double benchNsPerCall(void (*body)(unsigned long i), unsigned long iterations);
+
+// Loads the baseline file, if any; later reports compare against it.
+extern void benchBaseline(const char *path);
+
+// Prints a case, with its baseline value and the ratio to it if it has one.
+extern void benchReport(const char *name, double value);
+
+// Keeps the compiler from dropping work whose result is otherwise unused.
+extern volatile unsigned long benchSink;
+
+#endif
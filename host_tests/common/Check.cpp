@@ -0,0 +1,45 @@
+#include "Check.h"
+#include <stdarg.h>
+#include <string.h>
+
+static unsigned long checks = 0;
+static unsigned long failures = 0;
+
+// ----------------------------------------------------------------------------------------------------
+bool checkResult(bool passed, const char *file, int line, const char *format, ...)
+{
+  checks++;
+  if (passed)
+  {
+    return true;
+  }
+
+  va_list args;
+
+  failures++;
+  fprintf(stderr, "%s:%d: check failed: ", file, line);
+  va_start(args, format);
+  vfprintf(stderr, format, args);
+  va_end(args);
+  fputc('\n', stderr);
+  return false;
+}
+
+// ----------------------------------------------------------------------------------------------------
+bool checkEqual(long long actual, long long expected, const char *file, int line, const char *what)
+{
+  return checkResult(actual == expected, file, line, "%s is %lld, expected %lld", what, actual, expected);
+}
+
+// ----------------------------------------------------------------------------------------------------
+bool checkString(const char *actual, const char *expected, const char *file, int line, const char *what)
+{
+  return checkResult(strcmp(actual, expected) == 0, file, line, "%s is \"%s\", expected \"%s\"", what, actual, expected);
+}
+
+// ----------------------------------------------------------------------------------------------------
+int checkReport(const char *test)
+{
+  printf("%s: %lu checks, %lu failed\n", test, checks, failures);
+  return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,27 @@
+#ifndef CHECK_H_
+#define CHECK_H_
+
+// Assertions for the host tests. A failed check prints where and why and the
+// test carries on, so one run shows every failure; checkReport() then sets
+// the exit status.
+
+#include <stdio.h>
+
+#define CHECK(cond) \
+  checkResult((cond), __FILE__, __LINE__, "%s", #cond)
+
+#define CHECK_EQ(actual, expected) \
+  checkEqual((actual), (expected), __FILE__, __LINE__, #actual)
+
+#define CHECK_STR(actual, expected) \
+  checkString((actual), (expected), __FILE__, __LINE__, #actual)
+
+// Records a check. format and what follows describe it if it failed.
+extern bool checkResult(bool passed, const char *file, int line, const char *format, ...);
+extern bool checkEqual(long long actual, long long expected, const char *file, int line, const char *what);
+extern bool checkString(const char *actual, const char *expected, const char *file, int line, const char *what);
+
+// Prints a summary for test. Returns the exit status, 1 if any check failed.
+extern int checkReport(const char *test);
+
+#endif
@@ -0,0 +1,137 @@
+#include "Hd44780Model.h"
+
+static Hd44780Model *attached = NULL;
+
+// ----------------------------------------------------------------------------------------------------
+Hd44780Model::Hd44780Model(const Hd44780Pins &pins) : pins(pins)
+{
+  reset();
+}
+
+// ----------------------------------------------------------------------------------------------------
+void Hd44780Model::attach()
+{
+  attached = this;
+  hostCycleDelay = onCycleDelay;
+  reset();
+}
+
+// ----------------------------------------------------------------------------------------------------
+void Hd44780Model::reset()
+{
+  eightBit = true;
+  pendingHigh = false;
+  inCgram = false;
+  address = 0;
+  commands = 0;
+  data = 0;
+  clears = 0;
+  memset(ddram, ' ', sizeof(ddram));
+  memset(cgram, 0, sizeof(cgram));
+}
+
+// ----------------------------------------------------------------------------------------------------
+const char *Hd44780Model::line(uint8_t row)
+{
+  memcpy(text, ddram[row & 0x01], 16);
+  text[16] = '\0';
+  return text;
+}
+
+// ----------------------------------------------------------------------------------------------------
+void Hd44780Model::onCycleDelay(unsigned int cycles)
+{
+  (void)cycles;
+  if (attached != NULL)
+  {
+    attached->latch();
+  }
+}
+
+// ----------------------------------------------------------------------------------------------------
+void Hd44780Model::latch()
+{
+  if (!(*pins.ePort & _BV(pins.eBit)))
+  {
+    return;
+  }
+
+  bool isData = *pins.rsPort & _BV(pins.rsBit);
+  uint8_t nibble = 0;
+
+  for (uint8_t i = 0; i < 4; i++)
+  {
+    if (*pins.dataPort & _BV(pins.dataBits[i]))
+    {
+      nibble |= 1 << i;
+    }
+  }
+
+  // In 8 bit mode D0-D3 are not wired, so each pulse is a whole byte with a zero low nibble
+  if (eightBit)
+  {
+    execute(nibble << 4, isData);
+    return;
+  }
+  if (!pendingHigh)
+  {
+    high = nibble;
+    pendingHigh = true;
+    return;
+  }
+  pendingHigh = false;
+  execute((high << 4) | nibble, isData);
+}
+
+// ----------------------------------------------------------------------------------------------------
+void Hd44780Model::execute(uint8_t value, bool isData)
+{
+  if (isData)
+  {
+    data++;
+    if (inCgram)
+    {
+      cgram[address & 0x3F] = value;
+      address = (address + 1) & 0x3F;
+      return;
+    }
+
+    uint8_t row = (address >= 0x40) ? 1 : 0;
+    uint8_t column = address & 0x3F;
+
+    if (column < 40)
+    {
+      ddram[row][column] = value;
+    }
+    address = (column + 1 < 40) ? address + 1 : (row ? 0x00 : 0x40);
+    return;
+  }
+
+  commands++;
+  if (value & 0x80)
+  {
+    inCgram = false;
+    address = value & 0x7F;
+  }
+  else if (value & 0x40)
+  {
+    inCgram = true;
+    address = value & 0x3F;
+  }
+  else if (value & 0x20)
+  {
+    eightBit = value & 0x10;
+  }
+  else if (value == 0x01)
+  {
+    clears++;
+    memset(ddram, ' ', sizeof(ddram));
+    inCgram = false;
+    address = 0;
+  }
+  else if ((value & 0xFE) == 0x02)
+  {
+    inCgram = false;
+    address = 0;
+  }
+}
@@ -0,0 +1,57 @@
+#ifndef HD44780MODEL_H_
+#define HD44780MODEL_H_
+
+// An HD44780 controller on the host, fed from the port registers.
+//
+// Drivers pulse E around a __builtin_avr_delay_cycles() (see Hd44780.h);
+// attach() hooks that call, and each pulse with E high latches RS and D4-D7
+// as the controller would on the falling edge. It starts in 8 bit mode like
+// the real thing, so the reset sequence has to be right for anything after
+// it to decode. DDRAM and CGRAM are kept; line() reads a row of DDRAM back.
+
+#include "Arduino.h"
+
+typedef struct Hd44780Pins {
+  volatile uint8_t *rsPort;
+  uint8_t rsBit;
+  volatile uint8_t *ePort;
+  uint8_t eBit;
+  volatile uint8_t *dataPort;   // D4-D7 on one port
+  uint8_t dataBits[4];          // bits of D4, D5, D6 and D7
+} Hd44780Pins;
+
+class Hd44780Model
+{
+  public:
+    explicit Hd44780Model(const Hd44780Pins &pins);
+
+    // Routes E pulses to this model, and powers it up.
+    void attach();
+    void reset();
+
+    // Row 0 or 1, the first 16 characters as stored; CGRAM characters stay codes 0-7.
+    const char *line(uint8_t row);
+    // One character of a CGRAM glyph, 5 bits per row.
+    uint8_t glyph(uint8_t slot, uint8_t row) const { return cgram[(slot & 0x07) * 8 + (row & 0x07)]; }
+
+    unsigned long commands;       // command bytes received
+    unsigned long data;           // data bytes received
+    unsigned long clears;
+
+  private:
+    static void onCycleDelay(unsigned int cycles);
+    void latch();
+    void execute(uint8_t value, bool isData);
+
+    Hd44780Pins pins;
+    bool eightBit;
+    bool pendingHigh;             // the high nibble of a byte is in
+    uint8_t high;
+    bool inCgram;
+    uint8_t address;
+    char ddram[2][40];
+    uint8_t cgram[64];
+    char text[17];
+};
+
+#endif
@@ -0,0 +1,37 @@
+#include "Scenario.h"
+#include "Check.h"
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// ----------------------------------------------------------------------------------------------------
+int runScenarios(const Scenario *scenarios, unsigned int count)
+{
+  int failed = 0;
+
+  for (unsigned int i = 0; i < count; i++)
+  {
+    fflush(stdout);
+
+    pid_t pid = fork();
+
+    if (pid == 0)
+    {
+      scenarios[i].run();
+      exit(checkReport(scenarios[i].name));
+    }
+
+    int status = 1;
+
+    waitpid(pid, &status, 0);
+    if (!WIFEXITED(status))
+    {
+      printf("%s: crashed\n", scenarios[i].name);
+    }
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+    {
+      failed = 1;
+    }
+  }
+  return failed;
+}
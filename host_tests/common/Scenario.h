@@ -0,0 +1,17 @@
+#ifndef SCENARIO_H_
+#define SCENARIO_H_
+
+// Runs each scenario of a test in its own process, so every one starts from
+// the program as loaded: a sketch's globals and statics are back to their
+// initial values, as after a power-up.
+
+typedef struct Scenario {
+  const char *name;
+  void (*run)();
+} Scenario;
+
+// Runs the scenarios and reports each one's checks (see Check.h). Returns
+// the exit status, 1 if any of them failed or crashed.
+extern int runScenarios(const Scenario *scenarios, unsigned int count);
+
+#endif
@@ -0,0 +1,38 @@
+#include "LiquidCrystal.h"
+#include <string.h>
+
+// ----------------------------------------------------------------------------------------------------
+LiquidCrystal::LiquidCrystal(uint8_t rs, uint8_t enable, uint8_t d4, uint8_t d5, uint8_t d6, uint8_t d7)
+{
+  (void)rs; (void)enable; (void)d4; (void)d5; (void)d6; (void)d7;
+  clear();
+}
+
+// ----------------------------------------------------------------------------------------------------
+void LiquidCrystal::clear()
+{
+  memset(text, ' ', sizeof(text));
+  col = 0;
+  row = 0;
+}
+
+// ----------------------------------------------------------------------------------------------------
+size_t LiquidCrystal::write(uint8_t c)
+{
+  if (row < 2 && col < 16)
+  {
+    text[row][col] = c;
+  }
+  col++;
+  return 1;
+}
+
+// ----------------------------------------------------------------------------------------------------
+const char *LiquidCrystal::line(byte row)
+{
+  static char shown[17];
+
+  memcpy(shown, text[row], 16);
+  shown[16] = '\0';
+  return shown;
+}
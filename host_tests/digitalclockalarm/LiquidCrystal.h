@@ -0,0 +1,29 @@
+#ifndef LIQUIDCRYSTAL_H_
+#define LIQUIDCRYSTAL_H_
+
+// The LiquidCrystal library's interface, on a model of a 16x2 display's
+// characters. Text past the end of a row is dropped, as the sketch only
+// writes within the rows.
+
+#include "Arduino.h"
+
+class LiquidCrystal : public Print
+{
+  public:
+    LiquidCrystal(uint8_t rs, uint8_t enable, uint8_t d4, uint8_t d5, uint8_t d6, uint8_t d7);
+
+    void begin(uint8_t cols, uint8_t rows) { (void)cols; (void)rows; clear(); }
+    void clear();
+    void setCursor(uint8_t col, uint8_t row) { this->col = col; this->row = row; }
+    size_t write(uint8_t c);
+    using Print::write;
+
+    // A row as it shows
+    const char *line(byte row);
+
+    char text[2][16];
+    byte col;
+    byte row;
+};
+
+#endif
@@ -0,0 +1,43 @@
+#include "RTClib.h"
+
+bool hostRtcRunning = false;
+time_t hostRtcTime = 0;
+unsigned long hostRtcMillis = 0;
+unsigned long hostRtcAdjusts = 0;
+
+// ----------------------------------------------------------------------------------------------------
+DateTime::DateTime(uint16_t year, uint8_t month, uint8_t day, uint8_t hour, uint8_t min, uint8_t sec)
+{
+  tmElements_t tm;
+
+  tm.Year = CalendarYrToTm(year);
+  tm.Month = month;
+  tm.Day = day;
+  tm.Hour = hour;
+  tm.Minute = min;
+  tm.Second = sec;
+  t = makeTime(tm);
+}
+
+// ----------------------------------------------------------------------------------------------------
+uint16_t DateTime::year() const { tmElements_t tm; breakTime(t, tm); return tmYearToCalendar(tm.Year); }
+uint8_t DateTime::month() const { tmElements_t tm; breakTime(t, tm); return tm.Month; }
+uint8_t DateTime::day() const { tmElements_t tm; breakTime(t, tm); return tm.Day; }
+uint8_t DateTime::hour() const { tmElements_t tm; breakTime(t, tm); return tm.Hour; }
+uint8_t DateTime::minute() const { tmElements_t tm; breakTime(t, tm); return tm.Minute; }
+uint8_t DateTime::second() const { tmElements_t tm; breakTime(t, tm); return tm.Second; }
+
+// ----------------------------------------------------------------------------------------------------
+void RTC_DS1307::adjust(const DateTime &dt)
+{
+  hostRtcRunning = true;
+  hostRtcTime = dt.unixtime();
+  hostRtcMillis = millis();
+  hostRtcAdjusts++;
+}
+
+// ----------------------------------------------------------------------------------------------------
+DateTime RTC_DS1307::now()
+{
+  return DateTime(hostRtcTime + (millis() - hostRtcMillis) / 1000);
+}
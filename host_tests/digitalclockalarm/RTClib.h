@@ -0,0 +1,43 @@
+#ifndef RTCLIB_H_
+#define RTCLIB_H_
+
+// RTClib's DateTime and DS1307, the chip counting on from the last adjust()
+// with millis().
+
+#include "Arduino.h"
+#include "TimeLib.h"
+
+class DateTime
+{
+  public:
+    DateTime(time_t t = 0) : t(t) {}
+    DateTime(uint16_t year, uint8_t month, uint8_t day, uint8_t hour = 0, uint8_t min = 0, uint8_t sec = 0);
+
+    uint16_t year() const;
+    uint8_t month() const;
+    uint8_t day() const;
+    uint8_t hour() const;
+    uint8_t minute() const;
+    uint8_t second() const;
+    time_t unixtime() const { return t; }
+
+  private:
+    time_t t;
+};
+
+// Whether the chip keeps time, what it was last set to and when
+extern bool hostRtcRunning;
+extern time_t hostRtcTime;
+extern unsigned long hostRtcMillis;
+extern unsigned long hostRtcAdjusts;
+
+class RTC_DS1307
+{
+  public:
+    bool begin() { return true; }
+    uint8_t isrunning() { return hostRtcRunning; }
+    void adjust(const DateTime &dt);
+    DateTime now();
+};
+
+#endif
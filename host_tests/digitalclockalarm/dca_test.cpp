@@ -0,0 +1,165 @@
+// The DigitalClockAlarm sketch against a LiquidCrystal text model and a DS1307
+// that counts on from millis(): its messages and button lockouts are timed
+// states, so every loop() returns without the virtual clock moving.
+
+#include "LiquidCrystal.h"
+#include "RTClib.h"
+#include "EEPROM.h"
+#include "Check.h"
+#include "Scenario.h"
+
+// The sketch's
+extern LiquidCrystal lcd;
+extern int btnCount, H, M, AH, AM;
+extern boolean setupScreen, alarmON;
+
+// Its buttons, whose consts are local to it
+static const int btSet = A0;
+static const int btAdj = A1;
+static const int btAlarm = A2;
+
+static unsigned long longestLoop = 0;       // virtual ms a single loop() took
+
+// ----------------------------------------------------------------------------------------------------
+// Powers the clock up with its RTC at the time given and the alarm at 07:15.
+static void boot(const DateTime &now)
+{
+  hostReset();
+  hostRtcRunning = true;
+  hostRtcTime = now.unixtime();
+  hostRtcMillis = 0;
+  hostRtcAdjusts = 0;
+  EEPROM.data[0] = 7;
+  EEPROM.data[1] = 15;
+  EEPROM.writes = 0;
+  setup();
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Loops every millisecond for ms.
+static void run(unsigned long ms)
+{
+  for (unsigned long end = millis() + ms; millis() < end; )
+  {
+    unsigned long start = millis();
+
+    loop();
+    if (millis() - start > longestLoop)
+    {
+      longestLoop = millis() - start;
+    }
+    hostAdvance(1000);
+  }
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Holds a button down for hold ms, then lets it go for settle.
+static void press(int pin, unsigned long hold = 100, unsigned long settle = 600)
+{
+  hostPins[pin].input = LOW;
+  run(hold);
+  hostPins[pin].input = HIGH;
+  run(settle);
+}
+
+// ----------------------------------------------------------------------------------------------------
+static void clockFace()
+{
+  boot(DateTime(2024, 3, 9, 17, 30, 0));
+  run(1000);
+  CHECK_STR(lcd.line(0), "17:30:01 | 07:15");
+  CHECK_STR(lcd.line(1), "09/03/24 |      ");
+  run(59000);
+  CHECK_STR(lcd.line(0), "17:31:00 | 07:15");
+  CHECK_EQ(longestLoop, 0);
+}
+
+// ----------------------------------------------------------------------------------------------------
+// ALARM toggles once per press, and again every 500 ms while held.
+static void alarmButton()
+{
+  boot(DateTime(2024, 3, 9, 17, 30, 0));
+  run(10);
+  press(btAlarm);
+  CHECK(alarmON);
+  CHECK_STR(lcd.line(1), "09/03/24 | ALARM");
+  press(btAlarm);
+  CHECK(!alarmON);
+
+  press(btAlarm, 1200);                     // at 0, 500 and 1000 ms
+  CHECK(alarmON);
+  CHECK_STR(lcd.line(1), "09/03/24 | ALARM");
+
+  // The seconds kept counting while the button was down
+  CHECK_EQ(lcd.line(0)[7], '3');
+  CHECK_EQ(longestLoop, 0);
+}
+
+// ----------------------------------------------------------------------------------------------------
+// The SET banner stays up for 2 s, and nothing acts on a button meanwhile.
+static void setBanner()
+{
+  boot(DateTime(2024, 3, 9, 17, 30, 0));
+  run(10);
+  press(btSet);
+  CHECK_EQ(btnCount, 1);
+  CHECK_STR(lcd.line(0), "------SET------ ");
+  CHECK_STR(lcd.line(1), "-TIME and DATE- ");
+
+  press(btSet, 100, 200);
+  press(btAdj, 100, 200);
+  CHECK_EQ(btnCount, 1);
+  CHECK_EQ(H, 17);
+  CHECK_STR(lcd.line(0), "------SET------ ");
+
+  run(800);                                 // 2 s after the press
+  CHECK_STR(lcd.line(0), "    >17 : 30    ");
+  CHECK_STR(lcd.line(1), " 09 / 03 / 24   ");
+  press(btAdj);
+  CHECK_EQ(H, 18);
+  CHECK_EQ(longestLoop, 0);
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Holding SET walks the fields at 500 ms a step; "Saving...." then stays for 2 s.
+static void saving()
+{
+  boot(DateTime(2024, 3, 9, 17, 30, 0));
+  run(10);
+  press(btSet);
+  run(2000);
+  press(btAdj);                             // hour 18
+  press(btSet, 2200);                       // minutes, day, month, year, alarm hour
+  CHECK_EQ(btnCount, 6);
+  CHECK_STR(lcd.line(0), "SET  ALARM TIME ");
+  press(btAdj);                             // alarm hour 8
+  press(btSet);
+  CHECK_EQ(btnCount, 7);
+
+  press(btSet);
+  CHECK_STR(lcd.line(0), "Saving....      ");
+  CHECK_EQ(hostRtcAdjusts, 1);
+  CHECK_EQ(DateTime(hostRtcTime).hour(), 18);
+  CHECK_EQ(EEPROM.data[0], 8);
+  CHECK_EQ(EEPROM.data[1], 15);
+  CHECK(setupScreen);
+
+  run(1400);                                // 2 s after the press
+  CHECK(!setupScreen);
+  CHECK_EQ(btnCount, 0);
+  CHECK_STR(lcd.line(0), "18:30:02 | 08:15");
+  CHECK_EQ(longestLoop, 0);
+}
+
+// ----------------------------------------------------------------------------------------------------
+int main()
+{
+  static const Scenario scenarios[] = {
+    { "clock face", clockFace },
+    { "alarm button", alarmButton },
+    { "SET banner", setBanner },
+    { "saving", saving },
+  };
+
+  return runScenarios(scenarios, sizeof(scenarios) / sizeof(scenarios[0]));
+}
@@ -0,0 +1,180 @@
+#include "Ds1302Model.h"
+#include <string.h>
+
+#define CMD_CLOCK_BURST     0xBE    // without the read bit
+#define CMD_RAM_BURST       0xFE
+#define CMD_READ            0x01
+#define CMD_RAM             0x40
+#define REG_WRITE_PROTECT   7
+#define WRITE_PROTECT       0x80
+
+Ds1302Model ds1302;
+Ds1302Line ds1302Port(true);
+Ds1302Line ds1302Ddr(false);
+Ds1302Input ds1302Pin;
+
+// The transfer in progress
+static bool selected = false;
+static byte bitCount = 0;           // bits shifted since CE went high
+static byte command = 0;
+static byte shift = 0;              // byte being shifted in or out
+static bool driving = false;        // the chip drives IO
+static bool output = false;         // and this level
+static byte burst[8];               // a clock burst write is only taken whole
+
+// ----------------------------------------------------------------------------------------------------
+void ds1302Reset()
+{
+  memset(&ds1302, 0, sizeof(ds1302));
+  ds1302.clock[0] = 0x80;           // clock halt
+  ds1302.clock[3] = 0x01;
+  ds1302.clock[4] = 0x01;
+  ds1302.clock[5] = 0x01;
+  ds1302.clock[REG_WRITE_PROTECT] = WRITE_PROTECT;
+  ds1302Port = 0;
+  ds1302Ddr = 0;
+  selected = false;
+  driving = false;
+}
+
+// ----------------------------------------------------------------------------------------------------
+// The register a byte of the transfer goes to or comes from.
+static byte *reg(byte index)
+{
+  bool ram = command & CMD_RAM;
+  byte address = ((command >> 1) & 0x1F) + index;
+
+  if ((command | CMD_READ) == (CMD_CLOCK_BURST | CMD_READ))
+  {
+    return &ds1302.clock[index % 8];
+  }
+  if ((command | CMD_READ) == (CMD_RAM_BURST | CMD_READ))
+  {
+    return &ds1302.ram[index % 31];
+  }
+  if (index > 0)
+  {
+    return NULL;                    // single register commands move one byte
+  }
+  if (ram)
+  {
+    return (address < 31) ? &ds1302.ram[address] : NULL;
+  }
+  return (address < 8) ? &ds1302.clock[address] : NULL;
+}
+
+// ----------------------------------------------------------------------------------------------------
+static void received(byte index, byte value)
+{
+  bool writable = !(ds1302.clock[REG_WRITE_PROTECT] & WRITE_PROTECT);
+
+  if ((command | CMD_READ) == (CMD_CLOCK_BURST | CMD_READ))
+  {
+    burst[index % 8] = value;
+    if (index == 7 && writable)
+    {
+      memcpy(ds1302.clock, burst, sizeof(burst));
+    }
+    return;
+  }
+
+  byte *target = reg(index);
+
+  if (target == &ds1302.clock[REG_WRITE_PROTECT])
+  {
+    *target = value & WRITE_PROTECT;
+  }
+  else if (target != NULL && writable)
+  {
+    *target = value;
+  }
+}
+
+// ----------------------------------------------------------------------------------------------------
+static void risingEdge(bool io)
+{
+  byte bit = bitCount % 8;
+
+  if (bitCount < 8 || !(command & CMD_READ))
+  {
+    shift = (shift >> 1) | (io ? 0x80 : 0);
+    if (bit == 7 && bitCount < 8)
+    {
+      command = shift;
+      ds1302.commands++;
+      ds1302.lastCommand = command;
+    }
+    else if (bit == 7)
+    {
+      received(bitCount / 8 - 1, shift);
+    }
+  }
+  bitCount++;
+}
+
+// ----------------------------------------------------------------------------------------------------
+// After the command of a read, each falling edge puts the next bit on IO.
+static void fallingEdge()
+{
+  if (bitCount < 8 || !(command & CMD_READ))
+  {
+    return;
+  }
+
+  byte index = (bitCount - 8) / 8;
+  byte bit = (bitCount - 8) % 8;
+  byte *source = reg(index);
+
+  driving = true;
+  output = (source != NULL) && ((*source >> bit) & 1);
+}
+
+// ----------------------------------------------------------------------------------------------------
+Ds1302Line &Ds1302Line::set(uint8_t bits)
+{
+  uint8_t before = value;
+
+  value = bits;
+  if (port)
+  {
+    bool ce = value & DS1302_CE;
+
+    if (ce && !(before & DS1302_CE))
+    {
+      selected = true;
+      bitCount = 0;
+      shift = 0;
+      driving = false;
+    }
+    else if (!ce)
+    {
+      selected = false;
+      driving = false;
+    }
+    if (selected && (value & DS1302_SCLK) && !(before & DS1302_SCLK))
+    {
+      bool io = (ds1302Ddr & DS1302_IO) && (value & DS1302_IO);
+
+      risingEdge(io);
+    }
+    if (selected && !(value & DS1302_SCLK) && (before & DS1302_SCLK))
+    {
+      fallingEdge();
+    }
+  }
+  if (driving && (ds1302Ddr & DS1302_IO))
+  {
+    ds1302.contention++;
+  }
+  return *this;
+}
+
+// ----------------------------------------------------------------------------------------------------
+Ds1302Input::operator uint8_t() const
+{
+  if (ds1302Ddr & DS1302_IO)
+  {
+    return ds1302Port & DS1302_IO;
+  }
+  return (driving && output) ? DS1302_IO : 0;
+}
@@ -0,0 +1,64 @@
+#ifndef DS1302MODEL_H_
+#define DS1302MODEL_H_
+
+// A DS1302 on three port lines, modelled from the edges the driver makes.
+//
+// The chip shifts a command byte in on rising SCLK edges, LSB first. For a
+// write the data bytes follow the same way. For a read it drives IO itself
+// from the falling edge after the command's last bit until CE goes low.
+// Should the MCU still drive IO as an output then, the two fight over the
+// line; the model counts that as contention.
+//
+// Include this before FastDS1302.h: it points the driver's port macros at
+// the model's lines.
+
+#include "Arduino.h"
+
+class Ds1302Line
+{
+  public:
+    explicit Ds1302Line(bool port) : value(0), port(port) {}
+
+    operator uint8_t() const { return value; }
+    Ds1302Line &operator|=(uint8_t bits) { return set(value | bits); }
+    Ds1302Line &operator&=(uint8_t bits) { return set(value & bits); }
+    Ds1302Line &operator=(uint8_t bits) { return set(bits); }
+
+  private:
+    Ds1302Line &set(uint8_t bits);
+
+    uint8_t value;
+    bool port;        // PORT, whose edges clock the chip, or DDR
+};
+
+class Ds1302Input
+{
+  public:
+    operator uint8_t() const;     // IO as the MCU reads it
+};
+
+// The model's state, reset by ds1302Reset()
+typedef struct Ds1302Model {
+  byte clock[8];          // seconds ... year, then the write protect register
+  byte ram[31];
+  unsigned long contention;
+  unsigned long commands;
+  byte lastCommand;
+} Ds1302Model;
+
+extern Ds1302Model ds1302;
+extern Ds1302Line ds1302Port;
+extern Ds1302Line ds1302Ddr;
+extern Ds1302Input ds1302Pin;
+
+// Powers the chip up as from a dead battery: halted and write protected.
+extern void ds1302Reset();
+
+#define DS1302_PORT     ds1302Port
+#define DS1302_DDR      ds1302Ddr
+#define DS1302_PIN      ds1302Pin
+#define DS1302_CE       _BV(2)
+#define DS1302_IO       _BV(4)
+#define DS1302_SCLK     _BV(5)
+
+#endif
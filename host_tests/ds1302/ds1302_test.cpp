@@ -0,0 +1,136 @@
+// FastDS1302 against a model of the DS1302's shift register (Ds1302Model.h):
+// bit order, burst transfers, write protection, 12 hour mode, and that the
+// driver never drives IO while the chip does.
+
+#include "Ds1302Model.h"
+#include "FastDS1302.h"
+#include "Check.h"
+#include "Scenario.h"
+
+#define CMD_WRITE_PROTECT   0x8E
+#define CMD_CLOCK_BURST_W   0xBE
+#define CMD_CLOCK_BURST_R   0xBF
+
+// ----------------------------------------------------------------------------------------------------
+static time_t at(int year, byte month, byte day, byte hour, byte minute, byte second)
+{
+  tmElements_t tm;
+
+  tm.Year = CalendarYrToTm(year);
+  tm.Month = month;
+  tm.Day = day;
+  tm.Hour = hour;
+  tm.Minute = minute;
+  tm.Second = second;
+  return makeTime(tm);
+}
+
+// ----------------------------------------------------------------------------------------------------
+// A dead battery leaves the clock halted and write protected; set() starts it.
+static void setAndGet()
+{
+  time_t t = at(2024, 2, 29, 23, 59, 58);
+
+  ds1302Reset();
+  CHECK_EQ(FastDS1302::get(), 0);
+  CHECK_EQ(ds1302.lastCommand, CMD_CLOCK_BURST_R);
+
+  CHECK_EQ(FastDS1302::set(t), 0);
+  CHECK_EQ(ds1302.clock[0], 0x58);
+  CHECK_EQ(ds1302.clock[1], 0x59);
+  CHECK_EQ(ds1302.clock[2], 0x23);
+  CHECK_EQ(ds1302.clock[3], 0x29);
+  CHECK_EQ(ds1302.clock[4], 0x02);
+  CHECK_EQ(ds1302.clock[5], weekday(t));
+  CHECK_EQ(ds1302.clock[6], 0x24);
+  CHECK_EQ(ds1302.clock[7], 0x00);
+  CHECK_EQ(FastDS1302::get(), t);
+
+  // Write protect off, the burst write, and the read back
+  CHECK_EQ(ds1302.commands, 1 + 3 + 1);
+  CHECK_EQ(ds1302.contention, 0);
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Every read hands IO to the chip before the falling edge that makes it drive.
+static void noContention()
+{
+  ds1302Reset();
+  FastDS1302::set(at(2030, 6, 15, 12, 0, 0));
+  for (int i = 0; i < 100; i++)
+  {
+    ds1302.clock[0] = (i / 10) << 4 | (i % 10);
+    ds1302.clock[0] %= 0x60;
+    CHECK(FastDS1302::get() != 0);
+  }
+  CHECK_EQ(ds1302.contention, 0);
+
+  // Released between transfers: IO an input without pull-up, CE low
+  CHECK_EQ(ds1302Ddr & DS1302_IO, 0);
+  CHECK_EQ(ds1302Port & (DS1302_IO | DS1302_CE), 0);
+}
+
+// ----------------------------------------------------------------------------------------------------
+static void twelveHourMode()
+{
+  static const struct { byte reg; byte hour; } hours[] = {
+    { 0x80 | 0x12, 0 },             // 12 AM
+    { 0x80 | 0x01, 1 },
+    { 0x80 | 0x11, 11 },
+    { 0x80 | 0x20 | 0x12, 12 },     // 12 PM
+    { 0x80 | 0x20 | 0x01, 13 },
+    { 0x80 | 0x20 | 0x11, 23 },
+    { 0x23, 23 },                   // 24 hour mode
+  };
+  tmElements_t tm;
+
+  ds1302Reset();
+  FastDS1302::set(at(2024, 1, 1, 0, 0, 0));
+  for (byte i = 0; i < sizeof(hours) / sizeof(hours[0]); i++)
+  {
+    ds1302.clock[2] = hours[i].reg;
+    CHECK_EQ(FastDS1302::read(tm), 0);
+    CHECK_EQ(tm.Hour, hours[i].hour);
+  }
+}
+
+// ----------------------------------------------------------------------------------------------------
+// A day at a time through the century the clock counts, at a changing time of day
+static void everyDay()
+{
+  ds1302Reset();
+  for (time_t t = at(2000, 1, 1, 0, 0, 0); t < at(2100, 1, 1, 0, 0, 0); t += SECS_PER_DAY + 3671)
+  {
+    if (!checkResult(FastDS1302::set(t) == 0 && FastDS1302::get() == t, __FILE__, __LINE__,
+                     "round trip of %ld", (long)t))
+    {
+      break;
+    }
+  }
+  CHECK_EQ(ds1302.contention, 0);
+}
+
+// ----------------------------------------------------------------------------------------------------
+// With write protection back on, set() still gets through: it clears it first.
+static void writeProtected()
+{
+  ds1302Reset();
+  FastDS1302::set(at(2024, 1, 1, 0, 0, 0));
+  ds1302.clock[7] = 0x80;
+  CHECK_EQ(FastDS1302::set(at(2025, 7, 4, 18, 30, 0)), 0);
+  CHECK_EQ(FastDS1302::get(), at(2025, 7, 4, 18, 30, 0));
+}
+
+// ----------------------------------------------------------------------------------------------------
+int main()
+{
+  static const Scenario scenarios[] = {
+    { "set/get", setAndGet },
+    { "IO hand-over", noContention },
+    { "12 hour mode", twelveHourMode },
+    { "every day 2000-2099", everyDay },
+    { "write protected", writeProtected },
+  };
+
+  return runScenarios(scenarios, sizeof(scenarios) / sizeof(scenarios[0]));
+}
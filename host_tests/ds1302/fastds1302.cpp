@@ -0,0 +1,3 @@
+// FastDS1302 built against the DS1302 model's port lines
+#include "Ds1302Model.h"
+#include "FastDS1302.cpp"
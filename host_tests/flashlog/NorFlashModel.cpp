@@ -0,0 +1,152 @@
+#include "NorFlashModel.h"
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// ----------------------------------------------------------------------------------------------------
+NorFlashModel::NorFlashModel(const char *path, uint32_t capacity) :
+  reads(0), programs(0), errors(0), programWaits(0), programWaitUs(0), eraseWaits(0), eraseWaitUs(0),
+  size(capacity), readyAt(0), erasing(-1), running(false)
+{
+  struct stat status;
+  int file = open(path, O_RDWR | O_CREAT, 0644);
+  bool blank = fstat(file, &status) != 0 || status.st_size != (off_t)size;
+
+  if (blank && ftruncate(file, size) != 0)
+  {
+    perror(path);
+    exit(2);
+  }
+  image = (uint8_t *)mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+  close(file);
+  if (image == MAP_FAILED)
+  {
+    perror(path);
+    exit(2);
+  }
+  if (blank)
+  {
+    memset(image, 0xFF, size);
+  }
+  erases = new unsigned long[size / NOR_SECTOR_SIZE]();
+}
+
+// ----------------------------------------------------------------------------------------------------
+NorFlashModel::~NorFlashModel()
+{
+  if (image != NULL)
+  {
+    wait();
+    munmap(image, size);
+  }
+  delete[] erases;
+}
+
+// ----------------------------------------------------------------------------------------------------
+uint32_t NorFlashModel::capacity()
+{
+  wait();
+  return size;
+}
+
+// ----------------------------------------------------------------------------------------------------
+void NorFlashModel::read(uint32_t address, void *data, unsigned int length)
+{
+  wait();
+  for (unsigned int i = 0; i < length; i++)
+  {
+    ((uint8_t *)data)[i] = image[(address + i) % size];
+  }
+  reads++;
+}
+
+// ----------------------------------------------------------------------------------------------------
+// The chip wraps within the page, and can only clear bits.
+void NorFlashModel::program(uint32_t address, const void *data, unsigned int length)
+{
+  uint32_t page = address - address % NOR_PAGE_SIZE;
+  bool error = address % NOR_PAGE_SIZE + length > NOR_PAGE_SIZE;
+
+  wait();
+  for (unsigned int i = 0; i < length; i++)
+  {
+    uint32_t at = page + (address + i) % NOR_PAGE_SIZE;
+    uint8_t value = ((const uint8_t *)data)[i];
+
+    error = error || (value & ~image[at]) != 0;
+    image[at] &= value;
+  }
+  errors += error;
+  programs++;
+  running = true;
+  erasing = -1;
+  readyAt = micros() + NOR_PROGRAM_US;
+}
+
+// ----------------------------------------------------------------------------------------------------
+void NorFlashModel::eraseSector(uint32_t address)
+{
+  wait();
+  erasing = address / NOR_SECTOR_SIZE;
+  running = true;
+  readyAt = micros() + NOR_ERASE_US;
+}
+
+// ----------------------------------------------------------------------------------------------------
+bool NorFlashModel::busy()
+{
+  if (running && (long)(micros() - readyAt) >= 0)
+  {
+    finish();
+  }
+  return running;
+}
+
+// ----------------------------------------------------------------------------------------------------
+bool NorFlashModel::powerCut()
+{
+  bool erase = busy() && erasing >= 0;
+
+  running = false;
+  munmap(image, size);
+  image = NULL;
+  return erase;
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Holds the caller until the running operation is done.
+void NorFlashModel::wait()
+{
+  if (!busy())
+  {
+    return;
+  }
+
+  unsigned long us = readyAt - micros();
+
+  if (erasing >= 0)
+  {
+    eraseWaits++;
+    eraseWaitUs += us;
+  }
+  else
+  {
+    programWaits++;
+    programWaitUs += us;
+  }
+  hostAdvance(us);
+  finish();
+}
+
+// ----------------------------------------------------------------------------------------------------
+void NorFlashModel::finish()
+{
+  if (erasing >= 0)
+  {
+    memset(image + erasing * NOR_SECTOR_SIZE, 0xFF, NOR_SECTOR_SIZE);
+    erases[erasing]++;
+  }
+  running = false;
+}
@@ -0,0 +1,62 @@
+#ifndef NORFLASHMODEL_H_
+#define NORFLASHMODEL_H_
+
+// A NOR flash chip for the NorFlash interface, kept in a file mapped into
+// memory, so a test can power it off and on again with the contents intact.
+//
+// It holds to the chip's rules rather than trusting the caller: programming
+// only clears bits and wraps within its page, as the chip does, and each
+// time a caller asks for a 0 to become a 1 or crosses a page it counts an
+// error. Programs and erases take the W25Q32's typical times on the virtual
+// clock. A call that comes while one is running waits for it by moving the
+// clock on, as SpiNorFlash polls the status register. The waits are counted,
+// so a test can tell how long the caller was held up and by what.
+//
+// An erase only takes effect once its time is up. Cutting the power before
+// then leaves the sector as it was.
+
+#include "Arduino.h"
+#include "NorFlash.h"
+
+#define NOR_PROGRAM_US    700UL     // a page program, typical
+#define NOR_ERASE_US      45000UL   // a 4 KB sector erase, typical
+
+class NorFlashModel : public NorFlash
+{
+  public:
+    // Opens the chip image at path, or makes a blank one of capacity bytes.
+    NorFlashModel(const char *path, uint32_t capacity);
+    ~NorFlashModel();
+
+    uint32_t capacity();
+    void read(uint32_t address, void *data, unsigned int length);
+    void program(uint32_t address, const void *data, unsigned int length);
+    void eraseSector(uint32_t address);
+    bool busy();
+
+    // Power off in the middle of whatever is running; true if that was an
+    // erase. The object is then closed, and a new one on the same path is the
+    // chip powered up again.
+    bool powerCut();
+
+    unsigned long reads;
+    unsigned long programs;
+    unsigned long errors;           // programs that set bits or crossed a page
+    unsigned long programWaits;     // calls held up by a program, and for how long
+    unsigned long programWaitUs;
+    unsigned long eraseWaits;       // calls held up by an erase
+    unsigned long eraseWaitUs;
+    unsigned long *erases;          // per sector
+
+  private:
+    void wait();
+    void finish();
+
+    uint8_t *image;                 // the file, mapped
+    uint32_t size;
+    unsigned long readyAt;          // micros() the running operation ends at
+    long erasing;                   // the sector being erased, or -1 for a program
+    bool running;
+};
+
+#endif
@@ -0,0 +1,334 @@
+// FlashLog on a file-backed NOR flash model (NorFlashModel.h): every record
+// read back by day range, the ring wrapping over its oldest sectors, power
+// cuts, seek's cost on a 4 MB chip, and that the flash rules hold throughout.
+
+#include "NorFlashModel.h"
+#include "FlashLog.h"
+#include "Check.h"
+#include "Scenario.h"
+#include <unistd.h>
+#include <vector>
+
+typedef struct Record {
+  uint16_t day;
+  byte length;
+  byte seed;
+} Record;
+
+static char imagePath[64];
+static std::vector<Record> written;
+
+// ----------------------------------------------------------------------------------------------------
+// A chip image of its own for the scenario, removed at the end.
+static const char *image()
+{
+  snprintf(imagePath, sizeof(imagePath), "/tmp/flashlog_test.%d.img", (int)getpid());
+  unlink(imagePath);
+  return imagePath;
+}
+
+// ----------------------------------------------------------------------------------------------------
+static void fill(byte *data, const Record &r)
+{
+  for (byte i = 0; i < r.length; i++)
+  {
+    data[i] = r.seed + i * 31;
+  }
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Appends n records of day, lengths from short to FLASH_LOG_MAX_RECORD.
+static void append(FlashLog &log, uint16_t day, unsigned int n)
+{
+  for (unsigned int k = 0; k < n; k++)
+  {
+    Record r;
+    byte data[FLASH_LOG_MAX_RECORD];
+
+    r.day = day;
+    r.length = 1 + (day * 37u + k * 101u + written.size()) % ((k % 5 == 4) ? FLASH_LOG_MAX_RECORD : 24);
+    r.seed = day * 7 + k;
+    fill(data, r);
+    CHECK(log.append(day, data, r.length));
+    written.push_back(r);
+  }
+}
+
+// ----------------------------------------------------------------------------------------------------
+static unsigned int countRecords(FlashLog &log)
+{
+  FlashLogCursor cursor;
+  byte data[1];
+  uint16_t day;
+  unsigned int count = 0;
+
+  log.seek(&cursor, 0, 0xFFFE);
+  while (log.next(&cursor, data, sizeof(data), &day) != 0)
+  {
+    count++;
+  }
+  return count;
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Reads days first to last and compares them with written[w] on. Returns the
+// number of records read.
+static unsigned int readRange(FlashLog &log, uint16_t first, uint16_t last, size_t w)
+{
+  FlashLogCursor cursor;
+  unsigned int count = 0;
+  unsigned int mismatches = 0;
+
+  log.seek(&cursor, first, last);
+  for (;;)
+  {
+    byte data[FLASH_LOG_MAX_RECORD];
+    byte expected[FLASH_LOG_MAX_RECORD];
+    uint16_t day;
+    byte length = log.next(&cursor, data, sizeof(data), &day);
+
+    if (length == 0)
+    {
+      break;
+    }
+    if (w == written.size() || written[w].day != day || written[w].length != length)
+    {
+      mismatches++;
+      break;
+    }
+    fill(expected, written[w]);
+    mismatches += memcmp(data, expected, length) != 0;
+    w++;
+    count++;
+  }
+  CHECK_EQ(mismatches, 0);
+  CHECK(w == written.size() || written[w].day > last);
+  return count;
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Reads days first to last and compares them with what was written. The log
+// holds the newest of the records written, and its oldest sector may start
+// part way into a day, so the records of the days before first are counted
+// from the end. Returns the number of records read.
+static unsigned int expectRange(FlashLog &log, uint16_t first, uint16_t last)
+{
+  size_t w = 0;
+
+  if (first <= log.firstDay())
+  {
+    w = written.size() - countRecords(log);
+  }
+  else
+  {
+    while (w < written.size() && written[w].day < first)
+    {
+      w++;
+    }
+  }
+  return readRange(log, first, last, w);
+}
+
+// ----------------------------------------------------------------------------------------------------
+static void roundTrip()
+{
+  NorFlashModel flash(image(), 64 * 1024UL);
+  FlashLog log(flash);
+
+  CHECK(log.begin());
+  CHECK(log.empty());
+
+  for (uint16_t day = 100; day < 300; day++)
+  {
+    append(log, day, day % 4);              // some days have none
+    hostAdvance(1000000);
+  }
+  CHECK(!log.empty());
+  CHECK_EQ(log.firstDay(), 101);
+  CHECK_EQ(log.lastDay(), 299);
+  CHECK_EQ(expectRange(log, 0, 0xFFFE), written.size());
+  for (uint16_t first = 95; first < 305; first += 7)
+  {
+    expectRange(log, first, first + first % 11);
+  }
+
+  // Out of order, empty and oversized records are refused
+  byte data[FLASH_LOG_MAX_RECORD + 1] = { 0 };
+
+  CHECK(!log.append(298, data, 1));
+  CHECK(!log.append(299, data, 0));
+  CHECK(!log.append(299, data, FLASH_LOG_MAX_RECORD + 1));
+  CHECK_EQ(flash.errors, 0);
+  unlink(imagePath);
+}
+
+// ----------------------------------------------------------------------------------------------------
+// On a 4 sector chip the oldest sector goes a whole one at a time, and the
+// sectors wear evenly.
+static void wrapAround()
+{
+  NorFlashModel flash(image(), 4 * NOR_SECTOR_SIZE);
+  FlashLog log(flash);
+  uint16_t previousFirst = 0;
+  unsigned int drops = 0;
+
+  CHECK(log.begin());
+  for (uint16_t day = 1; day <= 2000; day++)
+  {
+    append(log, day, 3);
+    hostAdvance(1000000);
+    if (log.firstDay() != previousFirst)
+    {
+      drops++;
+      previousFirst = log.firstDay();
+    }
+  }
+  CHECK_EQ(log.lastDay(), 2000);
+  CHECK(log.firstDay() > 1500);
+  CHECK(drops > 8);
+  expectRange(log, 0, 0xFFFE);
+  expectRange(log, log.firstDay() + 5, log.firstDay() + 9);
+
+  for (unsigned int s = 1; s < 4; s++)
+  {
+    CHECK(flash.erases[s] + 1 >= flash.erases[0] && flash.erases[s] <= flash.erases[0] + 1);
+  }
+  CHECK_EQ(flash.errors, 0);
+  unlink(imagePath);
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Records come every 10 minutes, so an append never waits for an erase; each
+// waits at most for the program before it.
+static void noEraseWaits()
+{
+  NorFlashModel flash(image(), 4 * NOR_SECTOR_SIZE);
+  FlashLog log(flash);
+
+  CHECK(log.begin());
+  hostAdvance(NOR_ERASE_US);                // begin() erases sector 0
+  for (uint16_t day = 1; day <= 300; day++)
+  {
+    for (unsigned int k = 0; k < 6; k++)
+    {
+      append(log, day, 1);
+      hostAdvance(600000000UL);
+    }
+  }
+  CHECK(flash.erases[0] > 1);
+  CHECK_EQ(flash.eraseWaits, 0);
+  CHECK(flash.programWaitUs <= flash.programs * NOR_PROGRAM_US);
+
+  // Back to back, the append after the one that opens a sector waits for its erase
+  while (flash.eraseWaits == 0)
+  {
+    append(log, 301, 1);
+  }
+  CHECK(flash.eraseWaitUs <= NOR_ERASE_US);
+  CHECK_EQ(flash.errors, 0);
+  unlink(imagePath);
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Powers the chip up, appends records from the day after the last on and
+// cuts the power: after count of them, or if duringErase right after the
+// append that opens a sector and starts erasing the next. Returns true if the
+// cut stopped an erase.
+static bool poweredRun(unsigned int count, bool duringErase)
+{
+  uint16_t day = written.empty() ? 10 : written.back().day + 1;
+
+  NorFlashModel flash(imagePath, 4 * NOR_SECTOR_SIZE);
+  FlashLog log(flash);
+
+  CHECK(log.begin());
+  if (!written.empty())
+  {
+    CHECK_EQ(log.lastDay(), written.back().day);
+    expectRange(log, 0, 0xFFFE);
+  }
+  for (unsigned int k = 0; duringErase || k < count; k++)
+  {
+    append(log, day + k / 6, 1);
+    hostAdvance(1000);
+    if (duringErase && flash.busy())
+    {
+      break;
+    }
+  }
+  CHECK_EQ(flash.errors, 0);
+  return flash.powerCut();
+}
+
+// ----------------------------------------------------------------------------------------------------
+// After a power cut begin() finds the end again and appending carries on,
+// also when the cut came during the erase a new sector starts.
+static void powerCuts()
+{
+  unsigned int erasesCut = 0;
+
+  image();
+  for (unsigned int round = 0; round < 80; round++)
+  {
+    erasesCut += poweredRun(15 + round * 7 % 23, round % 2);
+  }
+  CHECK_EQ(erasesCut, 40);
+
+  NorFlashModel flash(imagePath, 4 * NOR_SECTOR_SIZE);
+  FlashLog log(flash);
+
+  CHECK(log.begin());
+  CHECK(log.firstDay() > 100);
+  CHECK_EQ(log.lastDay(), written.back().day);
+  expectRange(log, 0, 0xFFFE);
+  unlink(imagePath);
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Finding a day on a full 4 MB chip reads 10 sector headers and 4 page
+// headers, then walks the one page it lands in, which holds under 20 of
+// these records.
+static void seekCost()
+{
+  NorFlashModel flash(image(), 4UL * 1024 * 1024);
+  FlashLog log(flash);
+
+  CHECK(log.begin());
+  for (uint16_t day = 1; day <= 30000; day++)
+  {
+    append(log, day, 5);
+  }
+  CHECK(log.firstDay() > 1);
+  CHECK_EQ(flash.errors, 0);
+
+  unsigned long most = 0;
+
+  for (uint16_t first = log.firstDay(); first <= 30000; first += 997)
+  {
+    FlashLogCursor cursor;
+    unsigned long reads = flash.reads;
+
+    log.seek(&cursor, first, first);
+    if (flash.reads - reads > most)
+    {
+      most = flash.reads - reads;
+    }
+  }
+  CHECK(most <= 14 + 20);
+  expectRange(log, 12345, 12399);
+  unlink(imagePath);
+}
+
+// ----------------------------------------------------------------------------------------------------
+int main()
+{
+  static const Scenario scenarios[] = {
+    { "round trip", roundTrip },
+    { "wrap around", wrapAround },
+    { "no erase waits", noEraseWaits },
+    { "power cuts", powerCuts },
+    { "seek cost", seekCost },
+  };
+
+  return runScenarios(scenarios, sizeof(scenarios) / sizeof(scenarios[0]));
+}
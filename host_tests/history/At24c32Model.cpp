@@ -0,0 +1,98 @@
+#include "At24c32Model.h"
+
+// ----------------------------------------------------------------------------------------------------
+At24c32Model::At24c32Model(uint8_t address) :
+  pageWrites(0), busyNacks(0), bytesRead(0), errors(0),
+  address(address), counter(0), latched(0), received(0), selected(false), reading(false), readyAt(0)
+{
+  memset(memory, 0xFF, sizeof(memory));
+  hostI2cDevice = this;
+}
+
+// ----------------------------------------------------------------------------------------------------
+At24c32Model::~At24c32Model()
+{
+  if (hostI2cDevice == this)
+  {
+    hostI2cDevice = NULL;
+  }
+}
+
+// ----------------------------------------------------------------------------------------------------
+bool At24c32Model::start(uint8_t address, bool read)
+{
+  selected = false;
+  if (address != this->address)
+  {
+    return false;
+  }
+  if ((long)(micros() - readyAt) < 0)
+  {
+    busyNacks++;
+    return false;
+  }
+  selected = true;
+  reading = read;
+  received = 0;
+  latched = 0;
+  return true;
+}
+
+// ----------------------------------------------------------------------------------------------------
+bool At24c32Model::write(uint8_t value)
+{
+  if (!selected || reading)
+  {
+    return false;
+  }
+  if (received == 0)
+  {
+    counter = (value & 0x0F) << 8;
+  }
+  else if (received == 1)
+  {
+    counter |= value;
+  }
+  else
+  {
+    if (latched == sizeof(latch))
+    {
+      errors++;
+    }
+    latch[(counter + latched) % sizeof(latch)] = value;
+    latched = (latched < sizeof(latch)) ? latched + 1 : latched;
+  }
+  received = (received < 2) ? received + 1 : received;
+  return true;
+}
+
+// ----------------------------------------------------------------------------------------------------
+uint8_t At24c32Model::read()
+{
+  uint8_t value = memory[counter];
+
+  counter = (counter + 1) % sizeof(memory);
+  bytesRead++;
+  return value;
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Starts the write cycle for the bytes latched, which only ever fill their page.
+void At24c32Model::stop()
+{
+  if (selected && !reading && latched > 0)
+  {
+    uint16_t page = counter - counter % sizeof(latch);
+
+    for (uint8_t i = 0; i < latched; i++)
+    {
+      uint8_t offset = (counter + i) % sizeof(latch);
+
+      memory[page + offset] = latch[offset];
+    }
+    counter = page + (counter + latched) % sizeof(latch);
+    pageWrites++;
+    readyAt = micros() + AT24C32_MODEL_WRITE_US;
+  }
+  selected = false;
+}
@@ -0,0 +1,47 @@
+#ifndef AT24C32MODEL_H_
+#define AT24C32MODEL_H_
+
+// An AT24C32 on the I2C bus model (see Wire.h).
+//
+// A write sets the chip's address counter from its first two bytes and
+// latches the rest, wrapping within the 32 byte page as the chip does; it
+// goes into the array at the stop, and the chip then NACKs its address for
+// the write cycle, 5 ms. Reads run on from the address counter over the
+// whole chip. A write that wraps within its page is counted as an error, as
+// the driver never means to.
+
+#include "Arduino.h"
+#include "Wire.h"
+
+#define AT24C32_MODEL_WRITE_US  5000UL
+
+class At24c32Model : public HostI2cDevice
+{
+  public:
+    // A blank chip at address, attached to the bus.
+    explicit At24c32Model(uint8_t address = 0x57);
+    ~At24c32Model();
+
+    bool start(uint8_t address, bool read);
+    bool write(uint8_t value);
+    uint8_t read();
+    void stop();
+
+    uint8_t memory[4096];
+    unsigned long pageWrites;
+    unsigned long busyNacks;        // starts while a write cycle ran
+    unsigned long bytesRead;
+    unsigned long errors;
+
+  private:
+    uint8_t address;
+    uint16_t counter;               // the chip's address counter
+    uint8_t latch[32];
+    uint8_t latched;                // data bytes of the write so far
+    uint8_t received;               // bytes of the write so far, address bytes included
+    bool selected;
+    bool reading;
+    unsigned long readyAt;          // micros() the write cycle ends at
+};
+
+#endif
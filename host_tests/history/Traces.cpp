@@ -0,0 +1,87 @@
+#include "Traces.h"
+
+#define SECS_PER_DAY    86400UL
+
+static uint32_t state;
+
+// ----------------------------------------------------------------------------------------------------
+// xorshift32, 0 to n-1
+static uint32_t random(uint32_t n)
+{
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state % n;
+}
+
+// ----------------------------------------------------------------------------------------------------
+void sessionTrace(std::vector<SessionRecord> &trace, unsigned int days, uint32_t firstDay, uint32_t seed)
+{
+  state = seed | 1;
+  for (unsigned int d = 0; d < days; d++)
+  {
+    if (random(7) == 0)
+    {
+      continue;
+    }
+
+    uint32_t t = (firstDay + d) * SECS_PER_DAY + 8 * 3600UL + random(3 * 3600UL);
+    unsigned int cycles = 4 + random(9);
+
+    for (unsigned int i = 0; i < cycles; i++)
+    {
+      SessionRecord focus = { t, 1500, SESSION_FOCUS, 0 };
+
+      if (random(10) == 0)
+      {
+        focus.duration = 60 + random(1400);
+        focus.flags = SESSION_INTERRUPTED;
+      }
+      trace.push_back(focus);
+      t += focus.duration + random(20);
+
+      SessionRecord rest = { t, 300, SESSION_SHORT_BREAK, 0 };
+
+      if (i % 4 == 3)
+      {
+        rest.duration = 900;
+        rest.phase = SESSION_LONG_BREAK;
+      }
+      trace.push_back(rest);
+      t += rest.duration + random(40);
+      if (random(8) == 0)
+      {
+        t += 1800 + random(5400);
+      }
+    }
+  }
+}
+
+// ----------------------------------------------------------------------------------------------------
+void climateTrace(std::vector<ClimateSample> &trace, unsigned int days, bool dht22, uint32_t seed)
+{
+  state = seed | 1;
+  for (unsigned int d = 0; d < days; d++)
+  {
+    for (unsigned int minute = 0; minute < 1440; minute += 10)
+    {
+      // Tenths, on a triangle wave lowest at 3:00 and highest at 15:00
+      unsigned int sinceLow = (minute + 1440 - 180) % 1440;
+      unsigned int fromLow = (sinceLow > 720) ? 1440 - sinceLow : sinceLow;
+      int swing = (int)fromLow * 40 / 720 - 20;
+      int celsius = 210 + swing + (int)random(5) - 2;
+      int humidity = 450 - 2 * swing + 10 * ((int)random(7) - 3);
+      ClimateSample sample;
+
+      if (!dht22)
+      {
+        celsius = (celsius + 5) / 10 * 10;
+        humidity = (humidity + 5) / 10 * 10;
+      }
+      sample.minuteOfDay = minute;
+      sample.celsius = celsius * 256 / 10;
+      sample.humidity = humidity * 256 / 10;
+      trace.push_back(sample);
+    }
+  }
+}
@@ -0,0 +1,24 @@
+#ifndef TRACES_H_
+#define TRACES_H_
+
+// Synthetic histories for the history log tests and benchmark. They come from
+// a fixed-seed generator and integer arithmetic only, so the same seed gives
+// the same trace on every machine and the benchmark's byte counts repeat.
+
+#include "SessionLog.h"
+#include "ClimateRecord.h"
+#include <vector>
+
+// Pomodoro days from day firstDay on (days since 1 January 2000): about one
+// day in seven off, else 4 to 12 focus sessions from around 8:00, each followed
+// by a short break or every fourth by a long one, with seconds to a minute
+// between them and now and then a longer pause. One focus session in ten is
+// interrupted part way.
+extern void sessionTrace(std::vector<SessionRecord> &trace, unsigned int days, uint32_t firstDay, uint32_t seed);
+
+// A sample every 10 minutes for days, indoors: 21 C and 45% with a daily swing
+// of 2 C, humidity moving against it, and sensor noise. Whole degrees and
+// percent as a DHT11 reads, else tenths as a DHT22 does.
+extern void climateTrace(std::vector<ClimateSample> &trace, unsigned int days, bool dht22, uint32_t seed);
+
+#endif
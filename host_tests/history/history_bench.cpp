@@ -0,0 +1,102 @@
+// Space the delta and varint encodings take on the synthetic traces of
+// Traces.h, compared with history/baseline.txt when given it:
+//
+//   build/history_bench [history/baseline.txt]
+//
+// The traces come from fixed seeds and the counts are of bytes, not time, so
+// every run on every machine prints the same numbers.
+
+#include "At24c32Model.h"
+#include "Traces.h"
+#include "Bench.h"
+
+#define RAW_SESSION     8       // start, duration, phase and flags as stored before
+#define RAW_CLIMATE     6       // minute, celsius and humidity
+
+static At24c32Model eeprom;
+
+// ----------------------------------------------------------------------------------------------------
+// Bytes of the chip a session takes, pages counted whole, over days of sessions.
+static double sessionBytes(unsigned int days)
+{
+  std::vector<SessionRecord> trace;
+
+  memset(eeprom.memory, 0xFF, sizeof(eeprom.memory));
+  sessionLogBegin();
+  sessionTrace(trace, days, 8000, 1);
+  for (size_t i = 0; i < trace.size(); i++)
+  {
+    sessionLogAppend(&trace[i]);
+  }
+  sessionLogFlush();
+  return (double)sessionLogPages() * AT24C32_PAGE_SIZE / trace.size();
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Sessions the chip holds once the ring is full and drops its oldest pages.
+static double sessionCapacity()
+{
+  std::vector<SessionRecord> trace;
+  SessionCursor cursor;
+  SessionRecord record;
+  unsigned int held = 0;
+
+  memset(eeprom.memory, 0xFF, sizeof(eeprom.memory));
+  sessionLogBegin();
+  sessionTrace(trace, 400, 8000, 1);
+  for (size_t i = 0; i < trace.size(); i++)
+  {
+    sessionLogAppend(&trace[i]);
+  }
+  sessionLogFlush();
+  sessionLogSeek(&cursor, 0);
+  while (sessionLogNext(&cursor, &record))
+  {
+    held++;
+  }
+  return held;
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Bytes a climate sample takes in FlashLog, its length byte included, over 30
+// days with a reset on day 12.
+static double climateBytes(bool dht22)
+{
+  std::vector<ClimateSample> trace;
+  ClimateSample previous;
+  unsigned long bytes = 0;
+
+  climateTrace(trace, 30, dht22, 3);
+  for (size_t i = 0; i < trace.size(); i++)
+  {
+    byte data[CLIMATE_RECORD_MAX];
+    bool key = trace[i].minuteOfDay == 0 || i == 12 * 144 + 50;
+
+    bytes += 1 + climateEncode(data, &trace[i], key ? NULL : &previous);
+    previous = trace[i];
+  }
+  return (double)bytes / trace.size();
+}
+
+// ----------------------------------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+  if (argc > 1)
+  {
+    benchBaseline(argv[1]);
+  }
+
+  double month = sessionBytes(30);
+  double dht11 = climateBytes(false);
+  double dht22 = climateBytes(true);
+
+  benchReport("session_bytes_30_days", month);
+  benchReport("session_bytes_90_days", sessionBytes(90));
+  benchReport("session_ratio_30_days", RAW_SESSION / month);
+  benchReport("session_capacity", sessionCapacity());
+  benchReport("climate_bytes_dht11", dht11);
+  benchReport("climate_bytes_dht22", dht22);
+  benchReport("climate_ratio_dht11", (RAW_CLIMATE + 1) / dht11);
+  benchReport("climate_ratio_dht22", (RAW_CLIMATE + 1) / dht22);
+  return 0;
+}
@@ -0,0 +1,301 @@
+// The delta and varint encoded histories: Varint, SessionLog on an AT24C32
+// model (At24c32Model.h) and ClimateRecord, round trips over month-long
+// synthetic traces (Traces.h) with resets and random seeks.
+
+#include "At24c32Model.h"
+#include "Traces.h"
+#include "Varint.h"
+#include "Check.h"
+#include "Scenario.h"
+#include <random>
+#include <algorithm>
+
+static At24c32Model eeprom;
+static std::mt19937 rng(11);
+
+// ----------------------------------------------------------------------------------------------------
+static uint32_t random(uint32_t n)
+{
+  return rng() % n;
+}
+
+// ----------------------------------------------------------------------------------------------------
+static bool same(const SessionRecord &a, const SessionRecord &b)
+{
+  return a.start == b.start && a.duration == b.duration && a.phase == b.phase &&
+         (a.flags & SESSION_INTERRUPTED) == (b.flags & SESSION_INTERRUPTED);
+}
+
+// ----------------------------------------------------------------------------------------------------
+static std::vector<SessionRecord> readAll()
+{
+  std::vector<SessionRecord> all;
+  SessionCursor cursor;
+  SessionRecord record;
+
+  sessionLogSeek(&cursor, 0);
+  while (sessionLogNext(&cursor, &record))
+  {
+    all.push_back(record);
+  }
+  return all;
+}
+
+// ----------------------------------------------------------------------------------------------------
+static void varint()
+{
+  static const uint32_t edges[] = { 0, 1, 127, 128, 16383, 16384, 0x1FFFFF, 0x200000, 0xFFFFFFF, 0x10000000, 0xFFFFFFFF };
+  static const byte sizes[] = { 1, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5 };
+  byte data[VARINT_MAX_SIZE + 1];
+  uint32_t value;
+
+  for (unsigned int i = 0; i < sizeof(edges) / sizeof(edges[0]); i++)
+  {
+    byte *end = varintWrite(data, edges[i]);
+
+    CHECK_EQ(end - data, sizes[i]);
+    CHECK(varintRead(data, end, &value) == end);
+    CHECK_EQ(value, edges[i]);
+    CHECK(varintRead(data, end - 1, &value) == NULL);
+  }
+
+  // Runs on past a 32 bit value, or past the end
+  memset(data, 0x80, sizeof(data));
+  CHECK(varintRead(data, data + sizeof(data), &value) == NULL);
+
+  unsigned int mismatches = 0;
+
+  for (unsigned long i = 0; i < 100000; i++)
+  {
+    uint32_t v = rng() >> random(32);
+    byte *end = varintWrite(data, v);
+
+    mismatches += varintRead(data, data + sizeof(data), &value) != end || value != v;
+  }
+  CHECK_EQ(mismatches, 0);
+}
+
+// ----------------------------------------------------------------------------------------------------
+static void zigzag()
+{
+  CHECK_EQ(zigzagEncode(0), 0);
+  CHECK_EQ(zigzagEncode(-1), 1);
+  CHECK_EQ(zigzagEncode(1), 2);
+  CHECK_EQ(zigzagEncode(-2), 3);
+  CHECK_EQ(zigzagEncode(2147483647), 0xFFFFFFFE);
+  CHECK_EQ(zigzagEncode(-2147483647 - 1), 0xFFFFFFFF);
+
+  unsigned int mismatches = 0;
+
+  for (unsigned long i = 0; i < 100000; i++)
+  {
+    int32_t v = (int32_t)rng() >> random(31);
+
+    mismatches += zigzagDecode(zigzagEncode(v)) != v;
+  }
+  CHECK_EQ(mismatches, 0);
+}
+
+// ----------------------------------------------------------------------------------------------------
+// 400 days of sessions, with a reset now and then, which loses the sessions
+// not flushed yet, and the log read back and sought into as it goes.
+static void sessions()
+{
+  std::vector<SessionRecord> all;
+  std::vector<SessionRecord> kept;
+  unsigned int resets = 0;
+
+  CHECK(sessionLogBegin());
+  CHECK(sessionLogEmpty());
+  CHECK(readAll().empty());
+
+  sessionTrace(all, 400, 8000, 1);
+
+  // Overlapping sessions, and a gap too long for a record, each start a page
+  SessionRecord overlap = { all.back().start + 100, 600, SESSION_FOCUS, 0 };
+  SessionRecord far = { overlap.start + (uint32_t)0x30000000, 1500, SESSION_FOCUS, 0 };
+
+  all.push_back(overlap);
+  overlap.start += 10;
+  all.push_back(overlap);
+  all.push_back(far);
+  far.start += 1600;
+  all.push_back(far);
+
+  for (size_t i = 0; i < all.size(); i++)
+  {
+    CHECK(sessionLogAppend(&all[i]));
+    kept.push_back(all[i]);
+
+    if (random(50) == 0)
+    {
+      if (random(2))
+      {
+        CHECK(sessionLogFlush());
+      }
+      CHECK(sessionLogBegin());
+      resets++;
+
+      // What is left is what was kept, less at most a page's worth at the end
+      std::vector<SessionRecord> got = readAll();
+      size_t j = 0;
+
+      for (size_t k = 0; k < got.size(); k++)
+      {
+        while (j < kept.size() && !same(kept[j], got[k]))
+        {
+          j++;
+        }
+        j++;
+      }
+      CHECK(j <= kept.size());
+      CHECK(kept.size() - j <= AT24C32_PAGE_SIZE / 2);
+      kept = got;
+    }
+
+    if (random(20) == 0)
+    {
+      // The log holds the newest sessions kept
+      std::vector<SessionRecord> got = readAll();
+
+      CHECK(!got.empty() && got.size() <= kept.size());
+      CHECK(std::equal(got.begin(), got.end(), kept.end() - got.size(), same));
+
+      for (unsigned int k = 0; k < 5; k++)
+      {
+        uint32_t t = got[random(got.size())].start + (random(2) ? 0 : random(3000));
+        std::vector<SessionRecord>::iterator expected = got.begin();
+        SessionCursor cursor;
+        SessionRecord record;
+
+        while (expected != got.end() && expected->start < t)
+        {
+          expected++;
+        }
+        sessionLogSeek(&cursor, t);
+        if (expected == got.end())
+        {
+          CHECK(!sessionLogNext(&cursor, &record));
+        }
+        else
+        {
+          CHECK(sessionLogNext(&cursor, &record) && same(*expected, record));
+        }
+      }
+    }
+  }
+  CHECK(resets > 100);
+  CHECK_EQ(sessionLogPages(), SESSION_LOG_PAGES);
+  CHECK_EQ(eeprom.errors, 0);
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Out of order sessions and phase 3 are refused; a cursor on the newest page
+// sees sessions appended after it read the page.
+static void appending()
+{
+  std::vector<SessionRecord> all;
+
+  CHECK(sessionLogBegin());
+  sessionTrace(all, 3, 8000, 2);
+  for (size_t i = 0; i < all.size(); i++)
+  {
+    CHECK(sessionLogAppend(&all[i]));
+  }
+
+  SessionRecord late = all.back();
+  SessionRecord bad = { late.start + 2000, 10, 3, 0 };
+
+  late.start--;
+  CHECK(!sessionLogAppend(&late));
+  CHECK(!sessionLogAppend(&bad));
+
+  SessionCursor cursor;
+  SessionRecord record;
+  SessionRecord next = { all.back().start + 2000, 300, SESSION_SHORT_BREAK, 0 };
+
+  sessionLogSeek(&cursor, all.back().start);
+  CHECK(sessionLogNext(&cursor, &record) && same(record, all.back()));
+  CHECK(!sessionLogNext(&cursor, &record));
+  CHECK(sessionLogAppend(&next));
+  CHECK(sessionLogNext(&cursor, &record) && same(record, next));
+
+  // Each page is written when it is opened and when it is full, or flushed
+  CHECK(sessionLogFlush());
+  CHECK_EQ(eeprom.pageWrites, 2 * sessionLogPages());
+  CHECK_EQ(eeprom.errors, 0);
+  // Back to back page writes poll the chip through its write cycles
+  CHECK(sessionLogClear());
+  CHECK(eeprom.busyNacks > 0);
+  CHECK(sessionLogEmpty());
+  CHECK(readAll().empty());
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Decodes a day of climate records, keyframes at the start and after a reset.
+static void climate()
+{
+  for (int dht22 = 0; dht22 < 2; dht22++)
+  {
+    std::vector<ClimateSample> trace;
+    ClimateSample previous;
+    ClimateSample decoded;
+    unsigned int mismatches = 0;
+    unsigned int keyframes = 0;
+
+    climateTrace(trace, 30, dht22, 3);
+    for (size_t i = 0; i < trace.size(); i++)
+    {
+      byte data[CLIMATE_RECORD_MAX];
+      bool key = trace[i].minuteOfDay == 0 || i == 12 * 144 + 50;
+      byte length = climateEncode(data, &trace[i], key ? NULL : &previous);
+
+      keyframes += data[0] == 0;
+      mismatches += length > CLIMATE_RECORD_MAX || !climateDecode(data, length, &decoded) ||
+                    decoded.minuteOfDay != trace[i].minuteOfDay ||
+                    decoded.celsius != trace[i].celsius || decoded.humidity != trace[i].humidity;
+      previous = trace[i];
+    }
+    CHECK_EQ(mismatches, 0);
+    CHECK_EQ(keyframes, 31);
+  }
+
+  // Extremes either way, and a change across the whole range
+  ClimateSample low = { 0, -32768, -32768 };
+  ClimateSample high = { 1439, 32767, 32767 };
+  ClimateSample decoded = low;
+  byte data[CLIMATE_RECORD_MAX];
+  byte length = climateEncode(data, &high, &low);
+
+  CHECK(length <= CLIMATE_RECORD_MAX);
+  CHECK(climateDecode(data, length, &decoded));
+  CHECK_EQ(decoded.celsius, 32767);
+  CHECK_EQ(decoded.humidity, 32767);
+
+  length = climateEncode(data, &low, NULL);
+  CHECK(length <= CLIMATE_RECORD_MAX);
+  CHECK(climateDecode(data, length, &decoded));
+  CHECK_EQ(decoded.celsius, -32768);
+  CHECK(!climateDecode(data, length - 1, &decoded));
+  CHECK(!climateDecode(data, 0, &decoded));
+
+  // A sample no later in the day than the one before is a keyframe
+  ClimateSample again = high;
+
+  CHECK_EQ(climateEncode(data, &again, &high), 1 + 2 + 3 + 3);
+  CHECK_EQ(data[0], 0);
+}
+
+// ----------------------------------------------------------------------------------------------------
+int main()
+{
+  static const Scenario scenarios[] = {
+    { "varint", varint },
+    { "zigzag", zigzag },
+    { "sessions", sessions },
+    { "appending", appending },
+    { "climate", climate },
+  };
+
+  return runScenarios(scenarios, sizeof(scenarios) / sizeof(scenarios[0]));
+}
@@ -0,0 +1,42 @@
+#!/bin/sh
+# Turns a sketch into a C++ file the way the Arduino builder does: CRLF line
+# ends are dropped, Arduino.h is included first and every function defined at
+# the top level is declared ahead of the first definition, so functions can be
+# called before they are defined.
+#
+# usage: ino2cpp.sh sketch output.cpp
+
+set -e
+
+tr -d '\r' < "$1" > "$2.tmp"
+awk -v sketch="$1" '
+  function definition(line)
+  {
+    return line ~ /^[A-Za-z_][A-Za-z0-9_]*([ \t]+[A-Za-z_][A-Za-z0-9_]*)*[ \t*]+[A-Za-z_][A-Za-z0-9_]*\([^;]*\)[ \t]*\{?[ \t]*$/ &&
+           line !~ /^(if|else|for|while|switch|return|typedef|struct|class|enum|SIGNAL|ISR)[ \t(]/
+  }
+
+  NR == FNR {
+    if (definition($0))
+    {
+      prototype = $0
+      sub(/[ \t]*\{?[ \t]*$/, ";", prototype)
+      prototypes = prototypes prototype "\n"
+    }
+    next
+  }
+
+  FNR == 1 {
+    print "#include <Arduino.h>"
+    print "#line 1 \"" sketch "\""
+  }
+
+  !declared && definition($0) {
+    printf "%s", prototypes
+    print "#line " FNR " \"" sketch "\""
+    declared = 1
+  }
+
+  { print }
+' "$2.tmp" "$2.tmp" > "$2"
+rm -f "$2.tmp"
@@ -0,0 +1,66 @@
+// ns per call of LcdKeypad's string routines on typical menu text, compared
+// with lcdkeypad/baseline.txt when given it:
+//
+//   build/lcdkeypad_bench [lcdkeypad/baseline.txt]
+//
+// The inputs are fixed, so runs differ only by the machine's timing noise.
+
+#include "LcdKeypad.h"
+#include "Bench.h"
+
+#define ITERATIONS 2000000UL
+
+static char dest[LCD_COLS + 1];
+
+// ----------------------------------------------------------------------------------------------------
+static void inttostrSmall(unsigned long i)
+{
+  benchSink += inttostr(dest, (short)(i % 100))[0];
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Spread over the whole range, about half of them negative
+static void inttostrAny(unsigned long i)
+{
+  benchSink += inttostr(dest, (short)(i * 7919))[0];
+}
+
+// ----------------------------------------------------------------------------------------------------
+static void fmtMenuLine(unsigned long i)
+{
+  benchSink += fmt(dest, 4, "Set ", "12", ":", "30")[i % 9];
+}
+
+// ----------------------------------------------------------------------------------------------------
+static void fmtTooLong(unsigned long i)
+{
+  benchSink += fmt(dest, 3, "Backlight level ", "of the ", "display")[i % LCD_COLS];
+}
+
+// ----------------------------------------------------------------------------------------------------
+static void rpadLabel(unsigned long i)
+{
+  benchSink += rpad(dest, "Volume")[i % LCD_COLS];
+}
+
+// ----------------------------------------------------------------------------------------------------
+static void lpadNumber(unsigned long i)
+{
+  benchSink += lpad(dest, "42", ' ', 5)[i % 5];
+}
+
+// ----------------------------------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+  if (argc > 1)
+  {
+    benchBaseline(argv[1]);
+  }
+  benchReport("inttostr_0_99", benchNsPerCall(inttostrSmall, ITERATIONS));
+  benchReport("inttostr_any", benchNsPerCall(inttostrAny, ITERATIONS));
+  benchReport("fmt_menu_line", benchNsPerCall(fmtMenuLine, ITERATIONS));
+  benchReport("fmt_too_long", benchNsPerCall(fmtTooLong, ITERATIONS));
+  benchReport("rpad_label", benchNsPerCall(rpadLabel, ITERATIONS));
+  benchReport("lpad_number", benchNsPerCall(lpadNumber, ITERATIONS));
+  return 0;
+}
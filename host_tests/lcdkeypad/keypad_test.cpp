@@ -0,0 +1,135 @@
+// LcdKeypad's string routines against plain references: inttostr() for every
+// short, the padding and fmt() for every length up to past the display width.
+// Guard bytes after the result catch writes past the terminator.
+
+#include "LcdKeypad.h"
+#include "Check.h"
+#include "Scenario.h"
+#include <stdio.h>
+#include <string.h>
+
+#define GUARD     '#'
+#define BUFFER    (LCD_COLS + 8)
+#define MAX_TEXT  (LCD_COLS + 4)
+
+static char text[MAX_TEXT + 1];
+
+// ----------------------------------------------------------------------------------------------------
+// Text of length characters, each different from its neighbours and the guard.
+static const char *sample(unsigned char length)
+{
+  for (unsigned char i = 0; i < length; i++)
+  {
+    text[i] = 'a' + i;
+  }
+  text[length] = '\0';
+  return text;
+}
+
+// ----------------------------------------------------------------------------------------------------
+// True if nothing after the terminator of dest was written.
+static bool guarded(const char *dest)
+{
+  for (size_t i = strlen(dest) + 1; i < BUFFER; i++)
+  {
+    if (dest[i] != GUARD)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// ----------------------------------------------------------------------------------------------------
+static void everyShort()
+{
+  char dest[BUFFER];
+  char expected[8];
+
+  for (long value = -32768; value <= 32767; value++)
+  {
+    memset(dest, GUARD, sizeof(dest));
+    snprintf(expected, sizeof(expected), "%ld", value);
+    CHECK(inttostr(dest, (short)value) == dest);
+    CHECK_STR(dest, expected);
+    CHECK(guarded(dest));
+  }
+}
+
+// ----------------------------------------------------------------------------------------------------
+static void padding()
+{
+  char dest[BUFFER];
+  char expected[BUFFER];
+
+  for (unsigned char length = 0; length <= MAX_TEXT; length++)
+  {
+    for (unsigned char width = 0; width <= LCD_COLS + 2; width++)
+    {
+      unsigned char shown = (width > LCD_COLS) ? LCD_COLS : width;
+      unsigned char kept = (length < shown) ? length : shown;
+      const char *str = sample(length);
+
+      // The text first then the padding, cut to the width from the start
+      memcpy(expected, str, kept);
+      memset(expected + kept, '.', shown - kept);
+      expected[shown] = '\0';
+      memset(dest, GUARD, sizeof(dest));
+      CHECK(rpad(dest, str, '.', width) == dest);
+      CHECK_STR(dest, expected);
+      CHECK(guarded(dest));
+
+      // The padding first; a text as wide as the field is cut the same way
+      memset(expected, '.', shown - kept);
+      memcpy(expected + shown - kept, str, kept);
+      expected[shown] = '\0';
+      memset(dest, GUARD, sizeof(dest));
+      CHECK(lpad(dest, str, '.', width) == dest);
+      CHECK_STR(dest, expected);
+      CHECK(guarded(dest));
+    }
+  }
+
+  // The defaults fill the display width with spaces
+  CHECK_STR(rpad(dest, "Volume"), "Volume          ");
+  CHECK_STR(lpad(dest, "42"), "              42");
+}
+
+// ----------------------------------------------------------------------------------------------------
+static void concatenation()
+{
+  static const char *parts[] = { "", "7", "Set ", "Alarm: ", "1234567890ABC", "Longer than sixteen" };
+  const unsigned char count = sizeof(parts) / sizeof(parts[0]);
+  char dest[BUFFER];
+  char expected[64];
+
+  for (unsigned char a = 0; a < count; a++)
+  {
+    for (unsigned char b = 0; b < count; b++)
+    {
+      for (unsigned char c = 0; c < count; c++)
+      {
+        snprintf(expected, sizeof(expected), "%s%s%s", parts[a], parts[b], parts[c]);
+        expected[(strlen(expected) > LCD_COLS) ? LCD_COLS : strlen(expected)] = '\0';
+        memset(dest, GUARD, sizeof(dest));
+        CHECK(fmt(dest, 3, parts[a], parts[b], parts[c]) == dest);
+        CHECK_STR(dest, expected);
+        CHECK(guarded(dest));
+      }
+    }
+  }
+  CHECK_STR(fmt(dest, 0), "");
+  CHECK_STR(fmt(dest, 4, "Set ", "12", ":", "30"), "Set 12:30");
+}
+
+// ----------------------------------------------------------------------------------------------------
+int main()
+{
+  static const Scenario scenarios[] = {
+    { "inttostr", everyShort },
+    { "rpad/lpad", padding },
+    { "fmt", concatenation },
+  };
+
+  return runScenarios(scenarios, sizeof(scenarios) / sizeof(scenarios[0]));
+}
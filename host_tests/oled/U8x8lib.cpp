@@ -0,0 +1,84 @@
+#include "U8x8lib.h"
+#include <string.h>
+
+const uint8_t u8x8_font_chroma48medium8_r[] = { 0 };
+
+// ----------------------------------------------------------------------------------------------------
+U8X8::U8X8() : font(NULL), draws(0)
+{
+  memset(tiles, 0, sizeof(tiles));
+}
+
+// ----------------------------------------------------------------------------------------------------
+void U8X8::clearDisplay()
+{
+  memset(tiles, 0, sizeof(tiles));
+  draws++;
+}
+
+// ----------------------------------------------------------------------------------------------------
+void U8X8::drawGlyph(uint8_t x, uint8_t y, uint8_t encoding)
+{
+  if (x < 16 && y < 8)
+  {
+    tiles[y][x].glyph = encoding;
+    tiles[y][x].big = 0;
+  }
+  draws++;
+}
+
+// ----------------------------------------------------------------------------------------------------
+void U8X8::draw2x2Glyph(uint8_t x, uint8_t y, uint8_t encoding)
+{
+  for (byte quadrant = 0; quadrant < 4; quadrant++)
+  {
+    byte col = x + (quadrant & 1);
+    byte row = y + (quadrant >> 1);
+
+    if (col < 16 && row < 8)
+    {
+      tiles[row][col].glyph = encoding;
+      tiles[row][col].big = quadrant + 1;
+    }
+  }
+  draws++;
+}
+
+// ----------------------------------------------------------------------------------------------------
+void U8X8::drawTile(uint8_t x, uint8_t y, uint8_t count, uint8_t *bitmap)
+{
+  for (byte i = 0; i < count && x + i < 16 && y < 8; i++)
+  {
+    tiles[y][x + i].glyph = U8X8_TILE_BITMAP;
+    tiles[y][x + i].big = 0;
+    memcpy(tiles[y][x + i].bitmap, bitmap + 8 * i, 8);
+  }
+  draws++;
+}
+
+// ----------------------------------------------------------------------------------------------------
+uint8_t U8X8::drawString(uint8_t x, uint8_t y, const char *text)
+{
+  uint8_t count = 0;
+
+  while (*text)
+  {
+    drawGlyph(x + count++, y, *text++);
+  }
+  return count;
+}
+
+// ----------------------------------------------------------------------------------------------------
+const char *U8X8::line(byte row)
+{
+  static char text[17];
+
+  for (byte col = 0; col < 16; col++)
+  {
+    char glyph = tiles[row][col].glyph;
+
+    text[col] = (glyph >= ' ') ? glyph : (glyph == U8X8_TILE_EMPTY) ? ' ' : '.';
+  }
+  text[16] = '\0';
+  return text;
+}
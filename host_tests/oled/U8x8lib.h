@@ -0,0 +1,57 @@
+#ifndef U8X8LIB_H_
+#define U8X8LIB_H_
+
+// The part of U8g2's U8x8 interface the OLED sketch uses, drawing into a model
+// of the 16x8 tile panel. Each tile holds what was last sent to it, and every
+// call that reaches the panel is counted, as each costs an I2C transfer.
+
+#include "Arduino.h"
+
+#define U8X8_PIN_NONE 255
+
+#define U8X8_TILE_EMPTY   0       // cleared
+#define U8X8_TILE_BITMAP  1       // drawTile()
+
+typedef struct U8x8Tile {
+  char glyph;                     // character drawn, or one of the U8X8_TILE_... values
+  byte big;                       // 1...4 for the quadrants of a draw2x2Glyph(), else 0
+  byte bitmap[8];                 // columns, for U8X8_TILE_BITMAP
+} U8x8Tile;
+
+extern const uint8_t u8x8_font_chroma48medium8_r[];
+
+class U8X8
+{
+  public:
+    U8X8();
+
+    void begin() {}
+    void setPowerSave(uint8_t on) { (void)on; }
+    void setFont(const uint8_t *font) { this->font = font; }
+    void refreshDisplay() {}
+
+    void clearDisplay();
+    void drawGlyph(uint8_t x, uint8_t y, uint8_t encoding);
+    void draw2x2Glyph(uint8_t x, uint8_t y, uint8_t encoding);
+    void drawTile(uint8_t x, uint8_t y, uint8_t count, uint8_t *bitmap);
+    uint8_t drawString(uint8_t x, uint8_t y, const char *text);
+
+    // The panel, and how many draws reached it.
+    U8x8Tile tiles[8][16];
+    const uint8_t *font;
+    unsigned long draws;
+
+    // Text of a tile row, '.' for tiles that are not characters
+    const char *line(byte row);
+};
+
+class U8X8_SSD1306_128X64_NONAME_SW_I2C : public U8X8
+{
+  public:
+    U8X8_SSD1306_128X64_NONAME_SW_I2C(uint8_t clock, uint8_t data, uint8_t reset)
+    {
+      (void)clock; (void)data; (void)reset;
+    }
+};
+
+#endif
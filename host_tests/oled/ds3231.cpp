@@ -0,0 +1,21 @@
+#include "ds3231.h"
+
+struct ts hostDs3231Time;
+
+// ----------------------------------------------------------------------------------------------------
+void DS3231_init(uint8_t creg)
+{
+  (void)creg;
+}
+
+// ----------------------------------------------------------------------------------------------------
+void DS3231_set(struct ts t)
+{
+  hostDs3231Time = t;
+}
+
+// ----------------------------------------------------------------------------------------------------
+void DS3231_get(struct ts *t)
+{
+  *t = hostDs3231Time;
+}
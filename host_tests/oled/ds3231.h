@@ -0,0 +1,30 @@
+#ifndef DS3231_H_
+#define DS3231_H_
+
+// The DS3231 library's interface, keeping the time set in RAM.
+
+#include "Arduino.h"
+
+#define DS3231_CONTROL_INTCN 0x4
+
+struct ts {
+  uint8_t sec;
+  uint8_t min;
+  uint8_t hour;
+  uint8_t mday;
+  uint8_t mon;
+  int16_t year;
+  uint8_t wday;
+  uint8_t yday;
+  uint8_t isdst;
+  uint8_t year_s;
+};
+
+void DS3231_init(uint8_t creg);
+void DS3231_set(struct ts t);
+void DS3231_get(struct ts *t);
+
+// The time the next DS3231_get() returns
+extern struct ts hostDs3231Time;
+
+#endif
@@ -0,0 +1,116 @@
+// The OLED sketch and OledBackend on a model of the SSD1306's tiles: what the
+// panel shows, and that only the tiles that change are sent again.
+
+#include "OledBackend.h"
+#include "ds3231.h"
+#include "Check.h"
+#include "Scenario.h"
+#include <string.h>
+
+extern U8X8_SSD1306_128X64_NONAME_SW_I2C u8x8;     // the sketch's
+extern OledBackend display;
+
+static const byte bell[8] PROGMEM = { 0x04, 0x0E, 0x0E, 0x0E, 0x1F, 0x00, 0x04, 0x00 };
+
+// ----------------------------------------------------------------------------------------------------
+static void sketch()
+{
+  setup();
+  CHECK(u8x8.font == u8x8_font_chroma48medium8_r);
+  CHECK_STR(u8x8.line(3), "Good Afternoon !");
+
+  loop();
+  CHECK_STR(u8x8.line(0), "   1177::3300   ");
+  CHECK_STR(u8x8.line(1), "   1177::3300   ");
+  CHECK_EQ(u8x8.tiles[0][3].big, 1);
+  CHECK_EQ(u8x8.tiles[1][4].big, 4);
+
+  // The same minute again sends nothing, the next one only its last digit
+  unsigned long draws = u8x8.draws;
+
+  loop();
+  CHECK_EQ(u8x8.draws, draws);
+  hostDs3231Time.min = 31;
+  loop();
+  CHECK_EQ(u8x8.draws, draws + 1);
+  CHECK_STR(u8x8.line(0), "   1177::3311   ");
+}
+
+// ----------------------------------------------------------------------------------------------------
+static void text()
+{
+  U8X8 panel;
+  OledBackend backend(panel);
+
+  CHECK_EQ(backend.columns(), 16);
+  CHECK_EQ(backend.rows(), 8);
+  backend.clear();
+  panel.draws = 0;
+
+  // Blank cells are already blank after clear(); padding sends nothing
+  backend.drawText(0, 2, "Alarm 06:30", 16);
+  CHECK_STR(panel.line(2), "Alarm 06:30     ");
+  CHECK_EQ(panel.draws, 10);
+  backend.drawText(0, 2, "Alarm 06:30", 16);
+  CHECK_EQ(panel.draws, 10);
+  backend.drawText(0, 2, "Alarm 06:35", 16);
+  CHECK_EQ(panel.draws, 11);
+
+  // Cut to the width and to the panel
+  backend.drawText(12, 4, "overflowing", 8);
+  CHECK_STR(panel.line(4), "            over");
+}
+
+// ----------------------------------------------------------------------------------------------------
+static void graphics()
+{
+  U8X8 panel;
+  OledBackend backend(panel);
+
+  backend.clear();
+  panel.draws = 0;
+
+  // Bar cells fill from the left, a column per step; an empty one is a blank
+  CHECK_EQ(backend.barSteps(), 8);
+  backend.drawBarCell(0, 5, 0);
+  CHECK_EQ(panel.draws, 0);
+  backend.drawBarCell(0, 5, 3);
+  CHECK_EQ(panel.tiles[5][0].glyph, U8X8_TILE_BITMAP);
+  CHECK_EQ(panel.tiles[5][0].bitmap[2], 0x7E);
+  CHECK_EQ(panel.tiles[5][0].bitmap[3], 0);
+  backend.drawBarCell(0, 5, 3);
+  CHECK_EQ(panel.draws, 1);
+  backend.drawBarCell(0, 5, 9);
+  CHECK_EQ(panel.tiles[5][0].bitmap[7], 0x7E);
+
+  // Icons are always sent, rows turned into columns one pixel in
+  backend.drawIcon(15, 0, bell);
+  backend.drawIcon(15, 0, bell);
+  CHECK_EQ(panel.draws, 4);
+  CHECK_EQ(panel.tiles[0][15].bitmap[3], 0x1F | 0x40);   // the middle column: rows 0-4 and 6
+  CHECK_EQ(panel.tiles[0][15].bitmap[0], 0);
+  backend.drawIcon(15, 0, NULL);
+  CHECK_EQ(panel.tiles[0][15].glyph, ' ');
+
+  // A big character a text overwrote is drawn again whole
+  backend.drawBigChar(0, 6, '7');
+  backend.drawText(1, 7, "x", 1);
+  panel.draws = 0;
+  backend.drawBigChar(0, 6, '7');
+  CHECK_EQ(panel.draws, 1);
+  CHECK_EQ(panel.tiles[7][1].big, 4);
+  CHECK_EQ(backend.drawBigChar(2, 6, '?'), 2);
+  CHECK_STR(panel.line(6), "77              ");
+}
+
+// ----------------------------------------------------------------------------------------------------
+int main()
+{
+  static const Scenario scenarios[] = {
+    { "sketch", sketch },
+    { "drawText", text },
+    { "bars/icons/big", graphics },
+  };
+
+  return runScenarios(scenarios, sizeof(scenarios) / sizeof(scenarios[0]));
+}
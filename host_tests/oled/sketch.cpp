@@ -0,0 +1,3 @@
+// The OLED sketch and its backend, built from their folder, whose name has a space
+#include "v.1.cpp"
+#include "OledBackend.cpp"
@@ -0,0 +1,234 @@
+// SensorMath's fixed-point results against the float code they replace: the
+// DHT library's heat index, the Magnus dew point and the conversions, over
+// the DHT22's whole range (-40...80 C, 0...100 %RH) in 0.1 steps. On the AVR
+// a double is a float, so the references are computed in float too.
+
+#include "SensorMath.h"
+#include "Check.h"
+#include "Scenario.h"
+#include <math.h>
+#include <stdio.h>
+
+// Hottest heat index on the NWS chart, in F. Past it the regression runs on to
+// over 1000 F at 80 C and 100 %, and the errors are compared relative to that.
+#define HEAT_INDEX_CHART_MAX 136.0
+
+// ----------------------------------------------------------------------------------------------------
+static double toDouble(q16_16_t value)
+{
+  return value / 65536.0;
+}
+
+// ----------------------------------------------------------------------------------------------------
+// DHT::computeHeatIndex() as the library has it, with its float arithmetic.
+static float dhtHeatIndex(float temperature, float percentHumidity, bool isFahrenheit)
+{
+  float hi;
+
+  if (!isFahrenheit)
+  {
+    temperature = temperature * 1.8 + 32;
+  }
+  hi = 0.5 * (temperature + 61.0 + ((temperature - 68.0) * 1.2) + (percentHumidity * 0.094));
+  if (hi > 79)
+  {
+    hi = -42.379 + 2.04901523 * temperature + 10.14333127 * percentHumidity +
+         -0.22475541 * temperature * percentHumidity + -0.00683783 * pow(temperature, 2) +
+         -0.05481717 * pow(percentHumidity, 2) + 0.00122874 * pow(temperature, 2) * percentHumidity +
+         0.00085282 * temperature * pow(percentHumidity, 2) +
+         -0.00000199 * pow(temperature, 2) * pow(percentHumidity, 2);
+    if ((percentHumidity < 13) && (temperature >= 80.0) && (temperature <= 112.0))
+    {
+      hi -= ((13.0 - percentHumidity) * 0.25) * sqrt((17.0 - fabs(temperature - 95.0)) * 0.05882);
+    }
+    else if ((percentHumidity > 85.0) && (temperature >= 80.0) && (temperature <= 87.0))
+    {
+      hi += ((percentHumidity - 85.0) * 0.1) * ((87.0 - temperature) * 0.2);
+    }
+  }
+  return isFahrenheit ? hi : (hi - 32) * 0.55555;
+}
+
+// ----------------------------------------------------------------------------------------------------
+static float magnusDewPoint(float celsius, float percentHumidity)
+{
+  float gamma = log(percentHumidity / 100) + 17.62 * celsius / (243.12 + celsius);
+
+  return 243.12 * gamma / (17.62 - gamma);
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Runs error() over the sensor range and returns the largest error it reported.
+static double overSensorRange(double (*error)(double celsius, double humidity))
+{
+  double worst = 0;
+
+  for (int tenthsC = -400; tenthsC <= 800; tenthsC++)
+  {
+    for (int tenthsRH = 0; tenthsRH <= 1000; tenthsRH += 5)
+    {
+      worst = fmax(worst, error(tenthsC / 10.0, tenthsRH / 10.0));
+    }
+  }
+  return worst;
+}
+
+// ----------------------------------------------------------------------------------------------------
+static double fahrenheitError(double celsius, double humidity)
+{
+  double fahrenheit = celsius * 1.8 + 32;
+
+  return fmax(fabs(toDouble(celsiusToFahrenheit(Q16_16(celsius))) - (float)fahrenheit),
+              fabs(toDouble(fahrenheitToCelsius(Q16_16(fahrenheit))) - (float)celsius));
+}
+
+// ----------------------------------------------------------------------------------------------------
+static double heatIndexError(double celsius, double humidity)
+{
+  float fahrenheit = celsius * 1.8 + 32;
+  float reference = dhtHeatIndex(fahrenheit, humidity, true);
+
+  if (reference > HEAT_INDEX_CHART_MAX)
+  {
+    return 0;
+  }
+  return fabs(toDouble(computeHeatIndex(Q16_16(fahrenheit), Q16_16(humidity))) - reference);
+}
+
+// ----------------------------------------------------------------------------------------------------
+static double heatIndexRelativeError(double celsius, double humidity)
+{
+  float fahrenheit = celsius * 1.8 + 32;
+  float reference = dhtHeatIndex(fahrenheit, humidity, true);
+
+  if (reference <= HEAT_INDEX_CHART_MAX)
+  {
+    return 0;
+  }
+  return fabs(toDouble(computeHeatIndex(Q16_16(fahrenheit), Q16_16(humidity))) - reference) / reference;
+}
+
+// ----------------------------------------------------------------------------------------------------
+static double heatIndexCelsiusError(double celsius, double humidity)
+{
+  float reference = dhtHeatIndex(celsius, humidity, false);
+
+  if (reference * 1.8 + 32 > HEAT_INDEX_CHART_MAX)
+  {
+    return 0;
+  }
+  return fabs(toDouble(computeHeatIndex(Q16_16(celsius), Q16_16(humidity), false)) - reference);
+}
+
+// ----------------------------------------------------------------------------------------------------
+static double dewPointError(double celsius, double humidity)
+{
+  if (humidity < 1)
+  {
+    return 0;     // computeDewPoint() holds the humidity at 1 %, where the formula goes to -infinity
+  }
+  return fabs(toDouble(computeDewPoint(Q16_16(celsius), Q16_16(humidity))) - magnusDewPoint(celsius, humidity));
+}
+
+// ----------------------------------------------------------------------------------------------------
+static void arithmetic()
+{
+  double sqrtError = 0;
+  double logError = 0;
+
+  for (double x = 0.01; x < 30000; x *= 1.01)
+  {
+    sqrtError = fmax(sqrtError, fabs(toDouble(qsqrt(Q16_16(x))) - sqrt(x)) / sqrt(x));
+    logError = fmax(logError, fabs(toDouble(qlog2(Q16_16(x))) - log2(x)));
+  }
+  printf("  qsqrt relative error %.6f, qlog2 error %.5f\n", sqrtError, logError);
+  CHECK(sqrtError < 0.001);
+  CHECK(logError < 0.001);
+
+  for (int a = -300; a <= 300; a += 7)
+  {
+    for (int b = -300; b <= 300; b += 11)
+    {
+      double x = a / 3.0;
+      double y = b / 7.0;
+
+      CHECK(fabs(toDouble(qmul(Q16_16(x), Q16_16(y))) - x * y) < 0.002);
+      if (b != 0)
+      {
+        CHECK(fabs(toDouble(qdiv(Q16_16(x), Q16_16(y))) - x / y) < 0.0001 * (1 + fabs(x / y)));
+      }
+    }
+  }
+  CHECK_EQ(qdiv(Q16_16(1), 0), INT32_MAX);
+  CHECK_EQ(qdiv(Q16_16(-1), 0), INT32_MIN);
+  CHECK_EQ(qsqrt(Q16_16(-4)), 0);
+}
+
+// ----------------------------------------------------------------------------------------------------
+static void conversions()
+{
+  double error = overSensorRange(fahrenheitError);
+
+  printf("  Fahrenheit/Celsius error %.5f\n", error);
+  CHECK(error < 0.001);
+}
+
+// ----------------------------------------------------------------------------------------------------
+static void heatIndex()
+{
+  double error = overSensorRange(heatIndexError);
+  double errorCelsius = overSensorRange(heatIndexCelsiusError);
+  double relativeError = overSensorRange(heatIndexRelativeError);
+
+  printf("  heat index error %.5f F, %.5f C up to the chart's %.0f F, relative error %.7f past it\n",
+         error, errorCelsius, HEAT_INDEX_CHART_MAX, relativeError);
+  CHECK(error < 0.011);
+  CHECK(errorCelsius < 0.011);
+  CHECK(relativeError < 0.0001);
+}
+
+// ----------------------------------------------------------------------------------------------------
+static void dewPoint()
+{
+  double error = overSensorRange(dewPointError);
+
+  printf("  dew point error %.4f C\n", error);
+  CHECK(error < 0.011);
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Rounded half away from zero, never "-0.0"
+static void tenths()
+{
+  char text[8];
+  char expected[24];
+
+  for (long tenthsValue = -999; tenthsValue <= 9999; tenthsValue++)
+  {
+    for (int offset = -3; offset <= 3; offset++)
+    {
+      q16_16_t value = (q16_16_t)lround(tenthsValue * 6553.6) + offset * 1000;
+      double exact = fabs(toDouble(value)) * 10;
+      long rounded = (long)floor(exact + 0.5);
+
+      snprintf(expected, sizeof(expected), "%s%ld.%ld", (value < 0 && rounded != 0) ? "-" : "", rounded / 10, rounded % 10);
+      CHECK_STR(formatTenths(text, value), expected);
+    }
+  }
+  CHECK_STR(formatTenths(text, Q16_16(-0.04)), "0.0");
+  CHECK_STR(formatTenths(text, Q16_16(-12.35)), "-12.4");
+}
+
+// ----------------------------------------------------------------------------------------------------
+int main()
+{
+  static const Scenario scenarios[] = {
+    { "qmul/qdiv/qsqrt/qlog2", arithmetic },
+    { "celsiusToFahrenheit", conversions },
+    { "computeHeatIndex", heatIndex },
+    { "computeDewPoint", dewPoint },
+    { "formatTenths", tenths },
+  };
+
+  return runScenarios(scenarios, sizeof(scenarios) / sizeof(scenarios[0]));
+}
@@ -0,0 +1,282 @@
+// The v1.0 clock's pomodoro statistics (SessionStats.h) on the session log on
+// an AT24C32 model: a hand-worked week and month, and every query checked
+// against a brute-force count over the log as thousands of sessions close,
+// with resets that rebuild the summaries from what the log kept.
+
+#include "At24c32Model.h"
+#include "SessionStats.h"
+#include "BcdTime.h"
+#include "Check.h"
+#include "Scenario.h"
+#include <random>
+#include <map>
+#include <vector>
+
+static At24c32Model eeprom;
+static std::mt19937 rng(5);
+
+// ----------------------------------------------------------------------------------------------------
+static uint32_t random(uint32_t n)
+{
+  return rng() % n;
+}
+
+// ----------------------------------------------------------------------------------------------------
+static unsigned int dayNumber(byte year, byte month, byte date)
+{
+  BcdTime t = { 0, 0, 0, 1, binToBcd(date), binToBcd(month), binToBcd(year) };
+
+  return bcdDayNumber(&t);
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Closes a session that started minute minutes into day.
+static bool closeSession(unsigned int day, unsigned int minute, uint16_t duration, byte phase, byte flags)
+{
+  SessionRecord record = { (uint32_t)day * 86400 + minute * 60, duration, phase, flags };
+
+  return sessionClose(&record);
+}
+
+// ----------------------------------------------------------------------------------------------------
+static std::vector<SessionRecord> readAll()
+{
+  std::vector<SessionRecord> all;
+  SessionCursor cursor;
+  SessionRecord record;
+
+  sessionLogSeek(&cursor, 0);
+  while (sessionLogNext(&cursor, &record))
+  {
+    all.push_back(record);
+  }
+  return all;
+}
+
+// ----------------------------------------------------------------------------------------------------
+static unsigned int firstDay(byte range, unsigned int today)
+{
+  BcdTime t;
+
+  if (range == STATS_WEEK)
+  {
+    // Day 0, 1 Jan 2000, was a Saturday
+    return today - (today + 5) % 7;
+  }
+  if (range == STATS_MONTH)
+  {
+    bcdFromDayNumber(&t, today);
+    return today - bcdToBin(t.date) + 1;
+  }
+  return today;
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Every query for today, against counts over history, the sessions the log
+// holds. Days more than STATS_DAYS before the newest have left the table.
+static void checkQueries(const std::vector<SessionRecord> &history, unsigned int today)
+{
+  std::map<unsigned int, unsigned int> minutes;
+  std::map<unsigned int, unsigned int> completed;
+  unsigned int lastDay = 0;
+
+  for (size_t i = 0; i < history.size(); i++)
+  {
+    unsigned int day = history[i].start / 86400;
+
+    if (history[i].phase != SESSION_FOCUS)
+    {
+      continue;
+    }
+    minutes[day] += (history[i].duration + 30) / 60;
+    if (!(history[i].flags & SESSION_INTERRUPTED))
+    {
+      completed[day]++;
+    }
+    if (day > lastDay)
+    {
+      lastDay = day;
+    }
+  }
+
+  for (byte range = STATS_TODAY; range <= STATS_MONTH; range++)
+  {
+    unsigned int sum = 0, count = 0, best = 0, bestDay = 0, run = 0, longest = 0;
+
+    for (unsigned int day = firstDay(range, today); day <= today; day++)
+    {
+      bool kept = day <= lastDay && lastDay - day < STATS_DAYS;
+      unsigned int m = kept ? minutes[day] : 0;
+      unsigned int c = kept ? completed[day] : 0;
+
+      sum += m;
+      count += c;
+      if (m > best)
+      {
+        best = m;
+        bestDay = day;
+      }
+      run = c ? run + 1 : 0;
+      if (run > longest)
+      {
+        longest = run;
+      }
+    }
+
+    unsigned int day = 0;
+
+    CHECK_EQ(statsFocusMinutes(range, today), sum);
+    CHECK_EQ(statsSessions(range, today), count);
+    CHECK_EQ(statsBestDay(range, today, &day), best);
+    if (best != 0)
+    {
+      CHECK_EQ(day, bestDay);
+    }
+    CHECK_EQ(statsStreak(range, today), longest);
+  }
+
+  // The running streaks see the whole log
+  unsigned int run = 0, longest = 0, previous = 0;
+
+  for (std::map<unsigned int, unsigned int>::iterator i = completed.begin(); i != completed.end(); i++)
+  {
+    if (i->second == 0)
+    {
+      continue;
+    }
+    run = (run != 0 && i->first == previous + 1) ? run + 1 : 1;
+    previous = i->first;
+    if (run > longest)
+    {
+      longest = run;
+    }
+  }
+  CHECK_EQ(statsBestStreak(), longest);
+  CHECK_EQ(statsCurrentStreak(today), (run != 0 && previous + 1 >= today) ? run : 0);
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Thu 29 Feb to Mon 4 Mar 2024, worked out by hand.
+static void calendar()
+{
+  unsigned int monday = dayNumber(24, 3, 4);
+
+  CHECK(sessionLogBegin());
+  statsBegin();
+  CHECK_EQ(statsFocusMinutes(STATS_MONTH, monday), 0);
+  CHECK_EQ(statsCurrentStreak(monday), 0);
+
+  CHECK(closeSession(monday - 4, 600, 1500, SESSION_FOCUS, 0));
+  CHECK(closeSession(monday - 3, 600, 1500, SESSION_FOCUS, 0));
+  CHECK(closeSession(monday - 3, 630, 300, SESSION_SHORT_BREAK, 0));
+  CHECK(closeSession(monday - 2, 600, 610, SESSION_FOCUS, SESSION_INTERRUPTED));
+  CHECK(closeSession(monday - 1, 600, 1500, SESSION_FOCUS, 0));
+  CHECK(closeSession(monday, 600, 1500, SESSION_FOCUS, 0));
+  CHECK(closeSession(monday, 660, 1500, SESSION_FOCUS, 0));
+
+  // Out of order: refused by the log, and not counted
+  CHECK(!closeSession(monday, 0, 1500, SESSION_FOCUS, 0));
+
+  CHECK_EQ(statsFocusMinutes(STATS_TODAY, monday), 50);
+  CHECK_EQ(statsSessions(STATS_TODAY, monday), 2);
+
+  // The week starts today
+  CHECK_EQ(statsFocusMinutes(STATS_WEEK, monday), 50);
+  CHECK_EQ(statsStreak(STATS_WEEK, monday), 1);
+
+  // The month from Fri 1 Mar: the interrupted 10 minutes on the 2nd count, the break does not
+  unsigned int day = 0;
+
+  CHECK_EQ(statsFocusMinutes(STATS_MONTH, monday), 25 + 10 + 25 + 50);
+  CHECK_EQ(statsSessions(STATS_MONTH, monday), 4);
+  CHECK_EQ(statsBestDay(STATS_MONTH, monday, &day), 50);
+  CHECK_EQ(day, monday);
+  CHECK_EQ(statsStreak(STATS_MONTH, monday), 2);
+
+  // 29 Feb and 1 Mar, then 3 and 4 Mar; the 2nd was only interrupted
+  CHECK_EQ(statsBestStreak(), 2);
+  CHECK_EQ(statsCurrentStreak(monday), 2);
+  CHECK_EQ(statsCurrentStreak(monday + 1), 2);
+  CHECK_EQ(statsCurrentStreak(monday + 2), 0);
+
+  // The same after a reset, from the log
+  CHECK(sessionLogFlush());
+  CHECK(sessionLogBegin());
+  statsBegin();
+  checkQueries(readAll(), monday);
+  CHECK_EQ(statsFocusMinutes(STATS_MONTH, monday), 110);
+  CHECK_EQ(eeprom.errors, 0);
+}
+
+// ----------------------------------------------------------------------------------------------------
+// 4000 sessions over a couple of years, days off now and then, closed with
+// sessionClose(). Now and then every query is checked for a day up to two
+// after the newest session, and the clock is reset, which loses the sessions
+// not flushed yet, and rebuilds the summaries from the log.
+static void queries()
+{
+  std::vector<SessionRecord> history;
+  uint32_t t = 8000UL * 86400 + 8 * 3600;
+  unsigned int checks = 0;
+  unsigned int resets = 0;
+
+  CHECK(sessionLogBegin());
+  statsBegin();
+  checkQueries(history, 8000);
+
+  for (unsigned int i = 0; i < 4000; i++)
+  {
+    SessionRecord record = { t, 1500, (byte)random(3), 0 };
+
+    if (record.phase != SESSION_FOCUS)
+    {
+      record.duration = 300;
+    }
+    else if (random(10) == 0)
+    {
+      record.duration = 60 + random(1400);
+      record.flags = SESSION_INTERRUPTED;
+    }
+    CHECK(sessionClose(&record));
+    history.push_back(record);
+
+    t += record.duration + random(60);
+    if (random(12) == 0)
+    {
+      t += 86400UL * random(3) + random(40000);
+    }
+
+    if (random(10) == 0)
+    {
+      checkQueries(history, t / 86400 + random(3));
+      checks++;
+    }
+    if (random(300) == 0)
+    {
+      if (random(2))
+      {
+        CHECK(sessionLogFlush());
+      }
+      CHECK(sessionLogBegin());
+      statsBegin();
+      history = readAll();
+      checkQueries(history, t / 86400);
+      resets++;
+    }
+  }
+  CHECK(checks > 300);
+  CHECK(resets > 5);
+  CHECK_EQ(sessionLogPages(), SESSION_LOG_PAGES);
+  CHECK_EQ(eeprom.errors, 0);
+}
+
+// ----------------------------------------------------------------------------------------------------
+int main()
+{
+  static const Scenario scenarios[] = {
+    { "calendar", calendar },
+    { "queries", queries },
+  };
+
+  return runScenarios(scenarios, sizeof(scenarios) / sizeof(scenarios[0]));
+}
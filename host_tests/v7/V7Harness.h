@@ -0,0 +1,146 @@
+#ifndef V7HARNESS_H_
+#define V7HARNESS_H_
+
+// Runs the v7 clock sketch on the TimeWarp virtual clock (see TimeWarp.h).
+//
+// Include this after the sketch, which is built with TIME_WARP defined. Each
+// loop() ends in warpStep(), which jumps to the sketch's next deadline; the
+// harness adds its own, the next step of the script and, while a button is
+// held or settling, every BUTTON_DEBOUNCE ms so the debouncer and the auto
+// repeat see it. Runs of
+// weeks take a few hundred thousand loops.
+//
+// The LCD is decoded from the port pins by an HD44780 model, and the Timer1
+// interrupt that feeds it runs as soon as output is queued (see Arduino.h),
+// so line() shows what the display shows after each loop.
+
+#include "Hd44780Model.h"
+#include "Check.h"
+#include "Scenario.h"
+
+// RS on PB0, E on PD7, D4-D7 on PD6-PD3, as LcdDriver is wired
+static const Hd44780Pins v7LcdPins = { &PORTB, 0, &PORTD, 7, &PORTD, { 6, 5, 4, 3 } };
+static Hd44780Model v7Lcd(v7LcdPins);
+
+// Settings in the EEPROM layout of the sketch, see EEPROM_AH...
+typedef struct V7Settings {
+  byte alarmHour;
+  byte alarmMinute;
+  byte alarmOn;
+  byte style;
+  int birthYear;
+  byte birthMonth;
+  byte birthDay;
+} V7Settings;
+
+static unsigned long v7Loops = 0;
+static bool v7Held = false;                 // a button is down: stepping at debounce pace
+static unsigned long v7SettleUntil = 0;     // and after it went up, until then
+static time_t v7LoopTime = 0;               // calendar time the last loop ran at
+static void (*v7Observer)() = NULL;         // called after every loop
+
+// ----------------------------------------------------------------------------------------------------
+static time_t v7Time(int year, byte month, byte day, byte hour, byte minute, byte second)
+{
+  tmElements_t tm;
+
+  tm.Year = CalendarYrToTm(year);
+  tm.Month = month;
+  tm.Day = day;
+  tm.Hour = hour;
+  tm.Minute = minute;
+  tm.Second = second;
+  return makeTime(tm);
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Powers the clock up at start, with the settings in its EEPROM.
+static void v7Boot(time_t start, const V7Settings &settings)
+{
+  hostReset();
+  memset(EEPROM.data, 0xFF, sizeof(EEPROM.data));
+  EEPROM.data[EEPROM_AH] = settings.alarmHour;
+  EEPROM.data[EEPROM_AM] = settings.alarmMinute;
+  EEPROM.data[EEPROM_AO] = settings.alarmOn;
+  EEPROM.data[EEPROM_CS] = settings.style;
+  EEPROM.data[EEPROM_BY + 0] = settings.birthYear >> 8;
+  EEPROM.data[EEPROM_BY + 1] = settings.birthYear & 0xFF;
+  EEPROM.data[EEPROM_BM] = settings.birthMonth;
+  EEPROM.data[EEPROM_BD] = settings.birthDay;
+  EEPROM.writes = 0;
+
+  v7Lcd.attach();
+  hostTimer1Vector = hostTimer1CompaVect;
+  warpBegin(start);
+  setup();
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Runs the sketch up to at (virtual millis), the last loop at at itself, so
+// the display shows that moment. That loop only steps the clock on by 1 ms.
+static void v7RunUntilMillis(unsigned long at)
+{
+  for (bool last = false; !last; )
+  {
+    last = warpMillis() >= at;
+    warpDeadline(last ? warpMillis() + 1 : at);
+    if (v7Held || warpMillis() < v7SettleUntil)
+    {
+      warpDeadline(warpMillis() + BUTTON_DEBOUNCE);
+    }
+    v7LoopTime = warpNow();
+    loop();                                 // ends in warpStep(), so warpNow() is already the next loop's
+    v7Loops++;
+    if (v7Observer != NULL)
+    {
+      v7Observer();
+    }
+  }
+}
+
+// ----------------------------------------------------------------------------------------------------
+static void v7Run(unsigned long ms)
+{
+  v7RunUntilMillis(warpMillis() + ms);
+}
+
+// ----------------------------------------------------------------------------------------------------
+static void v7RunUntil(time_t t)
+{
+  if (t > warpNow())
+  {
+    v7RunUntilMillis(warpMillis() + (unsigned long)(t - warpNow()) * 1000 - warpMillis() % 1000);
+  }
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Holds a button (BTN_SET...) down or lets it go.
+static void v7Button(byte pin, bool down)
+{
+  hostPins[pin].input = down ? LOW : HIGH;
+  v7Held = down;
+  v7SettleUntil = warpMillis() + 4 * BUTTON_DEBOUNCE;
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Presses a button for hold ms, then gives the clock time to see it released.
+static void v7Press(byte pin, unsigned long hold = 100)
+{
+  v7Button(pin, true);
+  v7Run(hold);
+  v7Button(pin, false);
+  v7Run(4 * BUTTON_DEBOUNCE);
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Text from column first on a display row.
+static const char *v7Text(byte row, byte first = 0, byte length = 16)
+{
+  static char text[17];
+
+  memcpy(text, v7Lcd.line(row) + first, length);
+  text[length] = '\0';
+  return text;
+}
+
+#endif
@@ -0,0 +1,315 @@
+// Multi-week scenarios for the v7 clock, run on the virtual clock and checked
+// against what the display shows and what the EEPROM holds.
+
+#include "v7_sketch.cpp"      // the sketch, made by ino2cpp.sh with TIME_WARP defined
+#include "V7Harness.h"
+
+#define MAX_RINGS 64
+
+typedef struct Ring {
+  time_t start;
+  time_t stop;
+  unsigned long tones;
+} Ring;
+
+static Ring rings[MAX_RINGS];
+static byte ringCount = 0;
+static bool wasRinging = false;
+static unsigned long tonesBefore = 0;
+
+// ----------------------------------------------------------------------------------------------------
+// Observer that logs when the alarm starts and stops, and the notes played in between.
+static void watchAlarm()
+{
+  bool ringing = mode.current() == STATE_RINGING;
+
+  if (ringing && !wasRinging && ringCount < MAX_RINGS)
+  {
+    rings[ringCount].start = v7LoopTime;
+    tonesBefore = hostTones;
+  }
+  if (!ringing && wasRinging && ringCount < MAX_RINGS)
+  {
+    rings[ringCount].stop = v7LoopTime;
+    rings[ringCount].tones = hostTones - tonesBefore;
+    ringCount++;
+  }
+  wasRinging = ringing;
+}
+
+// ----------------------------------------------------------------------------------------------------
+// An alarm at 06:57 for three weeks over the end of February in a leap year.
+// It has to stop at 07:02, past the hour, and keep playing until then.
+static void alarmEveryMorning()
+{
+  const V7Settings settings = { 6, 57, 1, STANDARD, 1990, 5, 15 };
+  const time_t start = v7Time(2024, 2, 20, 22, 0, 0);
+
+  v7Observer = watchAlarm;
+  v7Boot(start, settings);
+  v7RunUntil(v7Time(2024, 2, 29, 6, 58, 31));
+  CHECK_STR(v7Text(0), "06:58:31 | 06:57");
+  CHECK_STR(v7Text(1), "29/02/24 | ALARM");
+  CHECK_EQ(mode.current(), STATE_RINGING);
+
+  v7RunUntil(v7Time(2024, 3, 1, 12, 0, 0));
+  CHECK_STR(v7Text(1, 0, 8), "01/03/24");
+
+  v7RunUntil(start + 21 * SECS_PER_DAY);
+  CHECK_EQ(ringCount, 21);
+  for (byte i = 0; i < ringCount; i++)
+  {
+    time_t morning = previousMidnight(start) + (i + 1) * SECS_PER_DAY;
+
+    CHECK_EQ(rings[i].start, morning + 6 * SECS_PER_HOUR + 57 * SECS_PER_MIN);
+    CHECK_EQ(rings[i].stop, morning + 7 * SECS_PER_HOUR + 2 * SECS_PER_MIN);
+    // A note every 301 ms or so for five minutes
+    CHECK(rings[i].tones > 900 && rings[i].tones < 1000);
+  }
+
+  // Running the clock writes nothing to the EEPROM
+  CHECK_EQ(EEPROM.writes, 0);
+
+  // The first press only wakes the backlight, the second switches the alarm off
+  v7Press(BTN_ALARM);
+  CHECK_EQ(alarmON, true);
+  v7Press(BTN_ALARM);
+  CHECK_EQ(alarmON, false);
+  CHECK_EQ(EEPROM.read(EEPROM_AO), 0);
+  CHECK_EQ(EEPROM.writes, 1);
+
+  v7RunUntil(start + 28 * SECS_PER_DAY + 1);
+  CHECK_EQ(ringCount, 21);
+  CHECK_STR(v7Text(1, 11, 5), "     ");
+}
+
+// ----------------------------------------------------------------------------------------------------
+// An alarm at 23:58 rings into the next day, here the next year, and stops at 00:03.
+static void alarmOverMidnight()
+{
+  const V7Settings settings = { 23, 58, 1, STANDARD, 1990, 5, 15 };
+
+  v7Observer = watchAlarm;
+  v7Boot(v7Time(2023, 12, 29, 12, 0, 0), settings);
+  v7RunUntil(v7Time(2024, 1, 1, 0, 1, 0));
+  CHECK_STR(v7Text(0), "00:01:00 | 23:58");
+  CHECK_STR(v7Text(1, 0, 8), "01/01/24");
+  CHECK_EQ(mode.current(), STATE_RINGING);
+
+  v7RunUntil(v7Time(2024, 1, 3, 12, 0, 0));
+  CHECK_EQ(ringCount, 5);
+  CHECK_EQ(rings[2].start, v7Time(2023, 12, 31, 23, 58, 0));
+  CHECK_EQ(rings[2].stop, v7Time(2024, 1, 1, 0, 3, 0));
+  CHECK_EQ(rings[4].stop, v7Time(2024, 1, 3, 0, 3, 0));
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Six tilts stop the alarm, and it still rings the next morning. The backlight
+// goes off BACKLIGHT_TIMEOUT after the last press.
+static void shakeToStop()
+{
+  const V7Settings settings = { 7, 0, 1, STANDARD, 1990, 5, 15 };
+
+  v7Observer = watchAlarm;
+  v7Boot(v7Time(2024, 6, 3, 6, 0, 0), settings);
+  v7RunUntil(v7Time(2024, 6, 3, 7, 0, 10));
+  CHECK_EQ(mode.current(), STATE_RINGING);
+  CHECK_EQ(hostPins[LIGHT].output, HIGH);
+
+  for (byte i = 0; i < 6; i++)
+  {
+    v7Press(BTN_TILT);
+  }
+  CHECK_EQ(ringCount, 1);
+  CHECK(rings[0].stop < v7Time(2024, 6, 3, 7, 0, 12));
+  CHECK_EQ(mode.current(), STATE_LIT);
+  CHECK_EQ(hostToneFrequency, 0);
+  CHECK(Serial.sent.find("123456") != std::string::npos);
+
+  v7Run(BACKLIGHT_TIMEOUT - 200);
+  CHECK_EQ(hostPins[LIGHT].output, HIGH);
+  v7Run(400);
+  CHECK_EQ(hostPins[LIGHT].output, LOW);
+  CHECK_EQ(mode.current(), STATE_DARK);
+
+  v7RunUntil(v7Time(2024, 6, 4, 7, 10, 0));
+  CHECK_EQ(ringCount, 2);
+  CHECK_EQ(rings[1].start, v7Time(2024, 6, 4, 7, 0, 0));
+  CHECK_EQ(rings[1].stop, v7Time(2024, 6, 4, 7, 5, 0));
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Setting the alarm through the setup screens stores it and it rings at the new time.
+static void setAlarmFromMenu()
+{
+  const V7Settings settings = { 0, 0, 0, STANDARD, 1990, 5, 15 };
+
+  v7Observer = watchAlarm;
+  v7Boot(v7Time(2024, 3, 10, 21, 0, 0), settings);
+  v7RunUntil(v7Time(2024, 3, 10, 21, 30, 0));
+
+  v7Press(BTN_SET);                       // wakes the backlight
+  v7Press(BTN_SET);
+  CHECK_STR(v7Text(0), "------SET------ ");
+  v7Run(2100);
+  CHECK_EQ(mode.current(), TIME_HOUR);
+
+  for (byte i = 0; i < 8; i++)
+  {
+    v7Press(BTN_SET);
+  }
+  CHECK_EQ(mode.current(), ALARM_HOUR);
+  CHECK_STR(v7Text(0), " SET ALARM TIME ");
+  for (byte i = 0; i < 6; i++)
+  {
+    v7Press(BTN_ADJUST);
+  }
+  v7Press(BTN_SET);
+  CHECK_EQ(mode.current(), ALARM_MIN);
+
+  // Held, ADJUST repeats: one step for the press, then from FIELD_REPEAT_DELAY on
+  v7Press(BTN_ADJUST, 1500);
+  CHECK(AM > 5 && AM < 30);
+  while (AM != 30)
+  {
+    v7Press((AM < 30) ? BTN_ADJUST : BTN_ALARM);
+  }
+  CHECK_STR(v7Text(1), "     06 :>30    ");
+
+  v7Press(BTN_SET);
+  CHECK_STR(v7Text(0, 0, 10), "Saving....");
+  CHECK_EQ(EEPROM.read(EEPROM_AH), 6);
+  CHECK_EQ(EEPROM.read(EEPROM_AM), 30);
+  CHECK_EQ(EEPROM.writes, 6);
+
+  v7Run(2100);
+  CHECK_EQ(mode.current(), STATE_LIT);
+  v7Press(BTN_ALARM);
+  CHECK_EQ(EEPROM.read(EEPROM_AO), 1);
+  CHECK_EQ(EEPROM.writes, 7);
+
+  // Setting the clock dropped the seconds it had when the screens were entered
+  v7RunUntil(v7Time(2024, 3, 12, 12, 0, 0));
+  CHECK_EQ(ringCount, 2);
+  CHECK_EQ(rings[0].start, v7Time(2024, 3, 11, 6, 30, 0));
+  CHECK_EQ(rings[1].stop, v7Time(2024, 3, 12, 6, 35, 0));
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Two weeks of a room that warms by day, drifts over the weeks and gets humid
+// enough to clip. Every reading is shown, rounded and clipped to two digits.
+
+static double lastTemperature;
+static double lastHumidity;
+
+static int roomSample(double *temperature, double *humidity)
+{
+  double days = (double)(warpNow() - v7Time(2024, 4, 1, 0, 0, 0)) / SECS_PER_DAY;
+
+  *temperature = 18.0 + 4.0 * sin(TWO_PI * days) + 0.5 * days;
+  *humidity = 70.0 + 29.7 * sin(TWO_PI * days / 3.5);
+  lastTemperature = *temperature;
+  lastHumidity = *humidity;
+  return DHTLIB_OK;
+}
+
+static void sensorWeeks()
+{
+  const V7Settings settings = { 7, 0, 0, THERMO, 1990, 5, 15 };
+  const time_t start = v7Time(2024, 4, 1, 0, 0, 0);
+
+  hostDhtSample = roomSample;
+  v7Boot(start, settings);
+
+  unsigned long readsBefore = hostDhtReads;
+  byte clipped = 0;
+
+  for (time_t t = start + SECS_PER_HOUR; t <= start + 14 * SECS_PER_DAY; t += 5 * SECS_PER_HOUR + 7 * SECS_PER_MIN)
+  {
+    v7RunUntil(t);
+
+    int temperature = min(round(lastTemperature), 99);
+    int humidity = min(round(lastHumidity), 99);
+    char text[8];
+
+    clipped += (lastHumidity >= 99.5) ? 1 : 0;
+    snprintf(text, sizeof(text), "%2dC ", temperature);
+    CHECK_STR(v7Text(0, 8, 4), text);
+    snprintf(text, sizeof(text), "%2d%%", humidity);
+    CHECK_STR(v7Text(0, 13, 3), text);
+    CHECK_EQ(v7Text(0)[7], THERMOMETER_CHAR);
+    CHECK_EQ(v7Text(0)[12], DROPLET_CHAR);
+  }
+  CHECK(clipped > 0);
+
+  // One read per DHT_UPDATE_INTERVAL, none skipped by the jumps
+  unsigned long expected = (warpNow() - start) * 1000 / DHT_UPDATE_INTERVAL;
+
+  CHECK(hostDhtReads - readsBefore >= expected - 1 && hostDhtReads - readsBefore <= expected + 1);
+  CHECK_EQ(EEPROM.writes, 0);
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Days since 1 March of year 0 in the proleptic Gregorian calendar, counted in
+// 400 year eras. makeTime() cannot be the reference: tmElements_t.Year is a
+// byte from 1970, so it cannot hold the birth years before 1970.
+static long civilDays(long y, int m, int d)
+{
+  y -= (m <= 2) ? 1 : 0;
+
+  long era = y / 400;
+  long yearOfEra = y - era * 400;
+  long dayOfYear = (153 * (m + ((m > 2) ? -3 : 9)) + 2) / 5 + d - 1;
+
+  return era * 146097 + yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+}
+
+// ----------------------------------------------------------------------------------------------------
+static long referenceDays(int y1, int m1, int d1, int y2, int m2, int d2)
+{
+  return civilDays(y1, m1, d1) - civilDays(y2, m2, d2);
+}
+
+// getDifference() for the biorhythms, over every birth year the setup screen
+// allows and leap days on both sides. On the AVR an int is 16 bits, so the
+// day counts from year 0 and the up to 72000 days between 1900 and 2099 need
+// a long.
+static void biorhythmDays()
+{
+  const V7Settings settings = { 7, 0, 0, BIO, 1990, 5, 15 };
+
+  v7Boot(v7Time(2024, 2, 29, 8, 0, 0), settings);
+  v7Run(1000);
+  CHECK_EQ(sizeof(getDifference(2024, 2, 29, 1900, 1, 1)), sizeof(long));
+
+  for (int birthYear = 1900; birthYear <= 2099; birthYear += 7)
+  {
+    for (int year = 2000; year <= 2099; year += 3)
+    {
+      CHECK_EQ(getDifference(year, 2, 29, birthYear, 3, 1), referenceDays(year, 2, 28, birthYear, 3, 1) + 1);
+      CHECK_EQ(getDifference(year, 12, 31, birthYear, 2, 28), referenceDays(year, 12, 31, birthYear, 2, 28));
+      CHECK_EQ(getDifference(year, 1, 1, birthYear, 12, 31), referenceDays(year, 1, 1, birthYear, 12, 31));
+    }
+  }
+  CHECK_EQ(getDifference(2099, 12, 31, 1900, 1, 1), 73048);
+
+  // The face draws from the same count: physical is sin(2 pi days / 23)
+  long days = getDifference(2024, 2, 29, 1990, 5, 15);
+
+  CHECK_EQ(getBioRhythmValue(23), (int)(8 * sin((TWO_PI * days) / 23) + 8));
+}
+
+// ----------------------------------------------------------------------------------------------------
+int main()
+{
+  static const Scenario scenarios[] = {
+    { "alarmEveryMorning", alarmEveryMorning },
+    { "alarmOverMidnight", alarmOverMidnight },
+    { "shakeToStop", shakeToStop },
+    { "setAlarmFromMenu", setAlarmFromMenu },
+    { "sensorWeeks", sensorWeeks },
+    { "biorhythmDays", biorhythmDays },
+  };
+
+  return runScenarios(scenarios, sizeof(scenarios) / sizeof(scenarios[0]));
+}
@@ -14,6 +14,7 @@
 #include "RTClib.h"
 #include <LiquidCrystal.h>
 #include <EEPROM.h>
+#include "FieldEditor.h"
 
 //Connections and constants 
 LiquidCrystal lcd(8,7,6,5,4,3); //LCD
@@ -30,6 +31,7 @@ int melody[] = { 600, 800, 1000,1200 };
 //Variables
 int DD,MM,YY,H,M,S,set_state, adjust_state, alarm_state,AH,AM, shake_state;
 int shakeTimes=0;
+unsigned long shakeMillis = 0;
 int i =0;
 int btnCount = 0;
 String sDD;
@@ -47,6 +49,32 @@ long previousMillis = 0;
 boolean setupScreen = false;
 boolean alarmON=false;
 boolean turnItOn = false;
+
+//Setup fields, one per btnCount from 1 (see FieldEditor.h)
+const Field setupFields[] PROGMEM = {
+  { &H,  0,    23,   5,  0, 2, FIELD_WRAP },  //Hour
+  { &M,  0,    59,   10, 0, 2, FIELD_WRAP },  //Minutes
+  { &DD, 1,    31,   1,  1, 2, FIELD_WRAP },  //Day
+  { &MM, 1,    12,   6,  1, 2, FIELD_WRAP },  //Month
+  { &YY, 2000, 2099, 11, 1, 2, 0 },           //Year, stops at the ends
+  { &AH, 0,    23,   5,  1, 2, FIELD_WRAP },  //Alarm Hour
+  { &AM, 0,    59,   10, 1, 2, FIELD_WRAP },  //Alarm Minutes
+};
+FieldEditor<LiquidCrystal> editor(lcd);
+AutoRepeat stepRepeat;
+int stepDirection = 0;
+unsigned long prevStepMillis = 0;
+
+//Timed states, so the loop keeps running while a message is up or a button settles
+const byte MSG_NONE = 0;
+const byte MSG_SET = 1;         //"-TIME and DATE-", then the first field
+const byte MSG_SAVING = 2;      //"Saving....", then the clock
+const unsigned long messageTime = 2000;
+const unsigned long btnLockTime = 500;   //SET and ALARM act again this long after they last did
+byte message = MSG_NONE;
+unsigned long messageMillis = 0;
+boolean btnLocked = false;
+unsigned long btnLockMillis = 0;
    
 void setup() {
   //Init RTC and LCD library items
@@ -81,7 +109,10 @@ void setup() {
 void loop() {
   readBtns();       //Read buttons 
   getTimeDate();    //Read time and date from RTC
-  if (!setupScreen){
+  if (message != MSG_NONE){
+    endMessage();   //Leave the message up until its time is over
+  }
+  else if (!setupScreen){
     lcdPrint();     //Normanlly print the current time/date/alarm to the LCD
     if (alarmON){
      callAlarm();   // and check the alarm if set on
@@ -99,6 +130,15 @@ void readBtns(){
   set_state = digitalRead(btSet);
   adjust_state = digitalRead(btAdj);
   alarm_state = digitalRead(btAlarm);
+  if (message != MSG_NONE){
+    return;         //Nothing acts on a button while a message is up
+  }
+  if (btnLocked){
+    if (millis() - btnLockMillis < btnLockTime){
+      return;
+    }
+    btnLocked = false;
+  }
   if(!setupScreen){
     if (alarm_state==LOW){
       if (alarmON){
@@ -109,7 +149,7 @@ void readBtns(){
         alarm="ALARM";
         alarmON=true;
       }
-      delay(500);
+      lockBtns();
     }
   }
   if (set_state==LOW){
@@ -122,25 +162,53 @@ void readBtns(){
           lcd.print("------SET------");
           lcd.setCursor(0,1);
           lcd.print("-TIME and DATE-");
-          delay(2000);
-          lcd.clear();
+          showMessage(MSG_SET);
+        }
+        else{
+          setupField();
         }
     } 
     else{
+      editor.end();
       lcd.clear();
       rtc.adjust(DateTime(YY, MM, DD, H, M, 0)); //Save time and date to RTC IC
       EEPROM.write(0, AH);  //Save the alarm hours to EEPROM 0
       EEPROM.write(1, AM);  //Save the alarm minuted to EEPROM 1
       lcd.print("Saving....");
-      delay(2000);
-      lcd.clear();
-      setupScreen = false;
-      btnCount=0;
+      showMessage(MSG_SAVING);
     }
-    delay(500);
+    lockBtns();
   }
 }
 
+//SET and ALARM are ignored for btnLockTime, so one press acts once
+void lockBtns(){
+  btnLocked = true;
+  btnLockMillis = millis();
+}
+
+//Keep what is on the LCD for messageTime, then go on with endMessage()
+void showMessage(byte which){
+  message = which;
+  messageMillis = millis();
+}
+
+void endMessage(){
+  if (millis() - messageMillis < messageTime){
+    return;
+  }
+  lcd.clear();
+  if (message == MSG_SET){
+    setupField();         //On to the first field
+  }
+  else{
+    setupScreen = false;  //Saved, back to the clock
+    btnCount=0;
+  }
+  message = MSG_NONE;
+  lockBtns();
+}
+
 //Read time and date from rtc ic
 void getTimeDate(){
   if (!setupScreen){
@@ -172,217 +240,73 @@ void lcdPrint(){
   lcd.print(line2);  
 }
 
-//Setup screen
-void timeSetup(){
-  int up_state = adjust_state;
-  int down_state = alarm_state;
-  if(btnCount<=5){
-    if (btnCount==1){         //Set Hour
-      lcd.setCursor(4,0);
-      lcd.print(">"); 
-      if (up_state == LOW){   //Up button +
-        if (H<23){
-          H++;
-        }
-        else {
-          H=0;
-        }
-        delay(350);
-      }
-      if (down_state == LOW){ //Down button -
-        if (H>0){
-          H--;
-        }
-        else {
-          H=23;
-        }
-        delay(350);
-      }
-    }
-    else if (btnCount==2){      //Set  Minutes
-      lcd.setCursor(4,0);
-      lcd.print(" ");
-      lcd.setCursor(9,0);
-      lcd.print(">");
-      if (up_state == LOW){
-        if (M<59){
-          M++;
-        }
-        else {
-          M=0;
-        }
-        delay(350);
-      }
-      if (down_state == LOW){
-        if (M>0){
-          M--;
-        }
-        else {
-          M=59;
-        }
-        delay(350);
-      }
-    }
-    else if (btnCount==3){      //Set Day
-      lcd.setCursor(9,0);
-      lcd.print(" ");
-      lcd.setCursor(0,1);
-      lcd.print(">");
-      if (up_state == LOW){
-        if (DD<31){
-          DD++;
-        }
-        else {
-          DD=1;
-        }
-        delay(350);
-      }
-      if (down_state == LOW){
-        if (DD>1){
-          DD--;
-        }
-        else {
-          DD=31;
-        }
-        delay(350);
-      }
-    }
-    else if (btnCount==4){      //Set Month
-      lcd.setCursor(0,1);
-      lcd.print(" ");
-      lcd.setCursor(5,1);
-      lcd.print(">");
-      if (up_state == LOW){
-        if (MM<12){
-          MM++;
-        }
-        else {
-          MM=1;
-        }
-        delay(350);
-      }
-      if (down_state == LOW){
-        if (MM>1){
-          MM--;
-        }
-        else {
-          MM=12;
-        }
-        delay(350);
-      }
-    }
-    else if (btnCount==5){      //Set Year
-      lcd.setCursor(5,1);
-      lcd.print(" ");
-      lcd.setCursor(10,1);
-      lcd.print(">");
-      if (up_state == LOW){
-        if (YY<2999){
-          YY++;
-        }
-        else {
-          YY=2000;
-        }
-        delay(350);
-      }
-      if (down_state == LOW){
-        if (YY>2018){
-          YY--;
-        }
-        else {
-          YY=2999;
-        }
-        delay(350);
-      }
-    }
-    lcd.setCursor(5,0);
-    lcd.print(sH);
+//Show the screen of the field btnCount selects and start editing it
+void setupField(){
+  editor.end();
+  if (btnCount==1){           //Time and date
     lcd.setCursor(8,0);
     lcd.print(":");
-    lcd.setCursor(10,0);
-    lcd.print(sM);
-    lcd.setCursor(1,1);
-    lcd.print(sDD);
     lcd.setCursor(4,1);
     lcd.print("/");
-    lcd.setCursor(6,1);
-    lcd.print(sMM);
     lcd.setCursor(9,1);
     lcd.print("/");
-    lcd.setCursor(11,1);
-    lcd.print(sYY);
+    for (int f=0; f<5; f++){
+      editor.show(&setupFields[f]);
+    }
   }
-  else{
-    setAlarmTime();
+  else if (btnCount==6){      //Alarm time
+    lcd.clear();
+    lcd.setCursor(0,0);
+    lcd.print("SET  ALARM TIME");
+    lcd.setCursor(8,1);
+    lcd.print(":");
+    editor.show(&setupFields[5]);
+    editor.show(&setupFields[6]);
   }
+  editor.begin(&setupFields[btnCount-1]);
 }
 
-//Set alarm time
-void setAlarmTime(){
-  int up_state = adjust_state;
-  int down_state = alarm_state;
-  String line2;
-  lcd.setCursor(0,0);
-  lcd.print("SET  ALARM TIME");
-  if (btnCount==6){             //Set alarm Hour
-    if (up_state == LOW){
-      if (AH<23){
-        AH++;
-      }
-      else {
-        AH=0;
-      }
-      delay(350);
-    }
-    if (down_state == LOW){
-      if (AH>0){
-        AH--;
-      }
-      else {
-        AH=23;
-      }
-      delay(350);
-    }
-    line2 = "    >"+aH+" : "+aM+"    ";
+//Setup screen: up and down step the field once, then faster and faster while held
+void timeSetup(){
+  unsigned long currentMillis = millis();
+  if (currentMillis - prevStepMillis < 20){   //Sample slower than the buttons bounce
+    return;
   }
-  else if (btnCount==7){        //Set alarm Minutes
-    if (up_state == LOW){
-      if (AM<59){
-        AM++;
-      }
-      else {
-        AM=0;
-      }
-      delay(350);
+  prevStepMillis = currentMillis;
+  int direction = 0;
+  if (adjust_state == LOW){         //Up button +
+    direction = 1;
+  }
+  else if (alarm_state == LOW){     //Down button -
+    direction = -1;
+  }
+  if (direction != stepDirection){
+    stepDirection = direction;
+    if (direction != 0){
+      editor.step(direction);
+      stepRepeat.press(currentMillis);
     }
-    if (down_state == LOW){
-      if (AM>0){
-        AM--;
-      }
-      else {
-        AM=59;
-      }
-      delay(350);
+    else{
+      stepRepeat.release();
     }
-    line2 = "     "+aH+" :>"+aM+"    ";    
   }
-  lcd.setCursor(0,1);
-  lcd.print(line2);
+  else if (direction != 0 && stepRepeat.due(currentMillis)){
+    editor.step(direction);
+  }
 }
 
 void callAlarm(){
   if (aM==sM && aH==sH && S>=0 && S<=2){
     turnItOn = true;
   }
-  if(alarm_state==LOW || shakeTimes>=6 || (M==(AM+5))){
+  if(alarm_state==LOW || shakeTimes>=6 || (M==((AM+5) % 60))){
     turnItOn = false;
-    alarmON=true;
-    delay(500);
+    alarmON=true;   //readBtns() has locked the buttons if ALARM stopped it
   } 
-  if(analogRead(shakeSensor)>200){
+  if(analogRead(shakeSensor)>200 && millis() - shakeMillis >= 50){   //One shake per 50ms
+    shakeMillis = millis();
     shakeTimes++;
     Serial.print(shakeTimes);
-    delay(50);
   }
   if (turnItOn){
     unsigned long currentMillis = millis();
@@ -0,0 +1,177 @@
+#ifndef FIELDEDITOR_H_
+#define FIELDEDITOR_H_
+
+// Editing a number on a character display without waiting.
+//
+// A Field says where a value lives, its range and where it is drawn. The
+// sketch keeps its fields in a PROGMEM table and hands one at a time to a
+// FieldEditor, which puts a '>' in the cell before the value and redraws the
+// value after each step(). Stepping past either end wraps round or stops,
+// depending on FIELD_WRAP. Values are shown zero padded to the field width;
+// a year in a two digit field shows as "26".
+//
+// AutoRepeat turns a held button into repeats: the first after
+// FIELD_REPEAT_DELAY ms, then every FIELD_REPEAT_START ms, a quarter quicker
+// each time down to FIELD_REPEAT_MIN ms. Poll due() from whatever already
+// samples the buttons; nothing here calls delay().
+//
+//   const Field hourField PROGMEM = { &hour, 0, 23, 5, 0, 2, FIELD_WRAP };
+//   FieldEditor<LiquidCrystal> editor(lcd);
+//
+//   editor.begin(&hourField);   // on entering the screen
+//   editor.step(+1);            // on a press and on every repeat
+//   editor.end();               // on leaving it
+
+#include "Arduino.h"
+
+#define FIELD_WRAP          0x01    // past the maximum comes the minimum and back
+
+#define FIELD_MAX_WIDTH     5
+
+#define FIELD_REPEAT_DELAY  500     // ms
+#define FIELD_REPEAT_START  200
+#define FIELD_REPEAT_MIN    40
+
+typedef struct Field {
+  int *value;
+  int minimum;          // values are not negative
+  int maximum;
+  byte col;             // first digit; the cursor goes in the cell before it
+  byte row;
+  byte width;           // digits shown, up to FIELD_MAX_WIDTH
+  byte flags;
+} Field;
+
+class AutoRepeat
+{
+  public:
+    AutoRepeat() : held(false)
+    {
+    }
+
+    // The button went down; the press itself is the caller's first step.
+    void press(unsigned long now)
+    {
+      held = true;
+      last = now;
+      wait = FIELD_REPEAT_DELAY;
+      interval = FIELD_REPEAT_START;
+    }
+
+    void release()
+    {
+      held = false;
+    }
+
+    // True once per repeat while the button is held.
+    bool due(unsigned long now)
+    {
+      if (!held || now - last < wait)
+      {
+        return false;
+      }
+      last = now;
+      wait = interval;
+      interval -= interval / 4;
+      if (interval < FIELD_REPEAT_MIN)
+      {
+        interval = FIELD_REPEAT_MIN;
+      }
+      return true;
+    }
+
+  private:
+    bool held;
+    unsigned long last;
+    unsigned int wait;
+    unsigned int interval;
+};
+
+template <class Display>
+class FieldEditor
+{
+  public:
+    FieldEditor(Display &display) : display(display), editing(false)
+    {
+    }
+
+    // Starts editing a PROGMEM field: shows the cursor and the value.
+    void begin(const Field *f)
+    {
+      memcpy_P(&field, f, sizeof(Field));
+      editing = true;
+      marker('>');
+      draw(field);
+    }
+
+    // Stops editing and removes the cursor.
+    void end()
+    {
+      if (editing)
+      {
+        marker(' ');
+        editing = false;
+      }
+    }
+
+    // Moves the value by delta, wrapping or stopping at the ends.
+    void step(int delta)
+    {
+      if (!editing)
+      {
+        return;
+      }
+
+      int value = *field.value + delta;
+      if (value > field.maximum)
+      {
+        value = (field.flags & FIELD_WRAP) ? field.minimum : field.maximum;
+      }
+      else if (value < field.minimum)
+      {
+        value = (field.flags & FIELD_WRAP) ? field.maximum : field.minimum;
+      }
+      if (value != *field.value)
+      {
+        *field.value = value;
+        draw(field);
+      }
+    }
+
+    // Draws the value of a PROGMEM field without editing it.
+    void show(const Field *f)
+    {
+      Field other;
+
+      memcpy_P(&other, f, sizeof(Field));
+      draw(other);
+    }
+
+  private:
+    void marker(char c)
+    {
+      display.setCursor(field.col - 1, field.row);
+      display.print(c);
+    }
+
+    void draw(const Field &f)
+    {
+      char text[FIELD_MAX_WIDTH + 1];
+      unsigned int value = *f.value;
+
+      for (byte i = f.width; i > 0; i--)
+      {
+        text[i - 1] = '0' + value % 10;
+        value /= 10;
+      }
+      text[f.width] = '\0';
+      display.setCursor(f.col, f.row);
+      display.print(text);
+    }
+
+    Display &display;
+    Field field;          // RAM copy of the one being edited
+    bool editing;
+};
+
+#endif
@@ -0,0 +1,70 @@
+#include "EventBus.h"
+
+static const Subscriber *subscriberTable = NULL;
+static byte subscriberCount = 0;
+static Event queue[EVENT_QUEUE_SIZE];
+static volatile byte queueHead = 0;
+static volatile byte queueTail = 0;
+static unsigned int dropped = 0;
+
+// ----------------------------------------------------------------------------------------------------
+void eventsBegin(const Subscriber *subscribers, byte count)
+{
+  subscriberTable = subscribers;
+  subscriberCount = count;
+  queueHead = 0;
+  queueTail = 0;
+  dropped = 0;
+}
+
+// ----------------------------------------------------------------------------------------------------
+bool eventPost(byte type, byte arg)
+{
+  uint8_t sreg = SREG;
+  bool posted = false;
+
+  cli();
+  byte next = (queueHead + 1) & (EVENT_QUEUE_SIZE - 1);
+  if (next != queueTail)
+  {
+    queue[queueHead].type = type;
+    queue[queueHead].arg = arg;
+    queueHead = next;
+    posted = true;
+  }
+  else
+  {
+    dropped++;
+  }
+  SREG = sreg;
+  return posted;
+}
+
+// ----------------------------------------------------------------------------------------------------
+void eventsDispatch()
+{
+  while (queueTail != queueHead)
+  {
+    Event event = queue[queueTail];
+    unsigned int mask = EVENT_MASK(event.type);
+
+    queueTail = (queueTail + 1) & (EVENT_QUEUE_SIZE - 1);
+
+    for (byte i = 0; i < subscriberCount; i++)
+    {
+      const Subscriber *subscriber = &subscriberTable[i];
+
+      if (pgm_read_word(&(subscriber->mask)) & mask)
+      {
+        void (*handle)(const Event *) = (void (*)(const Event *)) pgm_read_word(&(subscriber->handle));
+        handle(&event);
+      }
+    }
+  }
+}
+
+// ----------------------------------------------------------------------------------------------------
+unsigned int eventsDropped()
+{
+  return dropped;
+}
@@ -0,0 +1,56 @@
+#ifndef EVENTBUS_H_
+#define EVENTBUS_H_
+
+// Publish/subscribe between the clock's modules.
+//
+// Modules post small events (a type and a one byte argument) into a fixed
+// ring buffer, and eventsDispatch() hands each one to the subscribers whose
+// mask includes its type. Subscribers are a PROGMEM table declared by the
+// sketch, so nothing is registered at run time and nothing is allocated.
+// Handlers may post further events; they are delivered in the same
+// dispatch, after the ones already queued.
+//
+// eventPost() can be called from an interrupt.
+
+#include "Arduino.h"
+
+enum EventType
+{
+  EVENT_BUTTON_PRESSED,     // arg: button number
+  EVENT_BUTTON_RELEASED,    // arg: button number
+  EVENT_BUTTON_REPEAT,      // arg: button number, while it is held
+  EVENT_SECOND_TICK,        // arg: the new second
+  EVENT_FRAME_TICK,         // for animated faces
+  EVENT_SAMPLE_READY,       // new temperature and humidity
+  EVENT_PRESENCE_CHANGED,   // arg: 1 when the tilt switch closed, 0 when it opened
+  EVENT_ALARM_FIRED,
+  EVENT_ALARM_STOPPED,
+  EVENT_SETTINGS_CHANGED,   // clock face, alarm or setup changed
+  EVENT_TIMEOUT,            // e.g. the backlight timeout ran out
+  EVENT_TYPES
+};
+
+#define EVENT_MASK(type) (1U << (type))
+
+#define EVENT_QUEUE_SIZE 16     // power of two
+
+typedef struct Event {
+  byte type;
+  byte arg;
+} Event;
+
+typedef struct Subscriber {
+  unsigned int mask;                    // EVENT_MASK() of every type to receive
+  void (*handle)(const Event *event);
+} Subscriber;
+
+// Sets the PROGMEM subscriber table, in the order handlers are called.
+extern void eventsBegin(const Subscriber *subscribers, byte count);
+// Queues an event. Returns false (and counts it) if the queue is full.
+extern bool eventPost(byte type, byte arg = 0);
+// Delivers every queued event. Call every loop.
+extern void eventsDispatch();
+// Number of events lost to a full queue since eventsBegin().
+extern unsigned int eventsDropped();
+
+#endif
@@ -0,0 +1,189 @@
+#include "FastDS1302.h"
+
+#define CMD_WRITE_PROTECT   0x8E
+#define CMD_CLOCK_BURST_W   0xBE
+#define CMD_CLOCK_BURST_R   0xBF
+
+#define CLOCK_HALT          0x80    // in the seconds register
+#define HOUR_12             0x80    // in the hours register
+
+// Clock high and low times are 250 ns at 5 V; at 16 MHz four cycles covers it.
+#ifndef DS1302_DELAY
+#define DS1302_DELAY()      __builtin_avr_delay_cycles(4)
+#endif
+
+// ----------------------------------------------------------------------------------------------------
+static byte bcd2bin(byte bcd)
+{
+  return (bcd >> 4) * 10 + (bcd & 0x0F);
+}
+
+// ----------------------------------------------------------------------------------------------------
+static byte bin2bcd(byte bin)
+{
+  return ((bin / 10) << 4) | (bin % 10);
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Shifts a byte out LSB first; the DS1302 latches IO on each rising edge.
+// With release set, IO goes back to an input after the last rising edge: the
+// DS1302 starts driving it on the falling edge that follows a read command.
+static void writeByte(byte value, bool release = false)
+{
+  for (byte i = 0; i < 8; i++)
+  {
+    if (value & 0x01)
+    {
+      DS1302_PORT |= DS1302_IO;
+    }
+    else
+    {
+      DS1302_PORT &= ~DS1302_IO;
+    }
+    DS1302_DELAY();
+    DS1302_PORT |= DS1302_SCLK;
+    DS1302_DELAY();
+    if (release && i == 7)
+    {
+      DS1302_DDR &= ~DS1302_IO;
+      DS1302_PORT &= ~DS1302_IO;    // no pull-up
+    }
+    DS1302_PORT &= ~DS1302_SCLK;
+    value >>= 1;
+  }
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Shifts a byte in LSB first; the DS1302 drives each bit after a falling edge.
+static byte readByte()
+{
+  byte value = 0;
+
+  for (byte i = 0; i < 8; i++)
+  {
+    DS1302_DELAY();
+    if (DS1302_PIN & DS1302_IO)
+    {
+      value |= 1 << i;
+    }
+    DS1302_PORT |= DS1302_SCLK;
+    DS1302_DELAY();
+    DS1302_PORT &= ~DS1302_SCLK;
+  }
+  return value;
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Raises CE and sends a command byte. IO is left as an output for a write
+// and handed to the DS1302 for a read (bit 0 of the command set).
+static void beginTransfer(byte command)
+{
+  DS1302_PORT &= ~(DS1302_SCLK | DS1302_CE);
+  DS1302_DDR |= DS1302_CE | DS1302_SCLK | DS1302_IO;
+  DS1302_PORT |= DS1302_CE;
+  delayMicroseconds(4);           // CE to clock setup, 4 us at 2 V
+  writeByte(command, command & 0x01);
+}
+
+// ----------------------------------------------------------------------------------------------------
+static void endTransfer()
+{
+  DS1302_PORT &= ~DS1302_CE;
+  DS1302_DDR &= ~DS1302_IO;
+  DS1302_PORT &= ~DS1302_IO;      // no pull-up
+}
+
+// ----------------------------------------------------------------------------------------------------
+// The first seven clock registers in one burst: seconds, minutes, hours, date, month, day, year.
+static void readClock(byte *regs)
+{
+  beginTransfer(CMD_CLOCK_BURST_R);
+  for (byte i = 0; i < 7; i++)
+  {
+    regs[i] = readByte();
+  }
+  endTransfer();
+}
+
+// ----------------------------------------------------------------------------------------------------
+byte FastDS1302::read(tmElements_t &tm)
+{
+  byte regs[7];
+
+  readClock(regs);
+  if (regs[0] & CLOCK_HALT)
+  {
+    return 1;
+  }
+
+  tm.Second = bcd2bin(regs[0] & 0x7F);
+  tm.Minute = bcd2bin(regs[1] & 0x7F);
+  if (regs[2] & HOUR_12)
+  {
+    // 12 hour mode: bit 5 is PM, hours run 1-12
+    tm.Hour = bcd2bin(regs[2] & 0x1F) % 12 + ((regs[2] & 0x20) ? 12 : 0);
+  }
+  else
+  {
+    tm.Hour = bcd2bin(regs[2] & 0x3F);
+  }
+  tm.Day = bcd2bin(regs[3] & 0x3F);
+  tm.Month = bcd2bin(regs[4] & 0x1F);
+  tm.Wday = regs[5] & 0x07;
+  tm.Year = y2kYearToTm(bcd2bin(regs[6]));
+  return 0;
+}
+
+// ----------------------------------------------------------------------------------------------------
+byte FastDS1302::write(tmElements_t &tm)
+{
+  byte regs[7];
+
+  regs[0] = bin2bcd(tm.Second);   // clock halt bit clear, so the clock runs
+  regs[1] = bin2bcd(tm.Minute);
+  regs[2] = bin2bcd(tm.Hour);     // 24 hour mode
+  regs[3] = bin2bcd(tm.Day);
+  regs[4] = bin2bcd(tm.Month);
+  regs[5] = tm.Wday;
+  regs[6] = bin2bcd(tmYearToY2k(tm.Year));
+
+  beginTransfer(CMD_WRITE_PROTECT);
+  writeByte(0x00);
+  endTransfer();
+
+  // A clock burst write only takes effect once all eight registers are sent.
+  beginTransfer(CMD_CLOCK_BURST_W);
+  for (byte i = 0; i < 7; i++)
+  {
+    writeByte(regs[i]);
+  }
+  writeByte(0x00);                // write protect register, left unprotected
+  endTransfer();
+
+  // Everything but the seconds should read back unchanged.
+  byte check[7];
+
+  readClock(check);
+  return (memcmp(regs + 1, check + 1, 6) != 0) ? 1 : 0;
+}
+
+// ----------------------------------------------------------------------------------------------------
+time_t FastDS1302::get()
+{
+  tmElements_t tm;
+
+  if (read(tm))
+  {
+    return 0;
+  }
+  return makeTime(tm);
+}
+
+// ----------------------------------------------------------------------------------------------------
+byte FastDS1302::set(time_t t)
+{
+  tmElements_t tm;
+
+  breakTime(t, tm);
+  return write(tm);
+}
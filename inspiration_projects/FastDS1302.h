@@ -0,0 +1,39 @@
+#ifndef FASTDS1302_H_
+#define FASTDS1302_H_
+
+// DS1302 driver using direct port access.
+//
+// The pins are compile-time constants (CE on PB2, IO on PB4, SCLK on PB5 as
+// wired on the v7 clock), so each edge is a single sbi/cbi instruction instead
+// of a digitalWrite() call that looks the pin up at run time. Clock reads and
+// writes use the DS1302's burst mode, one command byte for all registers.
+// The interface matches DS1302RTC's get()/set(), so rtc.get can be handed to
+// setSyncProvider().
+
+#include "Arduino.h"
+#include <TimeLib.h>
+
+#ifndef DS1302_PORT
+#define DS1302_PORT     PORTB
+#define DS1302_DDR      DDRB
+#define DS1302_PIN      PINB
+#define DS1302_CE       _BV(2)
+#define DS1302_IO       _BV(4)
+#define DS1302_SCLK     _BV(5)
+#endif
+
+class FastDS1302
+{
+  public:
+    // Returns the current time, or 0 if the clock is halted (never set or battery lost).
+    static time_t get();
+    // Sets the clock and starts it. Returns 0 on success, like DS1302RTC::set().
+    static byte set(time_t t);
+
+    // Reads the clock registers. Returns 1 if the clock is halted.
+    static byte read(tmElements_t &tm);
+    // Writes the clock registers. Returns 1 if they do not read back.
+    static byte write(tmElements_t &tm);
+};
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef FASTPINS_H_
+#define FASTPINS_H_
+
+// Compile-time pins for the ATmega328.
+//
+// Pin<PortD, 6> carries its port and bit in the type, so high()/low() compile
+// to a single sbi/cbi and read() to an sbic/sbis, with nothing stored in RAM.
+// Compare digitalWrite(), which looks the pin up in flash tables and does an
+// interrupt-guarded read-modify-write of the port on every call.
+
+#include "Arduino.h"
+
+#define FAST_PORT(name, letter) \
+  struct name \
+  { \
+    static inline volatile uint8_t &port() { return PORT##letter; } \
+    static inline volatile uint8_t &ddr() { return DDR##letter; } \
+    static inline volatile uint8_t &pin() { return PIN##letter; } \
+  }
+
+FAST_PORT(PortB, B);
+FAST_PORT(PortC, C);
+FAST_PORT(PortD, D);
+
+template <class Port, uint8_t Bit>
+struct Pin
+{
+  typedef Port PortType;
+  static const uint8_t bit = Bit;
+  static const uint8_t mask = 1 << Bit;
+
+  static inline void output() { Port::ddr() |= mask; }
+  static inline void input() { Port::ddr() &= ~mask; }
+  static inline void high() { Port::port() |= mask; }
+  static inline void low() { Port::port() &= ~mask; }
+  static inline void set(bool on) { if (on) high(); else low(); }
+  static inline bool read() { return Port::pin() & mask; }
+  static inline void toggle() { Port::pin() = mask; }    // writing 1 to PINx toggles the output
+};
+
+// True if two types are the same, used to tell whether pins share a port.
+template <class A, class B> struct SamePort { static const bool value = false; };
+template <class A> struct SamePort<A, A> { static const bool value = true; };
+
+#endif
@@ -0,0 +1,173 @@
+#ifndef HD44780_H_
+#define HD44780_H_
+
+// Header-only HD44780 driver in 4 bit mode on compile-time pins (see FastPins.h).
+//
+// A drop-in for the LiquidCrystal calls the clocks use (begin, clear,
+// setCursor, createChar and Print). When D4-D7 are four neighbouring bits of
+// one port, in either order, a nibble goes out as one port write; the v7
+// wiring has D4-D7 on PD6-PD3, so its nibbles are bit-reversed into place.
+// Any other wiring falls back to one sbi/cbi per data pin. RW must be tied
+// low: instead of polling the busy flag, each byte is followed by the 37 us
+// the controller needs (LiquidCrystal waits 100 us after every nibble).
+
+#include "Arduino.h"
+#include "FastPins.h"
+
+// The pin-level half of the driver, shared with Hd44780Async.h.
+template <class RS, class E, class D4, class D5, class D6, class D7>
+struct Hd44780Bus
+{
+  static void begin()
+  {
+    RS::output();
+    E::output();
+    D4::output();
+    D5::output();
+    D6::output();
+    D7::output();
+    RS::low();
+    E::low();
+  }
+
+  // Resets the controller into 4 bit mode, as in the datasheet's initialisation by instruction.
+  static void reset()
+  {
+    RS::low();
+    delay(50);
+    writeNibble(0x03);
+    delayMicroseconds(4500);
+    writeNibble(0x03);
+    delayMicroseconds(4500);
+    writeNibble(0x03);
+    delayMicroseconds(150);
+    writeNibble(0x02);
+    delayMicroseconds(40);
+  }
+
+  // Latches the low four bits of nibble.
+  static void writeNibble(uint8_t nibble)
+  {
+    typedef typename D4::PortType Port;
+    const bool samePort = SamePort<Port, typename D5::PortType>::value &&
+                          SamePort<Port, typename D6::PortType>::value &&
+                          SamePort<Port, typename D7::PortType>::value;
+
+    // All of these conditions are compile-time constants, so only one branch is emitted.
+    if (samePort && D5::bit == D4::bit + 1 && D6::bit == D4::bit + 2 && D7::bit == D4::bit + 3)
+    {
+      writePort<Port>(D4::bit, nibble);
+    }
+    else if (samePort && D5::bit == D7::bit + 2 && D6::bit == D7::bit + 1 && D4::bit == D7::bit + 3)
+    {
+      uint8_t reversed = ((nibble & 0x01) << 3) | ((nibble & 0x02) << 1) | ((nibble & 0x04) >> 1) | ((nibble & 0x08) >> 3);
+      writePort<Port>(D7::bit, reversed);
+    }
+    else
+    {
+      D4::set(nibble & 0x01);
+      D5::set(nibble & 0x02);
+      D6::set(nibble & 0x04);
+      D7::set(nibble & 0x08);
+    }
+
+    // Enable pulse, at least 450 ns high; data is latched on the falling edge
+    E::high();
+    __builtin_avr_delay_cycles(8);
+    E::low();
+  }
+
+  // Replaces four neighbouring port bits starting at shift. Interrupts are held
+  // off for the read-modify-write, since the other pins of the port may be
+  // driven from an ISR.
+  template <class Port>
+  static inline void writePort(uint8_t shift, uint8_t nibble)
+  {
+    uint8_t sreg = SREG;
+    cli();
+    Port::port() = (Port::port() & ~(0x0F << shift)) | ((nibble & 0x0F) << shift);
+    SREG = sreg;
+  }
+};
+
+// DDRAM address of the first column of each row.
+#define HD44780_ROW_OFFSETS { 0x00, 0x40, 0x14, 0x54 }
+
+template <class RS, class E, class D4, class D5, class D6, class D7>
+class Hd44780 : public Print
+{
+  typedef Hd44780Bus<RS, E, D4, D5, D6, D7> Bus;
+
+  public:
+    void begin(uint8_t cols, uint8_t rows)
+    {
+      Bus::begin();
+      Bus::reset();
+      lines = rows;
+
+      command((rows > 1) ? 0x28 : 0x20);   // function set: 4 bit, lines, 5x8 font
+      command(0x0C);                        // display on, no cursor
+      clear();
+      command(0x06);                        // entry mode: increment, no shift
+      (void)cols;
+    }
+
+    void clear()
+    {
+      command(0x01);
+      delayMicroseconds(1600);
+    }
+
+    void home()
+    {
+      command(0x02);
+      delayMicroseconds(1600);
+    }
+
+    void setCursor(uint8_t col, uint8_t row)
+    {
+      static const uint8_t rowOffsets[4] = HD44780_ROW_OFFSETS;
+
+      if (row >= lines)
+      {
+        row = lines - 1;
+      }
+      command(0x80 | (col + rowOffsets[row & 0x03]));
+    }
+
+    void createChar(uint8_t slot, uint8_t charmap[])
+    {
+      command(0x40 | ((slot & 0x07) << 3));
+      for (uint8_t i = 0; i < 8; i++)
+      {
+        write(charmap[i]);
+      }
+    }
+
+    void command(uint8_t value)
+    {
+      RS::low();
+      send(value);
+    }
+
+    virtual size_t write(uint8_t value)
+    {
+      RS::high();
+      send(value);
+      return 1;
+    }
+
+    using Print::write;
+
+  private:
+    static void send(uint8_t value)
+    {
+      Bus::writeNibble(value >> 4);
+      Bus::writeNibble(value);
+      delayMicroseconds(37);
+    }
+
+    uint8_t lines;
+};
+
+#endif
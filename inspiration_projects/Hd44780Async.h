@@ -0,0 +1,192 @@
+#ifndef HD44780ASYNC_H_
+#define HD44780ASYNC_H_
+
+// HD44780 driver that queues instead of waiting.
+//
+// Same calls as Hd44780 (see Hd44780.h), but command() and write() only put
+// the byte in a 64 entry ring buffer and return. Timer1 fires every 40 us and
+// its interrupt sends one nibble, so a byte takes two ticks and the 37 us the
+// controller needs after it has passed before the next one goes out. After
+// clear() and home() the interrupt idles for 1.6 ms instead. A 16x2 frame is
+// queued in well under a millisecond and shown about 3 ms later.
+//
+// The sketch has to forward the interrupt:
+//
+//   SIGNAL(TIMER1_COMPA_vect)
+//   {
+//     lcd.tick();
+//   }
+//
+// The timer interrupt is only enabled while there is something to send. If
+// the buffer is full, the caller waits for a free entry. Only begin() blocks,
+// because the reset sequence needs milliseconds between steps.
+//
+// RS is driven again before every nibble, so it is restored even if the main
+// loop rewrites the port with a read-modify-write that this interrupt
+// happens to fall into.
+
+#include "Arduino.h"
+#include "Hd44780.h"
+
+#define HD44780_QUEUE_SIZE  64                  // power of two
+#define HD44780_TICK_US     40
+#define HD44780_CLEAR_TICKS (1600 / HD44780_TICK_US)
+
+template <class RS, class E, class D4, class D5, class D6, class D7>
+class Hd44780Async : public Print
+{
+  typedef Hd44780Bus<RS, E, D4, D5, D6, D7> Bus;
+
+  public:
+    void begin(uint8_t cols, uint8_t rows)
+    {
+      TIMSK1 &= ~_BV(OCIE1A);
+      head = 0;
+      tail = 0;
+      lowNibble = false;
+      waitTicks = 0;
+
+      Bus::begin();
+      Bus::reset();
+      lines = rows;
+
+      // Timer1 in CTC mode, prescaler 8: one tick every HD44780_TICK_US
+      TCCR1A = 0;
+      TCCR1B = _BV(WGM12) | _BV(CS11);
+      OCR1A = (F_CPU / 8 / 1000000UL) * HD44780_TICK_US - 1;
+      TCNT1 = 0;
+
+      command((rows > 1) ? 0x28 : 0x20);   // function set: 4 bit, lines, 5x8 font
+      command(0x0C);                        // display on, no cursor
+      clear();
+      command(0x06);                        // entry mode: increment, no shift
+      (void)cols;
+    }
+
+    void clear()
+    {
+      command(0x01);
+    }
+
+    void home()
+    {
+      command(0x02);
+    }
+
+    void setCursor(uint8_t col, uint8_t row)
+    {
+      static const uint8_t rowOffsets[4] = HD44780_ROW_OFFSETS;
+
+      if (row >= lines)
+      {
+        row = lines - 1;
+      }
+      command(0x80 | (col + rowOffsets[row & 0x03]));
+    }
+
+    void createChar(uint8_t slot, uint8_t charmap[])
+    {
+      command(0x40 | ((slot & 0x07) << 3));
+      for (uint8_t i = 0; i < 8; i++)
+      {
+        write(charmap[i]);
+      }
+    }
+
+    void command(uint8_t value)
+    {
+      push(value, false);
+    }
+
+    virtual size_t write(uint8_t value)
+    {
+      push(value, true);
+      return 1;
+    }
+
+    using Print::write;
+
+    // True while bytes are queued or the controller is still busy.
+    bool busy() const
+    {
+      return head != tail || waitTicks != 0 || lowNibble;
+    }
+
+    // Waits until everything queued has been sent.
+    void flush()
+    {
+      while (busy())
+      {
+      }
+    }
+
+    // Sends the next nibble. Call from the Timer1 compare interrupt only.
+    void tick()
+    {
+      if (waitTicks)
+      {
+        waitTicks--;
+        return;
+      }
+      if (head == tail)
+      {
+        TIMSK1 &= ~_BV(OCIE1A);
+        return;
+      }
+
+      uint8_t value = queue[tail];
+      bool data = rsBits[tail >> 3] & (1 << (tail & 0x07));
+
+      RS::set(data);
+      if (!lowNibble)
+      {
+        Bus::writeNibble(value >> 4);
+        lowNibble = true;
+        return;
+      }
+
+      Bus::writeNibble(value);
+      lowNibble = false;
+      tail = (tail + 1) & (HD44780_QUEUE_SIZE - 1);
+
+      // Clear display and return home take 1.52 ms instead of 37 us
+      if (!data && value <= 0x03)
+      {
+        waitTicks = HD44780_CLEAR_TICKS;
+      }
+    }
+
+  private:
+    void push(uint8_t value, bool data)
+    {
+      uint8_t next = (head + 1) & (HD44780_QUEUE_SIZE - 1);
+
+      while (next == tail)
+      {
+        // Full: the interrupt frees an entry every two ticks
+      }
+
+      queue[head] = value;
+      if (data)
+      {
+        rsBits[head >> 3] |= 1 << (head & 0x07);
+      }
+      else
+      {
+        rsBits[head >> 3] &= ~(1 << (head & 0x07));
+      }
+      asm volatile("" ::: "memory");         // the entry is stored before tick() can see it
+      head = next;
+      TIMSK1 |= _BV(OCIE1A);
+    }
+
+    uint8_t queue[HD44780_QUEUE_SIZE];
+    uint8_t rsBits[HD44780_QUEUE_SIZE / 8];   // bit set: data byte, clear: command
+    volatile uint8_t head;                    // written by push() only
+    volatile uint8_t tail;                    // written by tick() only
+    volatile uint8_t waitTicks;
+    volatile bool lowNibble;
+    uint8_t lines;
+};
+
+#endif
@@ -21,21 +21,20 @@ byte buttonState[5];              // current up or down state for each of the bu
 unsigned long buttonPressTime[5]; // press time for each of the buttons
 unsigned long buttonHoldTime[5];  // hold time for each of the buttons
 
-char* padc (char chr, unsigned char count = 0);
-
 // ----------------------------------------------------------------------------------------------------
 void backLightOn()
 {
   backlightState = 1;
-  pinMode(BACKLIGHT_PIN, INPUT);
+  BACKLIGHT_PORT &= ~BACKLIGHT_MASK;
+  BACKLIGHT_DDR &= ~BACKLIGHT_MASK;
 }
 
 // ----------------------------------------------------------------------------------------------------
 void backLightOff()
 {
   backlightState = 0;
-  pinMode(BACKLIGHT_PIN, OUTPUT);
-  digitalWrite(BACKLIGHT_PIN, LOW);
+  BACKLIGHT_PORT &= ~BACKLIGHT_MASK;
+  BACKLIGHT_DDR |= BACKLIGHT_MASK;
 }
 
 // ----------------------------------------------------------------------------------------------------
@@ -45,9 +44,13 @@ void setBacklightBrightness(byte brightness)
 }
 
 // ----------------------------------------------------------------------------------------------------
+// Not a LedEffects channel (lcd_alarmclockv1.0): those are push-pull outputs
+// driven high to light, and pin 10 must never be driven high on keypad shields
+// that wire it straight to the backlight transistor's base.
 void lcdBacklightISR()
 {
-  // This ISR can be improved by writing to the PORT bits directly.
+  // The backlight is on while the pin floats (input) and off while it sinks
+  // (output low). The PORT bit stays low, so each switch is one sbi/cbi on DDR.
   
   const byte dutyCycle = 3;
   static byte pulseWidth;
@@ -60,13 +63,12 @@ void lcdBacklightISR()
   {
     pulseWidth = 0;
     //back light On
-    pinMode(BACKLIGHT_PIN, INPUT);
+    BACKLIGHT_DDR &= ~BACKLIGHT_MASK;
   }
   else if (pulseWidth > displayBrightness)
   {
     //back light off
-    pinMode(BACKLIGHT_PIN, OUTPUT);
-    digitalWrite(BACKLIGHT_PIN, LOW);
+    BACKLIGHT_DDR |= BACKLIGHT_MASK;
   }
   pulseWidth++;
 }
@@ -74,37 +76,32 @@ void lcdBacklightISR()
 // ----------------------------------------------------------------------------------------------------
 char *inttostr(char *dest, short integer)
 {
-  if (integer == 0)
+  char *digits = dest;
+  unsigned short value = integer;   // magnitude as unsigned, so -32768 does not overflow.
+
+  if (integer < 0)
   {
-    strcpy(dest, "0");
+    *digits++ = '-';
+    value = 0 - value;
   }
-  else
-  {
-    byte sign = 0;
-    
-    if (integer < 0)
-    {
-      sign = 1;
-      dest[0] = '-';
-      integer = integer * -1;
-    }
 
-    byte idx = 0;
+  byte len = 1;
 
-    if (integer > 9999) idx = 4;
-    else if (integer > 999) idx = 3;
-    else if (integer > 99) idx = 2;
-    else if (integer > 9) idx = 1;
-    else if (integer > 0) idx = 0;    
+  if (value > 9999) len = 5;
+  else if (value > 999) len = 4;
+  else if (value > 99) len = 3;
+  else if (value > 9) len = 2;
+
+  digits[len] = 0;
+
+  do
+  {
+    unsigned short quotient = value / 10;
+
+    digits[--len] = (value - quotient * 10) + '0';   // one division per digit
+    value = quotient;
+  } while (value);
 
-    idx += sign;
-    dest[idx+1] = 0;
-    
-    for (; idx >=0 && integer !=0; integer /= 10, idx--)
-    {
-      dest[idx]=(integer % 10) + '0';
-    }
-  }
   return dest;
 }
 
@@ -113,18 +110,18 @@ char *inttostr(char *dest, short integer)
 char *fmt (char *dest, unsigned char argc, ... )
 {
   unsigned char buflen = 0;
-  char* str;
+  const char* str;
   
   va_list ap;
   va_start(ap, argc);
 
   for (int i = 0; i < argc && buflen < LCD_COLS; i++)
   {
-    str = va_arg(ap, char*);
-    unsigned char len = strlen(str);
-    unsigned char cpylen = (buflen + len) > LCD_COLS ? LCD_COLS - buflen : len;
+    str = va_arg(ap, const char*);
+
+    unsigned char len = strnlen(str, LCD_COLS - buflen);
 
-    strncpy((dest + buflen), str, cpylen);
+    memcpy(dest + buflen, str, len);
     buflen += len;
   }
   va_end(ap);
@@ -136,57 +133,28 @@ char *fmt (char *dest, unsigned char argc, ... )
 // ----------------------------------------------------------------------------------------------------
 char *rpad (char *dest, const char *str, char chr, unsigned char width)
 {
-  unsigned char len = strlen(str);
-  
   width = width > LCD_COLS ? LCD_COLS : width;
-  
-  if (len < LCD_COLS && width > len)
-  {
-    strcpy(dest, str);
-    strcat(dest, padc(chr, width - len));
-  }
-  else
-  {
-    strncpy(dest, str, width+1);
-  }
-  return dest;
-}
 
-// ----------------------------------------------------------------------------------------------------
-char *lpad (char *dest, const char *str, char chr, unsigned char width)
-{
-  unsigned char len = strlen(str);
-  
-  width = width > LCD_COLS ? LCD_COLS : width;
+  unsigned char len = strnlen(str, width);
 
-  if (len < LCD_COLS && width > len)
-  {
-    strcpy(dest, padc(chr, width - len));
-    strcat(dest, str);
-  }
-  else
-  {
-    strncpy(dest, str, width+1);
-  }
+  memcpy(dest, str, len);
+  memset(dest + len, chr, width - len);
+  dest[width] = 0;
   return dest;
 }
 
-
 // ----------------------------------------------------------------------------------------------------
-char *padc (char chr, unsigned char count)
+char *lpad (char *dest, const char *str, char chr, unsigned char width)
 {
-  static char strbuf[LCD_COLS + 1];
+  width = width > LCD_COLS ? LCD_COLS : width;
 
-  count = (count > LCD_COLS) ? LCD_COLS : count;
+  unsigned char len = strnlen(str, width);
+  unsigned char pad = width - len;
 
-  int i;
-  for (i=0; i < count; i++)
-  {
-    strbuf[i] = chr;
-  }
-  strbuf[i] = 0;
-  
-  return strbuf;
+  memset(dest, chr, pad);
+  memcpy(dest + pad, str, len);
+  dest[width] = 0;
+  return dest;
 }
 
 
@@ -11,6 +11,10 @@
 
 #define BUTTON_PIN  0
 #define BACKLIGHT_PIN 10
+// BACKLIGHT_PIN as port bits, for the backlight ISR
+#define BACKLIGHT_DDR   DDRB
+#define BACKLIGHT_PORT  PORTB
+#define BACKLIGHT_MASK  _BV(2)
 
 // button state indicators
 #define BUTTON_PRESSED_IND        (0 << 6)
@@ -0,0 +1,162 @@
+#include "LoopProfiler.h"
+
+static byte histogram[PROFILE_STAGES][PROFILE_BUCKETS];
+static unsigned long stageMin[PROFILE_STAGES] = {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF};
+static unsigned long stageMax[PROFILE_STAGES];
+static unsigned long lastLoopStart = 0;
+
+static const char stageNames[PROFILE_STAGES][5] PROGMEM = {"LOOP", "BTNS", "TIME", "DHT ", "LCD ", "ALRM"};
+
+// ----------------------------------------------------------------------------------------------------
+static byte bucketOf(unsigned long us)
+{
+  if (us < 2)
+  {
+    return 0;
+  }
+  byte bucket = (sizeof(us) * 8 - 1) - __builtin_clzl(us);
+  return (bucket < PROFILE_BUCKETS) ? bucket : PROFILE_BUCKETS - 1;
+}
+
+// ----------------------------------------------------------------------------------------------------
+void profilerRecord(byte stage, unsigned long us)
+{
+  byte *counts = histogram[stage];
+  byte bucket = bucketOf(us);
+
+  if (counts[bucket] == 0xFF)
+  {
+    for (byte i = 0; i < PROFILE_BUCKETS; i++)
+    {
+      counts[i] = (counts[i] + 1) >> 1;
+    }
+  }
+  counts[bucket]++;
+
+  if (us < stageMin[stage])
+  {
+    stageMin[stage] = us;
+  }
+  if (us > stageMax[stage])
+  {
+    stageMax[stage] = us;
+  }
+}
+
+// ----------------------------------------------------------------------------------------------------
+void profilerLoopTick()
+{
+  unsigned long start = micros();
+
+  if (lastLoopStart != 0)
+  {
+    profilerRecord(PROFILE_LOOP, start - lastLoopStart);
+  }
+  lastLoopStart = start;
+}
+
+// ----------------------------------------------------------------------------------------------------
+void profilerReset()
+{
+  memset(histogram, 0, sizeof(histogram));
+  memset(stageMin, 0xFF, sizeof(stageMin));
+  memset(stageMax, 0, sizeof(stageMax));
+  lastLoopStart = 0;
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Returns the upper bound of the bucket where the running count reaches the given share (per mille).
+static unsigned long percentile(byte stage, unsigned long total, unsigned int perMille)
+{
+  unsigned long target = (total * perMille + 999) / 1000;
+  unsigned long running = 0;
+
+  for (byte i = 0; i < PROFILE_BUCKETS; i++)
+  {
+    running += histogram[stage][i];
+    if (running >= target)
+    {
+      unsigned long bound = (2UL << i) - 1;
+      return (bound > stageMax[stage]) ? stageMax[stage] : bound;
+    }
+  }
+  return stageMax[stage];
+}
+
+// ----------------------------------------------------------------------------------------------------
+void profilerStats(byte stage, ProfileStats *stats)
+{
+  stats->count = 0;
+  for (byte i = 0; i < PROFILE_BUCKETS; i++)
+  {
+    stats->count += histogram[stage][i];
+  }
+  stats->min = (stats->count) ? stageMin[stage] : 0;
+  stats->max = stageMax[stage];
+  stats->p50 = (stats->count) ? percentile(stage, stats->count, 500) : 0;
+  stats->p99 = (stats->count) ? percentile(stage, stats->count, 990) : 0;
+}
+
+// ----------------------------------------------------------------------------------------------------
+char *profilerStageName(char *dest, byte stage)
+{
+  return strcpy_P(dest, stageNames[stage]);
+}
+
+// ----------------------------------------------------------------------------------------------------
+char *profilerFormatTime(char *dest, unsigned long us)
+{
+  char unit = 'u';
+  unsigned long value = us;
+
+  if (us >= 1000000)
+  {
+    // seconds with one decimal, e.g. "2.5s"
+    value = us / 100000;
+    if (value > 99)
+    {
+      value = 99;
+    }
+    dest[0] = '0' + value / 10;
+    dest[1] = '.';
+    dest[2] = '0' + value % 10;
+    dest[3] = 's';
+    dest[4] = 0;
+    return dest;
+  }
+  if (us >= 1000)
+  {
+    unit = 'm';
+    value = us / 1000;
+  }
+  dest[0] = (value > 99) ? '0' + value / 100 : ' ';
+  dest[1] = (value > 9) ? '0' + (value / 10) % 10 : ' ';
+  dest[2] = '0' + value % 10;
+  dest[3] = unit;
+  dest[4] = 0;
+  return dest;
+}
+
+// ----------------------------------------------------------------------------------------------------
+void profilerDump(Print &out)
+{
+  char name[5];
+  ProfileStats stats;
+
+  out.println(F("stage count min p50 p99 max (us)"));
+  for (byte stage = 0; stage < PROFILE_STAGES; stage++)
+  {
+    profilerStats(stage, &stats);
+    out.print(profilerStageName(name, stage));
+    out.print(' ');
+    out.print(stats.count);
+    out.print(' ');
+    out.print(stats.min);
+    out.print(' ');
+    out.print(stats.p50);
+    out.print(' ');
+    out.print(stats.p99);
+    out.print(' ');
+    out.println(stats.max);
+  }
+}
@@ -0,0 +1,61 @@
+#ifndef LOOPPROFILER_H_
+#define LOOPPROFILER_H_
+
+// Per-stage loop latency histograms.
+//
+// Each stage keeps a log2-scaled histogram of micros() durations (bucket i
+// holds samples in [2^i, 2^(i+1)) us) plus exact min and max, which costs
+// about 30 bytes of RAM per stage. Counts are 8 bit; when one saturates, the
+// whole stage is halved, so the distribution shape is kept.
+//
+// Define LOOP_PROFILER before including this header to enable it. Otherwise
+// PROFILE() expands to the bare call and nothing is linked in.
+
+#include "Arduino.h"
+
+enum ProfileStage
+{
+  PROFILE_LOOP,         // whole loop period, start to start
+  PROFILE_READ_BTNS,
+  PROFILE_TIME_DATE,
+  PROFILE_TEMP_HUM,
+  PROFILE_LCD_PRINT,
+  PROFILE_CALL_ALARM,
+  PROFILE_STAGES
+};
+
+#define PROFILE_BUCKETS 22    // up to 2^22 us (about 4 seconds)
+
+typedef struct ProfileStats {
+  unsigned long count;
+  unsigned long min;
+  unsigned long max;
+  unsigned long p50;    // upper bound of the bucket holding the median
+  unsigned long p99;
+} ProfileStats;
+
+// Adds one duration sample to a stage.
+extern void profilerRecord(byte stage, unsigned long us);
+// Records the time since the previous call as a PROFILE_LOOP sample.
+extern void profilerLoopTick();
+// Clears all stages.
+extern void profilerReset();
+
+// Gets the summary of a stage.
+extern void profilerStats(byte stage, ProfileStats *stats);
+// Gets the short (4 character) name of a stage.
+extern char *profilerStageName(char *dest, byte stage);
+// Formats a duration as 4 characters, e.g. "850u", "120m" or "2.5s".
+extern char *profilerFormatTime(char *dest, unsigned long us);
+// Writes a table of all stages.
+extern void profilerDump(Print &out);
+
+#ifdef LOOP_PROFILER
+#define PROFILE(stage, call) do { unsigned long _profileStart = micros(); call; profilerRecord(stage, micros() - _profileStart); } while (0)
+#define PROFILE_LOOP_TICK() profilerLoopTick()
+#else
+#define PROFILE(stage, call) call
+#define PROFILE_LOOP_TICK()
+#endif
+
+#endif
@@ -0,0 +1,170 @@
+#ifndef STATEMACHINE_H_
+#define STATEMACHINE_H_
+
+// Hierarchical state machine with its tables in flash.
+//
+// The sketch declares two PROGMEM tables: a StateDef per state (parent,
+// entry, exit and an optional react function) and a byte per state and
+// signal saying what that state does with the signal:
+//
+//   - another state number: transition there,
+//   - HSM_INTERNAL: call the state's react() and stay,
+//   - HSM_IGNORE: drop the signal,
+//   - HSM_PARENT: let the parent state decide.
+//
+// dispatch() is one table lookup per level of nesting, so nothing is
+// re-evaluated every loop. A transition runs the exit actions from the
+// current state up to the common ancestor with the target, then the entry
+// actions down to the target, as in UML statecharts. Actions may post
+// events but must not call dispatch() or transition() themselves.
+
+#include "Arduino.h"
+#include "EventBus.h"
+
+#define HSM_PARENT    0xFF
+#define HSM_IGNORE    0xFE
+#define HSM_INTERNAL  0xFD
+#define HSM_NONE      0xFF    // parent of a top-level state
+
+#define HSM_MAX_DEPTH 4
+
+typedef void (*StateAction)();
+typedef void (*StateReact)(byte signal, const Event *event);
+
+typedef struct StateDef {
+  byte parent;          // HSM_NONE at the top
+  StateAction entry;    // NULL if nothing to do
+  StateAction exit;
+  StateReact react;     // for HSM_INTERNAL
+} StateDef;
+
+template <byte SIGNALS>
+class StateMachine
+{
+  public:
+    StateMachine(const StateDef *states, const byte (*table)[SIGNALS])
+      : states(states), table(table), state(HSM_NONE)
+    {
+    }
+
+    // Enters the initial state, running entry actions from the top down.
+    void begin(byte initial)
+    {
+      state = HSM_NONE;
+      enter(HSM_NONE, initial);
+    }
+
+    // Handles a signal in the current state or the nearest ancestor that
+    // knows it. Returns false if nobody did.
+    bool dispatch(byte signal, const Event *event = NULL)
+    {
+      for (byte s = state; s != HSM_NONE; s = parentOf(s))
+      {
+        byte action = pgm_read_byte(&table[s][signal]);
+
+        if (action == HSM_PARENT)
+        {
+          continue;
+        }
+        if (action == HSM_INTERNAL)
+        {
+          StateReact react = (StateReact) pgm_read_word(&(states[s].react));
+          react(signal, event);
+        }
+        else if (action != HSM_IGNORE)
+        {
+          transition(action);
+        }
+        return true;
+      }
+      return false;
+    }
+
+    // Goes to a state straight away, as if a table entry had said so.
+    void transition(byte target)
+    {
+      byte common = commonAncestor(state, target);
+
+      // A transition to the current state or an ancestor leaves and re-enters it
+      if (common == target)
+      {
+        common = parentOf(target);
+      }
+      while (state != common)
+      {
+        call((StateAction) pgm_read_word(&(states[state].exit)));
+        state = parentOf(state);
+      }
+      enter(common, target);
+    }
+
+    byte current() const
+    {
+      return state;
+    }
+
+    // True if the current state is the given one or nested in it.
+    bool isIn(byte s) const
+    {
+      for (byte t = state; t != HSM_NONE; t = parentOf(t))
+      {
+        if (t == s)
+        {
+          return true;
+        }
+      }
+      return false;
+    }
+
+  private:
+    byte parentOf(byte s) const
+    {
+      return pgm_read_byte(&(states[s].parent));
+    }
+
+    byte commonAncestor(byte a, byte b) const
+    {
+      for (; a != HSM_NONE; a = parentOf(a))
+      {
+        for (byte t = b; t != HSM_NONE; t = parentOf(t))
+        {
+          if (t == a)
+          {
+            return a;
+          }
+        }
+      }
+      return HSM_NONE;
+    }
+
+    // Runs the entry actions below from, down to target.
+    void enter(byte from, byte target)
+    {
+      byte path[HSM_MAX_DEPTH];
+      byte depth = 0;
+
+      for (byte s = target; s != from && depth < HSM_MAX_DEPTH; s = parentOf(s))
+      {
+        path[depth++] = s;
+      }
+      while (depth)
+      {
+        state = path[--depth];
+        call((StateAction) pgm_read_word(&(states[state].entry)));
+      }
+    }
+
+    static void call(StateAction action)
+    {
+      if (action)
+      {
+        action();
+      }
+    }
+
+    const StateDef *states;
+    const byte (*table)[SIGNALS];
+    byte state;
+};
+
+#endif
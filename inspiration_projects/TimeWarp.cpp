@@ -0,0 +1,78 @@
+#include "TimeWarp.h"
+
+static unsigned long warpMs = 0;          // virtual milliseconds since warpBegin()
+static time_t warpEpoch = 0;              // calendar time at warpMs == 0
+static unsigned long warpNextDeadline = 0;
+static bool warpDeadlinePending = false;
+
+// ----------------------------------------------------------------------------------------------------
+void warpBegin(time_t start)
+{
+  warpEpoch = start;
+  warpMs = 0;
+  warpDeadlinePending = false;
+}
+
+// ----------------------------------------------------------------------------------------------------
+unsigned long warpMillis()
+{
+  return warpMs;
+}
+
+// ----------------------------------------------------------------------------------------------------
+time_t warpNow()
+{
+  return warpEpoch + warpMs / 1000;
+}
+
+// ----------------------------------------------------------------------------------------------------
+void warpDelay(unsigned long ms)
+{
+  warpMs += ms;
+}
+
+// ----------------------------------------------------------------------------------------------------
+void warpDeadline(unsigned long at)
+{
+  if (at > warpMs && (!warpDeadlinePending || at < warpNextDeadline))
+  {
+    warpNextDeadline = at;
+    warpDeadlinePending = true;
+  }
+}
+
+// ----------------------------------------------------------------------------------------------------
+void warpDeadlineAt(time_t at)
+{
+  if (at > warpNow())
+  {
+    warpDeadline((unsigned long)(at - warpEpoch) * 1000);
+  }
+}
+
+// ----------------------------------------------------------------------------------------------------
+void warpStep()
+{
+  unsigned long target = (warpMs / 1000 + WARP_MAX_STEP) * 1000;
+
+  if (warpDeadlinePending && warpNextDeadline < target)
+  {
+    target = warpNextDeadline;
+  }
+  warpMs = target;
+  warpDeadlinePending = false;
+}
+
+// ----------------------------------------------------------------------------------------------------
+time_t WarpRTC::get()
+{
+  return warpNow();
+}
+
+// ----------------------------------------------------------------------------------------------------
+byte WarpRTC::set(time_t t)
+{
+  // Keep virtual millis monotonic; only the calendar offset moves.
+  warpEpoch = t - warpMs / 1000;
+  return 0;
+}
@@ -0,0 +1,52 @@
+#ifndef TIMEWARP_H_
+#define TIMEWARP_H_
+
+// Virtual clock for long-horizon runs of the clock sketches.
+//
+// When TIME_WARP is defined before this header is included, millis(), delay()
+// and now() are redirected to a virtual clock, and WarpRTC stands in for the
+// RTC driver. Call warpStep() once per loop: the clock then jumps straight to
+// the next registered deadline (alarm, sensor interval, backlight timeout)
+// instead of ticking in real time, so days of alarms, midnight rollovers and
+// month ends play out in seconds.
+
+#include "Arduino.h"
+#include <TimeLib.h>
+
+// Largest jump (in seconds) taken by warpStep() when no deadline is closer.
+#ifndef WARP_MAX_STEP
+#define WARP_MAX_STEP 60
+#endif
+
+// Starts the virtual clock at the given calendar time.
+extern void warpBegin(time_t start);
+
+// Virtual replacements for millis(), now() and delay().
+extern unsigned long warpMillis();
+extern time_t warpNow();
+extern void warpDelay(unsigned long ms);
+
+// Registers a deadline that the next warpStep() must not jump past.
+// warpDeadline() takes virtual millis, warpDeadlineAt() takes calendar time.
+extern void warpDeadline(unsigned long at);
+extern void warpDeadlineAt(time_t at);
+
+// Advances the virtual clock to the earliest pending deadline, or by
+// WARP_MAX_STEP seconds (rounded to a second boundary) if none is pending.
+extern void warpStep();
+
+// Drop-in replacement for the DS1302RTC/DS3231 time_t interface.
+class WarpRTC
+{
+  public:
+    static time_t get();
+    static byte set(time_t t);
+};
+
+#ifdef TIME_WARP
+#define millis()    warpMillis()
+#define delay(ms)   warpDelay(ms)
+#define now()       warpNow()
+#endif
+
+#endif
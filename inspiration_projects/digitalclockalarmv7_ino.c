@@ -33,8 +33,11 @@
 //Libraries
 #include <Wire.h>
 #include <TimeLib.h>
-#include <DS1302RTC.h>
-#include <LiquidCrystal.h>
+#include "FastDS1302.h"
+#include "Hd44780Async.h"
+#include "EventBus.h"
+#include "StateMachine.h"
+#include "DigitalClockAlarm/FieldEditor.h"    //In that sketch's folder, the only one its build sees
 #include <EEPROM.h>
 #include <dht.h>
 
@@ -50,6 +53,17 @@
 //uncomment to test biorhythm graphs
 //#define TEST_BIO_GRAPHS
 
+//uncomment to run on a virtual clock that jumps from event to event (see TimeWarp.h)
+//#define TIME_WARP
+#include "TimeWarp.h"
+
+//uncomment to compare DS1302 read times with the DS1302RTC library, printed over serial with 't'
+//#define DS1302_TIMING
+
+//uncomment to collect per-stage loop timings, shown on the DIAG face and dumped over serial with 'p'
+//#define LOOP_PROFILER
+#include "LoopProfiler.h"
+
 #define LIGHT           2  //PD2
 #define LCD_D7          3  //PD3
 #define LCD_D6          4  //PD4
@@ -69,8 +83,19 @@
 
 
 //Connections and constants 
-LiquidCrystal lcd(LCD_RS, LCD_E, LCD_D4, LCD_D5, LCD_D6, LCD_D7);
-DS1302RTC rtc(RTC_CE, RTC_IO, RTC_SCLK);
+//LCD_RS, LCD_E and LCD_D4-LCD_D7 as port bits, so each nibble is one port write (see Hd44780.h).
+//Output is queued and sent from the Timer1 interrupt below (see Hd44780Async.h).
+typedef Hd44780Async<Pin<PortB, 0>, Pin<PortD, 7>, Pin<PortD, 6>, Pin<PortD, 5>, Pin<PortD, 4>, Pin<PortD, 3> > LcdDriver;
+LcdDriver lcd;
+#ifdef TIME_WARP
+WarpRTC rtc;
+#else
+FastDS1302 rtc;     //RTC_CE, RTC_IO and RTC_SCLK are fixed at compile time in FastDS1302.h
+#endif
+#ifdef DS1302_TIMING
+#include <DS1302RTC.h>
+DS1302RTC referenceRtc(RTC_CE, RTC_IO, RTC_SCLK);
+#endif
 dht DHT;
 
 char daysOfTheWeek[7][12] = {"Sunday","Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday"};
@@ -79,8 +104,8 @@ long interval = 300;
 int melody[] = { 600, 800, 1000,1200 };
 
 //Variables
-int DD, MM, YY, H, M, S, temp, hum, set_state, adjust_state, alarm_state, AH, AM, shake_state, BY, BM, BD;
-int shakeTimes = 0;
+int DD, MM, YY, H, M, S, temp, hum, AH, AM, BY, BM, BD;
+int shakeTimes = 0;   //Tilts counted while the alarm rings
 int i = 0;
 String sDD;
 String sMM;
@@ -100,15 +125,17 @@ long prevAlarmMillis = 0;
 long prevDhtMillis = 0;
 
 //Boolean flags
-boolean setupScreen = false;
 boolean alarmON=false;
-boolean turnItOn = false;
+boolean turnItOn = false;   //True while in STATE_RINGING
 
-enum STYLE { STANDARD, DUAL_THICK, DUAL_BEVEL, DUAL_TREK, DUAL_THIN, WORD, BIO, THERMO };
+enum STYLE { STANDARD, DUAL_THICK, DUAL_BEVEL, DUAL_TREK, DUAL_THIN, WORD, BIO, THERMO, DIAG };
 STYLE currentStyle = STANDARD;
+#ifdef LOOP_PROFILER
+#define LAST_STYLE DIAG
+#else
+#define LAST_STYLE THERMO
+#endif
 
-enum SETUP { CLOCK, TIME_HOUR, TIME_MIN, TIME_DAY, TIME_MONTH, TIME_YEAR, BIRTH_DAY, BIRTH_MONTH, BIRTH_YEAR, ALARM_HOUR, ALARM_MIN };
-SETUP setupMode = CLOCK;
 
 
 bool backlightOn = false;
@@ -116,6 +143,20 @@ long backlightTimeout = 0;
 
 byte customChar[8];
 
+//--------------------- Buttons -----------------------------------------
+//BTN_SET, BTN_ADJUST, BTN_ALARM and BTN_TILT as bits of buttonsDown
+enum BUTTON { BUTTON_SET, BUTTON_ADJUST, BUTTON_ALARM, BUTTON_TILT };
+#define BUTTON_DEBOUNCE 20
+byte buttonsDown = 0;     //Debounced state
+byte buttonsSample = 0;   //Last raw sample
+unsigned long prevButtonMillis = 0;
+AutoRepeat buttonRepeat;  //Repeats for the last button pressed while it is held
+byte repeatButton = BUTTON_SET;
+
+//Animated faces also redraw between seconds
+#define FRAME_TICK_INTERVAL 100
+unsigned long prevFrameMillis = 0;
+
 //--------------------- EEPROM ------------------------------------------
 #define EEPROM_AH 0   //Alarm Hours
 #define EEPROM_AM 1   //Alarm Minutes
@@ -126,9 +167,131 @@ byte customChar[8];
 #define EEPROM_BD 7   //Birth Day
 
 //--------------------- Word clock --------------------------------------
-String units[] = {"HUNDRED", "ONE", "TWO", "THREE", "FOUR", "FIVE", "SIX", "SEVEN", "EIGHT", "NINE"};
-String teens[] = {"TEN", "ELEVEN", "TWELVE", "THIRTEEN", "FOURTEEN", "FIFTEEN", "SIXTEEN", "SEVENTEEN", "EIGHTEEN", "NINETEEN"};
-String tens[] = {"", "", "TWENTY", "THIRTY", "FORTY", "FIFTY"};
+//Each phrase is up to two tokens into a shared word dictionary, so the hour and minute
+//phrases are streamed straight from flash to the LCD without building Strings.
+#define W_HUNDRED    0
+#define W_ONE        1
+#define W_TWO        2
+#define W_THREE      3
+#define W_FOUR       4
+#define W_FIVE       5
+#define W_SIX        6
+#define W_SEVEN      7
+#define W_EIGHT      8
+#define W_NINE       9
+#define W_TEN        10
+#define W_ELEVEN     11
+#define W_TWELVE     12
+#define W_THIRTEEN   13
+#define W_FOURTEEN   14
+#define W_FIFTEEN    15
+#define W_SIXTEEN    16
+#define W_SEVENTEEN  17
+#define W_EIGHTEEN   18
+#define W_NINETEEN   19
+#define W_ZERO       20
+#define W_TWENTY     21
+#define W_THIRTY     22
+#define W_FORTY      23
+#define W_FIFTY      24
+#define W_NONE       0xFF
+
+const char wordDictionary[] PROGMEM =
+  "HUNDRED\0" "ONE\0" "TWO\0" "THREE\0" "FOUR\0" "FIVE\0" "SIX\0"
+  "SEVEN\0" "EIGHT\0" "NINE\0" "TEN\0" "ELEVEN\0" "TWELVE\0" "THIRTEEN\0"
+  "FOURTEEN\0" "FIFTEEN\0" "SIXTEEN\0" "SEVENTEEN\0" "EIGHTEEN\0" "NINETEEN\0" "ZERO\0"
+  "TWENTY\0" "THIRTY\0" "FORTY\0" "FIFTY\0";
+const byte wordOffsets[] PROGMEM = { 0, 8, 12, 16, 22, 27, 32, 36, 42, 48, 53, 57, 64, 71, 80, 89, 97, 105, 115, 124, 133, 138, 145, 152, 158 };
+
+const byte hourPhrases[24][2] PROGMEM = {
+  { W_TWENTY, W_FOUR }, //0
+  { W_ONE, W_NONE }, //1
+  { W_TWO, W_NONE }, //2
+  { W_THREE, W_NONE }, //3
+  { W_FOUR, W_NONE }, //4
+  { W_FIVE, W_NONE }, //5
+  { W_SIX, W_NONE }, //6
+  { W_SEVEN, W_NONE }, //7
+  { W_EIGHT, W_NONE }, //8
+  { W_NINE, W_NONE }, //9
+  { W_TEN, W_NONE }, //10
+  { W_ELEVEN, W_NONE }, //11
+  { W_TWELVE, W_NONE }, //12
+  { W_THIRTEEN, W_NONE }, //13
+  { W_FOURTEEN, W_NONE }, //14
+  { W_FIFTEEN, W_NONE }, //15
+  { W_SIXTEEN, W_NONE }, //16
+  { W_SEVENTEEN, W_NONE }, //17
+  { W_EIGHTEEN, W_NONE }, //18
+  { W_NINETEEN, W_NONE }, //19
+  { W_TWENTY, W_NONE }, //20
+  { W_TWENTY, W_ONE }, //21
+  { W_TWENTY, W_TWO }, //22
+  { W_TWENTY, W_THREE }, //23
+};
+
+const byte minutePhrases[60][2] PROGMEM = {
+  { W_HUNDRED, W_NONE }, //0
+  { W_ZERO, W_ONE }, //1
+  { W_ZERO, W_TWO }, //2
+  { W_ZERO, W_THREE }, //3
+  { W_ZERO, W_FOUR }, //4
+  { W_ZERO, W_FIVE }, //5
+  { W_ZERO, W_SIX }, //6
+  { W_ZERO, W_SEVEN }, //7
+  { W_ZERO, W_EIGHT }, //8
+  { W_ZERO, W_NINE }, //9
+  { W_TEN, W_NONE }, //10
+  { W_ELEVEN, W_NONE }, //11
+  { W_TWELVE, W_NONE }, //12
+  { W_THIRTEEN, W_NONE }, //13
+  { W_FOURTEEN, W_NONE }, //14
+  { W_FIFTEEN, W_NONE }, //15
+  { W_SIXTEEN, W_NONE }, //16
+  { W_SEVENTEEN, W_NONE }, //17
+  { W_EIGHTEEN, W_NONE }, //18
+  { W_NINETEEN, W_NONE }, //19
+  { W_TWENTY, W_NONE }, //20
+  { W_TWENTY, W_ONE }, //21
+  { W_TWENTY, W_TWO }, //22
+  { W_TWENTY, W_THREE }, //23
+  { W_TWENTY, W_FOUR }, //24
+  { W_TWENTY, W_FIVE }, //25
+  { W_TWENTY, W_SIX }, //26
+  { W_TWENTY, W_SEVEN }, //27
+  { W_TWENTY, W_EIGHT }, //28
+  { W_TWENTY, W_NINE }, //29
+  { W_THIRTY, W_NONE }, //30
+  { W_THIRTY, W_ONE }, //31
+  { W_THIRTY, W_TWO }, //32
+  { W_THIRTY, W_THREE }, //33
+  { W_THIRTY, W_FOUR }, //34
+  { W_THIRTY, W_FIVE }, //35
+  { W_THIRTY, W_SIX }, //36
+  { W_THIRTY, W_SEVEN }, //37
+  { W_THIRTY, W_EIGHT }, //38
+  { W_THIRTY, W_NINE }, //39
+  { W_FORTY, W_NONE }, //40
+  { W_FORTY, W_ONE }, //41
+  { W_FORTY, W_TWO }, //42
+  { W_FORTY, W_THREE }, //43
+  { W_FORTY, W_FOUR }, //44
+  { W_FORTY, W_FIVE }, //45
+  { W_FORTY, W_SIX }, //46
+  { W_FORTY, W_SEVEN }, //47
+  { W_FORTY, W_EIGHT }, //48
+  { W_FORTY, W_NINE }, //49
+  { W_FIFTY, W_NONE }, //50
+  { W_FIFTY, W_ONE }, //51
+  { W_FIFTY, W_TWO }, //52
+  { W_FIFTY, W_THREE }, //53
+  { W_FIFTY, W_FOUR }, //54
+  { W_FIFTY, W_FIVE }, //55
+  { W_FIFTY, W_SIX }, //56
+  { W_FIFTY, W_SEVEN }, //57
+  { W_FIFTY, W_EIGHT }, //58
+  { W_FIFTY, W_NINE }, //59
+};
 
 //---------------------- Hourglass animation ----------------------------
 #define HOURGLASS_FRAMES 8
@@ -293,6 +456,144 @@ const byte thinChar[11][2] = {
   {32, 32}  //blank
 };
  
+//---------------------- LCD output ----------------------------
+//Sends the next queued nibble to the LCD every 40us while there is output pending
+SIGNAL(TIMER1_COMPA_vect)
+{
+  lcd.tick();
+}
+
+//---------------------- Modes ----------------------------
+//The clock's modes as a hierarchical state machine (see StateMachine.h).
+//STATE_CLOCK handles what its children leave to it, STATE_SETUP steps the field being edited.
+//The field states come first so they index setupFields[].
+enum STATE
+{
+  STATE_CLOCK,
+    STATE_DARK,       //Backlight off, the first press only wakes it
+    STATE_LIT,
+    STATE_RINGING,
+  STATE_SETUP,
+    TIME_HOUR, TIME_MIN, TIME_DAY, TIME_MONTH, TIME_YEAR,     //in SETUP_TIME
+    BIRTH_DAY, BIRTH_MONTH, BIRTH_YEAR,                       //in SETUP_BIRTH
+    ALARM_HOUR, ALARM_MIN,                                    //in SETUP_ALARM
+    SETUP_BANNER,
+    SETUP_TIME,
+    SETUP_BIRTH,
+    SETUP_ALARM,
+    SETUP_SAVING
+};
+
+//What the states react to, mapped from events in onModeEvent()
+enum MODE_SIGNAL { SIG_SET, SIG_ADJUST, SIG_ALARM, SIG_REPEAT, SIG_TICK, SIG_SHAKE, SIG_FIRED, SIG_STOPPED, SIG_TIMEOUT, MODE_SIGNALS };
+
+void clockEntry();
+void clockReact(byte signal, const Event *event);
+void darkEntry();
+void litEntry();
+void ringingEntry();
+void ringingExit();
+void ringingReact(byte signal, const Event *event);
+void setupEntry();
+void setupReact(byte signal, const Event *event);
+void bannerEntry();
+void timeScreenEntry();
+void birthScreenEntry();
+void alarmScreenEntry();
+void fieldEntry();
+void fieldExit();
+void savingEntry();
+
+const StateDef modeStates[] PROGMEM = {
+  { HSM_NONE, clockEntry, NULL, clockReact },           //STATE_CLOCK
+  { STATE_CLOCK, darkEntry, NULL, NULL },               //STATE_DARK
+  { STATE_CLOCK, litEntry, NULL, NULL },                //STATE_LIT
+  { STATE_CLOCK, ringingEntry, ringingExit, ringingReact }, //STATE_RINGING
+  { HSM_NONE, setupEntry, NULL, setupReact },           //STATE_SETUP
+  { SETUP_TIME, fieldEntry, fieldExit, NULL },          //TIME_HOUR
+  { SETUP_TIME, fieldEntry, fieldExit, NULL },          //TIME_MIN
+  { SETUP_TIME, fieldEntry, fieldExit, NULL },          //TIME_DAY
+  { SETUP_TIME, fieldEntry, fieldExit, NULL },          //TIME_MONTH
+  { SETUP_TIME, fieldEntry, fieldExit, NULL },          //TIME_YEAR
+  { SETUP_BIRTH, fieldEntry, fieldExit, NULL },         //BIRTH_DAY
+  { SETUP_BIRTH, fieldEntry, fieldExit, NULL },         //BIRTH_MONTH
+  { SETUP_BIRTH, fieldEntry, fieldExit, NULL },         //BIRTH_YEAR
+  { SETUP_ALARM, fieldEntry, fieldExit, NULL },         //ALARM_HOUR
+  { SETUP_ALARM, fieldEntry, fieldExit, NULL },         //ALARM_MIN
+  { STATE_SETUP, bannerEntry, NULL, NULL },             //SETUP_BANNER
+  { STATE_SETUP, timeScreenEntry, NULL, NULL },         //SETUP_TIME
+  { STATE_SETUP, birthScreenEntry, NULL, NULL },        //SETUP_BIRTH
+  { STATE_SETUP, alarmScreenEntry, NULL, NULL },        //SETUP_ALARM
+  { STATE_SETUP, savingEntry, NULL, NULL },             //SETUP_SAVING
+};
+
+#define PARENT    HSM_PARENT
+#define IGNORE    HSM_IGNORE
+#define INTERNAL  HSM_INTERNAL
+const byte modeTable[][MODE_SIGNALS] PROGMEM = {
+  //SIG_SET     SIG_ADJUST  SIG_ALARM   SIG_REPEAT  SIG_TICK    SIG_SHAKE   SIG_FIRED      SIG_STOPPED SIG_TIMEOUT
+  { SETUP_BANNER, INTERNAL, INTERNAL,   IGNORE,     INTERNAL,   IGNORE,     STATE_RINGING, IGNORE,     IGNORE     }, //STATE_CLOCK
+  { STATE_LIT,  STATE_LIT,  STATE_LIT,  PARENT,     PARENT,     PARENT,     PARENT,        PARENT,     PARENT     }, //STATE_DARK
+  { PARENT,     PARENT,     PARENT,     PARENT,     PARENT,     PARENT,     PARENT,        PARENT,     STATE_DARK }, //STATE_LIT
+  { IGNORE,     PARENT,     STATE_LIT,  PARENT,     PARENT,     INTERNAL,   IGNORE,        STATE_LIT,  IGNORE     }, //STATE_RINGING
+  { IGNORE,     INTERNAL,   INTERNAL,   INTERNAL,   IGNORE,     IGNORE,     IGNORE,        IGNORE,     IGNORE     }, //STATE_SETUP
+  { TIME_MIN,   PARENT,     PARENT,     PARENT,     PARENT,     PARENT,     PARENT,        PARENT,     PARENT     }, //TIME_HOUR
+  { TIME_DAY,   PARENT,     PARENT,     PARENT,     PARENT,     PARENT,     PARENT,        PARENT,     PARENT     }, //TIME_MIN
+  { TIME_MONTH, PARENT,     PARENT,     PARENT,     PARENT,     PARENT,     PARENT,        PARENT,     PARENT     }, //TIME_DAY
+  { TIME_YEAR,  PARENT,     PARENT,     PARENT,     PARENT,     PARENT,     PARENT,        PARENT,     PARENT     }, //TIME_MONTH
+  { BIRTH_DAY,  PARENT,     PARENT,     PARENT,     PARENT,     PARENT,     PARENT,        PARENT,     PARENT     }, //TIME_YEAR
+  { BIRTH_MONTH,PARENT,     PARENT,     PARENT,     PARENT,     PARENT,     PARENT,        PARENT,     PARENT     }, //BIRTH_DAY
+  { BIRTH_YEAR, PARENT,     PARENT,     PARENT,     PARENT,     PARENT,     PARENT,        PARENT,     PARENT     }, //BIRTH_MONTH
+  { ALARM_HOUR, PARENT,     PARENT,     PARENT,     PARENT,     PARENT,     PARENT,        PARENT,     PARENT     }, //BIRTH_YEAR
+  { ALARM_MIN,  PARENT,     PARENT,     PARENT,     PARENT,     PARENT,     PARENT,        PARENT,     PARENT     }, //ALARM_HOUR
+  { SETUP_SAVING, PARENT,   PARENT,     PARENT,     PARENT,     PARENT,     PARENT,        PARENT,     PARENT     }, //ALARM_MIN
+  { TIME_HOUR,  IGNORE,     IGNORE,     IGNORE,     PARENT,     PARENT,     PARENT,        PARENT,     TIME_HOUR  }, //SETUP_BANNER
+  { PARENT,     PARENT,     PARENT,     PARENT,     PARENT,     PARENT,     PARENT,        PARENT,     PARENT     }, //SETUP_TIME
+  { PARENT,     PARENT,     PARENT,     PARENT,     PARENT,     PARENT,     PARENT,        PARENT,     PARENT     }, //SETUP_BIRTH
+  { PARENT,     PARENT,     PARENT,     PARENT,     PARENT,     PARENT,     PARENT,        PARENT,     PARENT     }, //SETUP_ALARM
+  { IGNORE,     IGNORE,     IGNORE,     IGNORE,     PARENT,     PARENT,     PARENT,        PARENT,     STATE_LIT  }, //SETUP_SAVING
+};
+#undef PARENT
+#undef IGNORE
+#undef INTERNAL
+
+StateMachine<MODE_SIGNALS> mode(modeStates, modeTable);
+
+//A state can ask for EVENT_TIMEOUT a while after it was entered (see startTimeout())
+byte timeoutState = HSM_NONE;
+unsigned long timeoutStart = 0;
+unsigned int timeoutLength = 0;
+
+//---------------------- Setup fields ----------------------------
+//The value each field state edits, in STATE order from TIME_HOUR (see DigitalClockAlarm/FieldEditor.h).
+//Years stop at the ends of their range instead of wrapping.
+const Field setupFields[] PROGMEM = {
+  { &H,  0,    23,   5,  0, 2, FIELD_WRAP },    //TIME_HOUR
+  { &M,  0,    59,   10, 0, 2, FIELD_WRAP },    //TIME_MIN
+  { &DD, 1,    31,   1,  1, 2, FIELD_WRAP },    //TIME_DAY
+  { &MM, 1,    12,   6,  1, 2, FIELD_WRAP },    //TIME_MONTH
+  { &YY, 2000, 2099, 11, 1, 2, 0 },             //TIME_YEAR
+  { &BD, 1,    31,   1,  1, 2, FIELD_WRAP },    //BIRTH_DAY
+  { &BM, 1,    12,   6,  1, 2, FIELD_WRAP },    //BIRTH_MONTH
+  { &BY, 1900, 2099, 11, 1, 4, 0 },             //BIRTH_YEAR
+  { &AH, 0,    23,   5,  1, 2, FIELD_WRAP },    //ALARM_HOUR
+  { &AM, 0,    59,   10, 1, 2, FIELD_WRAP },    //ALARM_MIN
+};
+
+FieldEditor<LcdDriver> editor(lcd);
+
+//---------------------- Events ----------------------------
+//Modules only run when an event they subscribe to arrives (see EventBus.h)
+void onModeEvent(const Event *event);
+void onDisplayEvent(const Event *event);
+
+const Subscriber subscribers[] PROGMEM = {
+  { EVENT_MASK(EVENT_BUTTON_PRESSED) | EVENT_MASK(EVENT_BUTTON_REPEAT) | EVENT_MASK(EVENT_SECOND_TICK) | EVENT_MASK(EVENT_PRESENCE_CHANGED) |
+    EVENT_MASK(EVENT_ALARM_FIRED) | EVENT_MASK(EVENT_ALARM_STOPPED) | EVENT_MASK(EVENT_TIMEOUT), onModeEvent },
+  { EVENT_MASK(EVENT_SECOND_TICK) | EVENT_MASK(EVENT_FRAME_TICK) | EVENT_MASK(EVENT_SAMPLE_READY) |
+    EVENT_MASK(EVENT_SETTINGS_CHANGED), onDisplayEvent },
+};
+
 //---------------------- General initialisation ----------------------------
 void setup() 
 {
@@ -368,181 +669,400 @@ void setup()
   }
   //Setup current style
   lcd.begin(16,2);
-  currentStyle = (cs > (uint8_t)THERMO) ? STANDARD : (STYLE)cs;
-  switch (currentStyle)
-  {
-    case STANDARD: lcdStandardSetup(); break;
-    case DUAL_THICK: lcdDualThickSetup(); break;
-    case DUAL_BEVEL: lcdDualBevelSetup(); break;
-    case DUAL_TREK: lcdDualTrekSetup(); break;
-    case DUAL_THIN: lcdDualThinSetup(); break;
-    case WORD: lcdWordSetup(); break;
-    case BIO: lcdBioRhythmSetup(); break;
-    case THERMO: lcdThermometerSetup(); break;
-  }
-  
-#ifdef BACKLIGHT_ALWAYS_ON
-  switchBacklight(true);
-#endif
+  currentStyle = (cs > (uint8_t)LAST_STYLE) ? STANDARD : (STYLE)cs;
 
+  eventsBegin(subscribers, sizeof(subscribers) / sizeof(subscribers[0]));
+#if defined(BACKLIGHT_ALWAYS_ON) || defined(NO_BACKLIGHT)
+  mode.begin(STATE_LIT);
+#else
+  mode.begin(STATE_DARK);
+#endif
 }
 
 //---------------------- Main program loop ----------------------------
 void loop() 
 {
-  readBtns();       //Read buttons 
-  getTimeDate();    //Read time and date from RTC
-  getTempHum();     //Read temperature and humidity
-  if (!setupScreen)
+  PROFILE_LOOP_TICK();
+  PROFILE(PROFILE_READ_BTNS, readBtns());       //Read buttons 
+  PROFILE(PROFILE_TIME_DATE, getTimeDate());    //Read time and date from RTC
+  PROFILE(PROFILE_TEMP_HUM, getTempHum());      //Read temperature and humidity
+  frameTick();
+  eventsDispatch();                             //Let the modules react to what changed
+
+  if (turnItOn)
   {
-    lcdPrint();     //Normanlly print the current time/date/alarm to the LCD
-    if (alarmON)
-    {
-      callAlarm();  // and check the alarm if set on
-      if (turnItOn)
-      {
-        switchBacklight(true);
-      }
-    }
-    //Serial.println("backlightTimeout=" + String(backlightTimeout) + ", millis()=" + String(millis()) + ", backlightOn=" + String(backlightOn));
-#ifdef BACKLIGHT_TIMEOUT
-    if (backlightOn && (millis() > backlightTimeout))
-    {
-      switchBacklight(false);
-    }
+    playAlarm();
+  }
+  if (mode.current() == timeoutState && millis() - timeoutStart >= timeoutLength)
+  {
+    timeoutState = HSM_NONE;
+    eventPost(EVENT_TIMEOUT);
+  }
+  //Serial.println("backlightTimeout=" + String(backlightTimeout) + ", millis()=" + String(millis()) + ", backlightOn=" + String(backlightOn));
+#if defined(BACKLIGHT_TIMEOUT) && !defined(BACKLIGHT_ALWAYS_ON) && !defined(NO_BACKLIGHT)
+  if (mode.current() == STATE_LIT && (millis() > backlightTimeout))
+  {
+    eventPost(EVENT_TIMEOUT);
+  }
 #endif
+
+#ifdef DS1302_TIMING
+  if (Serial.available() && Serial.peek() == 't')
+  {
+    Serial.read();
+    ds1302Timing();
   }
-  else
+#endif
+
+#ifdef LOOP_PROFILER
+  if (Serial.available() && Serial.read() == 'p')
   {
-    timeSetup();    //If button set is pressed then call the time setup function
-    switchBacklight(true);
+    profilerDump(Serial);
   }
+#endif
+
+#ifdef TIME_WARP
+  //Jump the virtual clock to the next thing that can change the clock's state
+  warpDeadline(prevDhtMillis + DHT_UPDATE_INTERVAL);
+  if (backlightOn)
+  {
+    warpDeadline(backlightTimeout + 1);             //Its check and the melody's are strict, so one past
+  }
+  if (alarmON)
+  {
+    time_t alarmTime = previousMidnight(now()) + AH * SECS_PER_HOUR + AM * SECS_PER_MIN;
+    warpDeadlineAt((alarmTime > now()) ? alarmTime : alarmTime + SECS_PER_DAY);
+    warpDeadlineAt(alarmTime + 5 * SECS_PER_MIN);
+  }
+  if (turnItOn)
+  {
+    warpDeadline(prevAlarmMillis + interval + 1);
+  }
+  if (mode.current() == timeoutState)
+  {
+    warpDeadline(timeoutStart + timeoutLength);
+  }
+  warpStep();
+#endif
 }
 
 //--------------------------------------------------
-//Read buttons state
+//Read buttons state and post an event for every debounced change, and repeats while one is held
 void readBtns()
 {
-  set_state = digitalRead(BTN_SET);
-  adjust_state = digitalRead(BTN_ADJUST);
-  alarm_state = digitalRead(BTN_ALARM);
-  if (!backlightOn && !setupScreen)
+  unsigned long currentMillis = millis();
+  if (currentMillis - prevButtonMillis < BUTTON_DEBOUNCE)
   {
-    if (set_state == LOW || adjust_state == LOW || alarm_state == LOW)
-    {
-      //Turn on backlight
-      switchBacklight(true);
-      //need to hold down button for at least 1/2 a second 
-      delay(500);
-    }
+    return;
   }
-  else
+  prevButtonMillis = currentMillis;
+
+  byte sample = 0;
+  if (digitalRead(BTN_SET) == LOW) sample |= _BV(BUTTON_SET);
+  if (digitalRead(BTN_ADJUST) == LOW) sample |= _BV(BUTTON_ADJUST);
+  if (digitalRead(BTN_ALARM) == LOW) sample |= _BV(BUTTON_ALARM);
+  if (digitalRead(BTN_TILT) == LOW) sample |= _BV(BUTTON_TILT);
+
+  //A button changes once it reads the same in two samples in a row
+  byte changed = (sample ^ buttonsDown) & ~(sample ^ buttonsSample);
+  buttonsSample = sample;
+  buttonsDown ^= changed;
+
+  for (byte b = BUTTON_SET; b <= BUTTON_TILT; b++)
   {
-    if(!setupScreen)
+    if (changed & _BV(b))
     {
-      if (alarm_state == LOW)
+      bool down = buttonsDown & _BV(b);
+      if (b == BUTTON_TILT)
       {
-        alarmON = !alarmON;
-        EEPROM.write(EEPROM_AO, (alarmON) ? 1 : 0);
-        delay(500);
-        switchBacklight(true);
+        eventPost(EVENT_PRESENCE_CHANGED, down);
       }
-      else if (adjust_state == LOW)
-      {
-        currentStyle = (currentStyle == THERMO) ? STANDARD : (STYLE)((int)currentStyle + 1);
-        EEPROM.write(EEPROM_CS, (byte)currentStyle);
-        switch (currentStyle)
-        {
-          case STANDARD: lcdStandardSetup(); break;
-          case DUAL_THICK: lcdDualThickSetup(); break;
-          case DUAL_BEVEL: lcdDualBevelSetup(); break;
-          case DUAL_TREK: lcdDualTrekSetup(); break;
-          case DUAL_THIN: lcdDualThinSetup(); break;
-          case WORD: lcdWordSetup(); break;
-          case BIO: lcdBioRhythmSetup(); break;
-          case THERMO: lcdThermometerSetup(); break;
-        }
-        lcd.clear();
-        lcdPrint();
-        delay(500);
-        switchBacklight(true);
-      }
-    }
-    
-    if (set_state == LOW)
-    {
-      setupMode = (setupMode == ALARM_MIN) ? CLOCK : (SETUP)((int)setupMode + 1);
-      if( setupMode != CLOCK )
-      {
-        setupScreen = true;
-        if (setupMode == TIME_HOUR)
-        {
-          lcd.clear();
-          lcd.setCursor(0,0);
-          lcd.print("------SET------");
-          lcd.setCursor(0,1);
-          lcd.print("-TIME and DATE-");
-          delay(2000);
-          lcd.clear();
-        }
-      } 
       else
       {
-        lcd.clear();
-        //Set RTC
-        tmElements_t tm;
-        tm.Year = CalendarYrToTm(YY);
-        tm.Month = MM;
-        tm.Day = DD;
-        tm.Hour = H;
-        tm.Minute = M;
-        tm.Second = 0;
-        time_t t = makeTime(tm);
-        //use the time_t value to ensure correct weekday is set
-        if (rtc.set(t) == 0) 
-        { // Success
-          setTime(t);
+        eventPost(down ? EVENT_BUTTON_PRESSED : EVENT_BUTTON_RELEASED, b);
+        if (down)
+        {
+          repeatButton = b;
+          buttonRepeat.press(currentMillis);
         }
-        else
+        else if (b == repeatButton)
         {
-          Serial.println("RTC set failed!");
+          buttonRepeat.release();
         }
-        //rtc.adjust(DateTime(YY, MM, DD, H, M, 0)); //Save time and date to RTC IC
-        
-        EEPROM.write(EEPROM_AH, AH);  //Save the alarm hours to EEPROM
-        EEPROM.write(EEPROM_AM, AM);  //Save the alarm minuted to EEPROM
-        EEPROM.write(EEPROM_BY + 0, BY >> 8);  //Save the birth year to EEPROM
-        EEPROM.write(EEPROM_BY + 1, BY & 0xFF);  //Save the birth year to EEPROM
-        EEPROM.write(EEPROM_BM, BM);  //Save the birth month to EEPROM
-        EEPROM.write(EEPROM_BD, BD);  //Save the birth day to EEPROM
-        
-        lcd.print("Saving....");
-        delay(2000);
-        lcd.clear();
-        setupScreen = false;
-        setupMode = CLOCK;
-        switchBacklight(true);
       }
-      delay(500);
     }
   }
+  if (buttonRepeat.due(currentMillis))
+  {
+    eventPost(EVENT_BUTTON_REPEAT, repeatButton);
+  }
+}
+
+//--------------------------------------------------
+//Debounced state of a button
+bool buttonHeld(byte button)
+{
+  return buttonsDown & _BV(button);
+}
+
+//--------------------------------------------------
+//Hand the events the modes care about to the state machine
+void onModeEvent(const Event *event)
+{
+  byte signal;
+  switch (event->type)
+  {
+    case EVENT_BUTTON_PRESSED: signal = SIG_SET + event->arg; break;   //BUTTON_SET, BUTTON_ADJUST, BUTTON_ALARM
+    case EVENT_BUTTON_REPEAT: signal = SIG_REPEAT; break;
+    case EVENT_SECOND_TICK: signal = SIG_TICK; break;
+    case EVENT_PRESENCE_CHANGED: signal = SIG_SHAKE; break;
+    case EVENT_ALARM_FIRED: signal = SIG_FIRED; break;
+    case EVENT_ALARM_STOPPED: signal = SIG_STOPPED; break;
+    case EVENT_TIMEOUT: signal = SIG_TIMEOUT; break;
+    default: return;
+  }
+  mode.dispatch(signal, event);
+}
+
+//--------------------------------------------------
+//Clock face controls: alarm on/off and next face, and the alarm check every second
+void clockEntry()
+{
+  lcd.clear();
+  lcdSetup();   //Faces that only redraw on change need a full redraw after the setup screens
+  eventPost(EVENT_SETTINGS_CHANGED);
+}
+
+void clockReact(byte signal, const Event *event)
+{
+  switch (signal)
+  {
+    case SIG_TICK:
+      PROFILE(PROFILE_CALL_ALARM, callAlarm());
+      return;
+
+    case SIG_ALARM:
+      alarmON = !alarmON;
+      EEPROM.write(EEPROM_AO, (alarmON) ? 1 : 0);
+      break;
+
+    case SIG_ADJUST:
+      currentStyle = (currentStyle == LAST_STYLE) ? STANDARD : (STYLE)((int)currentStyle + 1);
+      EEPROM.write(EEPROM_CS, (byte)currentStyle);
+      lcdSetup();
+      lcd.clear();
+      break;
+  }
+  eventPost(EVENT_SETTINGS_CHANGED);
+  switchBacklight(true);
+}
+
+void darkEntry()
+{
+  switchBacklight(false);
+}
+
+void litEntry()
+{
+  switchBacklight(true);
+}
+
+//--------------------------------------------------
+//Ask for EVENT_TIMEOUT after ms, unless the current state has been left by then
+void startTimeout(unsigned int ms)
+{
+  timeoutState = mode.current();
+  timeoutStart = millis();
+  timeoutLength = ms;
+}
+
+//--------------------------------------------------
+//Setup screens: ADJUST steps the field up and ALARM steps it down, faster while held
+void setupEntry()
+{
+  switchBacklight(true);
+}
+
+void setupReact(byte signal, const Event *event)
+{
+  byte button = (signal == SIG_REPEAT) ? event->arg : signal - SIG_SET;
+  if (button == BUTTON_ADJUST)
+  {
+    editor.step(1);
+  }
+  else if (button == BUTTON_ALARM)
+  {
+    editor.step(-1);
+  }
+}
+
+void bannerEntry()
+{
+  lcd.clear();
+  lcd.setCursor(0,0);
+  lcd.print("------SET------");
+  lcd.setCursor(0,1);
+  lcd.print("-TIME and DATE-");
+  startTimeout(2000);
+}
+
+//Draw every value of a screen, the field state then adds the cursor
+void showFields(byte first, byte last)
+{
+  for (byte f = first; f <= last; f++)
+  {
+    editor.show(&setupFields[f - TIME_HOUR]);
+  }
+}
+
+void timeScreenEntry()
+{
+  lcd.clear();
+  lcd.setCursor(8,0);
+  lcd.print(":");
+  lcd.setCursor(4,1);
+  lcd.print("/");
+  lcd.setCursor(9,1);
+  lcd.print("/");
+  showFields(TIME_HOUR, TIME_YEAR);
+}
+
+void birthScreenEntry()
+{
+  lcd.clear();
+  lcd.setCursor(0,0);
+  lcd.print(" SET BIRTH DATE");
+  lcd.setCursor(4,1);
+  lcd.print("/");
+  lcd.setCursor(9,1);
+  lcd.print("/");
+  showFields(BIRTH_DAY, BIRTH_YEAR);
+}
+
+void alarmScreenEntry()
+{
+  lcd.clear();
+  lcd.setCursor(0,0);
+  lcd.print(" SET ALARM TIME");
+  lcd.setCursor(8,1);
+  lcd.print(":");
+  showFields(ALARM_HOUR, ALARM_MIN);
+}
+
+void fieldEntry()
+{
+  editor.begin(&setupFields[mode.current() - TIME_HOUR]);
+}
+
+void fieldExit()
+{
+  editor.end();
+}
+
+//Save everything and show it for a while before going back to the clock
+void savingEntry()
+{
+  lcd.clear();
+  //Set RTC
+  tmElements_t tm;
+  tm.Year = CalendarYrToTm(YY);
+  tm.Month = MM;
+  tm.Day = DD;
+  tm.Hour = H;
+  tm.Minute = M;
+  tm.Second = 0;
+  time_t t = makeTime(tm);
+  //use the time_t value to ensure correct weekday is set
+  if (rtc.set(t) == 0) 
+  { // Success
+    setTime(t);
+  }
+  else
+  {
+    Serial.println("RTC set failed!");
+  }
+  //rtc.adjust(DateTime(YY, MM, DD, H, M, 0)); //Save time and date to RTC IC
+  
+  EEPROM.write(EEPROM_AH, AH);  //Save the alarm hours to EEPROM
+  EEPROM.write(EEPROM_AM, AM);  //Save the alarm minuted to EEPROM
+  EEPROM.write(EEPROM_BY + 0, BY >> 8);  //Save the birth year to EEPROM
+  EEPROM.write(EEPROM_BY + 1, BY & 0xFF);  //Save the birth year to EEPROM
+  EEPROM.write(EEPROM_BM, BM);  //Save the birth month to EEPROM
+  EEPROM.write(EEPROM_BD, BD);  //Save the birth day to EEPROM
+  
+  lcd.print("Saving....");
+  startTimeout(2000);
+}
+
+//--------------------------------------------------
+//Post a frame tick for faces that animate between seconds
+void frameTick()
+{
+  unsigned long currentMillis = millis();
+  if (currentStyle == WORD && currentMillis - prevFrameMillis >= FRAME_TICK_INTERVAL)
+  {
+    prevFrameMillis = currentMillis;
+    eventPost(EVENT_FRAME_TICK);
+  }
+}
+
+#ifdef DS1302_TIMING
+//--------------------------------------------------
+//Time a burst of clock reads through the DS1302RTC library and through FastDS1302
+void ds1302Timing()
+{
+  unsigned long start = micros();
+  for (byte i = 0; i < 10; i++)
+  {
+    referenceRtc.get();
+  }
+  unsigned long library = (micros() - start) / 10;
+
+  start = micros();
+  for (byte i = 0; i < 10; i++)
+  {
+    FastDS1302::get();
+  }
+  unsigned long fast = (micros() - start) / 10;
+
+  Serial.print(F("DS1302 get(): DS1302RTC "));
+  Serial.print(library);
+  Serial.print(F(" us, FastDS1302 "));
+  Serial.print(fast);
+  Serial.println(F(" us"));
 }
+#endif
 
 //--------------------------------------------------
-//Read time and date from rtc ic
+//Read time and date from rtc ic, posting a second tick when it has moved on
 void getTimeDate()
 {
-  if (!setupScreen)
+  static time_t shownTime = 0;
+
+  if (!mode.isIn(STATE_SETUP))
   {
     //DateTime now = rtc.now();
     time_t t = now();
+    if (t == shownTime)
+    {
+      return;
+    }
+    shownTime = t;
     DD = day(t);
     MM = month(t);
     YY = year(t);
     H = hour(t);
     M = minute(t);
     S = second(t);
+    formatTimeDate();
+    eventPost(EVENT_SECOND_TICK, S);
   }
+}
+
+//--------------------------------------------------
+//Make the text versions of the time, date, birth date and alarm
+void formatTimeDate()
+{
   //Make some fixes...
   sDD = ((DD < 10) ? "0" : "") + String(DD);
   sMM = ((MM < 10) ? "0" : "") + String(MM);
@@ -573,6 +1093,7 @@ void getTempHum()
     temp = min(round(DHT.temperature),99);
     sTMP = ((temp > 9) ? "" : " ") + String(temp);
     sHUM = ((hum > 9) ? "" : " ") + String(hum);
+    eventPost(EVENT_SAMPLE_READY);
   }
 }
 
@@ -596,6 +1117,26 @@ void switchBacklight(bool on)
   #endif
 }
 
+//--------------------------------------------------
+//Prepare the display for the current style
+void lcdSetup()
+{
+  switch (currentStyle)
+  {
+    case STANDARD: lcdStandardSetup(); break;
+    case DUAL_THICK: lcdDualThickSetup(); break;
+    case DUAL_BEVEL: lcdDualBevelSetup(); break;
+    case DUAL_TREK: lcdDualTrekSetup(); break;
+    case DUAL_THIN: lcdDualThinSetup(); break;
+    case WORD: lcdWordSetup(); break;
+    case BIO: lcdBioRhythmSetup(); break;
+    case THERMO: lcdThermometerSetup(); break;
+#ifdef LOOP_PROFILER
+    case DIAG: lcdDiagnosticsSetup(); break;
+#endif
+  }
+}
+
 //--------------------------------------------------
 //Print values to the display
 void lcdPrint()
@@ -610,6 +1151,19 @@ void lcdPrint()
     case WORD: lcdWordLayout(); break;
     case BIO: lcdBioRhythmLayout(); break;
     case THERMO: lcdThermometerLayout(); break;
+#ifdef LOOP_PROFILER
+    case DIAG: lcdDiagnosticsLayout(); break;
+#endif
+  }
+}
+
+//--------------------------------------------------
+//Redraw the clock face when something on it changed
+void onDisplayEvent(const Event *event)
+{
+  if (!mode.isIn(STATE_SETUP))
+  {
+    PROFILE(PROFILE_LCD_PRINT, lcdPrint());
   }
 }
 
@@ -951,19 +1505,30 @@ void lcdDualThinPrintDigit(int pos, int number)
 }
 
 //------------------------------------------------ Word layout ---------------------------------------------------------------------
+int wordHour = -1;
+int wordMinute = -1;
+
 void lcdWordSetup()
 {
   createCharP(BELL_CHAR, &bell[0]);
+  wordHour = -1;    //Force a redraw of both phrases
+  wordMinute = -1;
 }
 
 void lcdWordLayout()
 {
-  String line1 = numberToWord(H, false);
-  String line2 = numberToWord(M, true);
-  lcd.setCursor(0,0); //First row
-  printClear(line1, 13);
-  lcd.setCursor(0,1); //Second row
-  printClear(line2, 14);
+  if (H != wordHour)
+  {
+    wordHour = H;
+    lcd.setCursor(0,0); //First row
+    lcdPrintPhrase(hourPhrases[H], 13);
+  }
+  if (M != wordMinute)
+  {
+    wordMinute = M;
+    lcd.setCursor(0,1); //Second row
+    lcdPrintPhrase(minutePhrases[M], 14);
+  }
 
   if (millis() > frameTimeout)
   {
@@ -1010,34 +1575,35 @@ void printClear(String s, int len)
   }
 }
 
-//Convert a number to a word
-// number - value to convert
-// minutes - true if this is a minute value
-// returns text string
-String numberToWord(int number, bool minutes)
+//Print a phrase streamed from the word dictionary and clear to right
+// phrase - pair of word tokens (W_NONE if unused)
+// len - length of area to clear including phrase length
+void lcdPrintPhrase(const byte* phrase, int len)
 {
-  int t = number / 10;
-  int u = number % 10;
-  if (t == 0 && u == 0 && !minutes)
-  {
-    t = 2; u = 4;
-  }
-  
-  if (t == 0)
-  {
-    return String((minutes && u != 0) ? "ZERO " : "") + String(units[u]);
-  }
-  else if (t == 1)
-  {
-    return String(teens[u]);
-  }
-  else if (u == 0)
+  for (int t = 0; t < 2; t++)
   {
-    return String(tens[t]);
+    byte token = pgm_read_byte(phrase + t);
+    if (token == W_NONE)
+    {
+      break;
+    }
+    if (t > 0)
+    {
+      lcd.write(' ');
+      len--;
+    }
+    const char* p = wordDictionary + pgm_read_byte(&wordOffsets[token]);
+    char c;
+    while ((c = pgm_read_byte(p++)) != 0)
+    {
+      lcd.write(c);
+      len--;
+    }
   }
-  else
+  while (len > 0)
   {
-    return String(tens[t]) + " " + String(units[u]);
+    lcd.write(' ');
+    len--;
   }
 }
 
@@ -1130,7 +1696,7 @@ int16_t createBioCharacterM(int bioValue, int slot)
 // divisor - 23 for physical, 28 for emotional, 33 for intellectual
 int getBioRhythmValue(int divisor)
 {
-  int days = getDifference(YY,MM,DD,BY,BM,BD);
+  long days = getDifference(YY,MM,DD,BY,BM,BD);
 
 //Used to animate biorhythm graphs to see if they are working correctly
 #ifdef TEST_BIO_GRAPHS  
@@ -1166,11 +1732,11 @@ int countLeapYears(int y, int m)
 }
  
 //This function returns number of days between two given dates 
-//(y1/m1/d1 - y2/m2/d2)
-int getDifference(int y1, int m1, int d1, int y2, int m2, int d2)
+//(y1/m1/d1 - y2/m2/d2), as a long: the counts from year 0 are far past 16 bits
+long getDifference(int y1, int m1, int d1, int y2, int m2, int d2)
 {
   //Convert first date to days
-  long int n1 = y1 * 365 + d1;
+  long int n1 = y1 * 365L + d1;
   for (int i = 0; i < m1 - 1; i++)
   {
     n1 += monthDays[i];
@@ -1179,7 +1745,7 @@ int getDifference(int y1, int m1, int d1, int y2, int m2, int d2)
   n1 += countLeapYears(y1, m1);
 
   //Convert second date to days
-  long int n2 = y2 * 365 + d2;
+  long int n2 = y2 * 365L + d2;
   for (int i = 0; i < m2 - 1; i++)
   {
       n2 += monthDays[i];
@@ -1219,379 +1785,102 @@ void lcdThermometerLayout()
   lcdWordShowBell(15, 1, (S & 0x01), BELL_CHAR); //Flash alarm character if on
 }
 
-//------------------------------------------------ Setup Screens ---------------------------------------------------------------------
+//------------------------------------------------ Diagnostics layout ---------------------------------------------------------------------
+#ifdef LOOP_PROFILER
 
-void timeSetup()
-{
-  switch (setupMode)
-  {
-    case TIME_HOUR: setTimeHour(adjust_state, alarm_state); break;
-    case TIME_MIN: setTimeMinute(adjust_state, alarm_state); break;
-    case TIME_DAY: setTimeDay(adjust_state, alarm_state); break;
-    case TIME_MONTH: setTimeMonth(adjust_state, alarm_state); break;
-    case TIME_YEAR: setTimeYear(adjust_state, alarm_state); break;
-    case BIRTH_DAY: setBirthDay(adjust_state, alarm_state); break;
-    case BIRTH_MONTH: setBirthMonth(adjust_state, alarm_state); break;
-    case BIRTH_YEAR: setBirthYear(adjust_state, alarm_state); break;
-    case ALARM_HOUR: setAlarmHour(adjust_state, alarm_state); break;
-    case ALARM_MIN: setAlarmMinute(adjust_state, alarm_state); break;
-  }
-}
+#define DIAG_STAGE_TIMEOUT 2000
+byte diagStage = 0;
+long diagStageTimeout = 0;
 
-//------------------------------------------------ Time Setup Screen ---------------------------------------------------------------------
-      
-void setTimeHour(int up_state, int down_state)
+void lcdDiagnosticsSetup()
 {
-  lcd.setCursor(4,0);
-  lcd.print(">"); 
-  if (up_state == LOW){   //Up button +
-    if (H<23){
-      H++;
-    }
-    else {
-      H=0;
-    }
-    delay(350);
-  }
-  if (down_state == LOW){ //Down button -
-    if (H>0){
-      H--;
-    }
-    else {
-      H=23;
-    }
-    delay(350);
-  }
-  displayTimeSetupScreen();
+  diagStage = 0;
+  diagStageTimeout = millis() + DIAG_STAGE_TIMEOUT;
 }
 
-void setTimeMinute(int up_state, int down_state)
+void lcdDiagnosticsLayout()
 {
-  lcd.setCursor(4,0);
-  lcd.print(" ");
-  lcd.setCursor(9,0);
-  lcd.print(">");
-  if (up_state == LOW){
-    if (M<59){
-      M++;
-    }
-    else {
-      M=0;
-    }
-    delay(350);
-  }
-  if (down_state == LOW){
-    if (M>0){
-      M--;
-    }
-    else {
-      M=59;
-    }
-    delay(350);
+  //0123456789012345
+  //BTNS p50 850u
+  //p99  12m max2.5s
+  if (millis() > diagStageTimeout)
+  {
+    diagStageTimeout = millis() + DIAG_STAGE_TIMEOUT;
+    diagStage = (diagStage + 1) % PROFILE_STAGES;
   }
-  displayTimeSetupScreen();
-}
 
-void setTimeDay(int up_state, int down_state)
-{
-  lcd.setCursor(9,0);
-  lcd.print(" ");
-  lcd.setCursor(0,1);
-  lcd.print(">");
-  if (up_state == LOW){
-    if (DD<31){
-      DD++;
-    }
-    else {
-      DD=1;
-    }
-    delay(350);
-  }
-  if (down_state == LOW){
-    if (DD>1){
-      DD--;
-    }
-    else {
-      DD=31;
-    }
-    delay(350);
-  }
-  displayTimeSetupScreen();
-}
+  ProfileStats stats;
+  char name[5];
+  char p50[5];
+  char p99[5];
+  char mx[5];
+  profilerStats(diagStage, &stats);
+  profilerStageName(name, diagStage);
+  profilerFormatTime(p50, stats.p50);
+  profilerFormatTime(p99, stats.p99);
+  profilerFormatTime(mx, stats.max);
 
-void setTimeMonth(int up_state, int down_state)
-{
-  lcd.setCursor(0,1);
-  lcd.print(" ");
-  lcd.setCursor(5,1);
-  lcd.print(">");
-  if (up_state == LOW){
-    if (MM<12){
-      MM++;
-    }
-    else {
-      MM=1;
-    }
-    delay(350);
-  }
-  if (down_state == LOW){
-    if (MM>1){
-      MM--;
-    }
-    else {
-      MM=12;
-    }
-    delay(350);
-  }
-  displayTimeSetupScreen();
-}
-
-void setTimeYear(int up_state, int down_state)
-{
-  lcd.setCursor(5,1);
-  lcd.print(" ");
-  lcd.setCursor(10,1);
-  lcd.print(">");
-  if (up_state == LOW){
-    if (YY<2999){
-      YY++;
-    }
-    else {
-      YY=2000;
-    }
-    delay(350);
-  }
-  if (down_state == LOW){
-    if (YY>2018){
-      YY--;
-    }
-    else {
-      YY=2999;
-    }
-    delay(350);
-  }
-  displayTimeSetupScreen();
+  lcd.setCursor(0,0); //First row
+  printClear(String(name) + " p50 " + p50, 16);
+  lcd.setCursor(0,1); //Second row
+  printClear(String("p99 ") + p99 + " max" + mx, 16);
 }
 
-void displayTimeSetupScreen()
-{
-  lcd.setCursor(5,0);
-  lcd.print(sH);
-  lcd.setCursor(8,0);
-  lcd.print(":");
-  lcd.setCursor(10,0);
-  lcd.print(sM);
-  lcd.setCursor(1,1);
-  lcd.print(sDD);
-  lcd.setCursor(4,1);
-  lcd.print("/");
-  lcd.setCursor(6,1);
-  lcd.print(sMM);
-  lcd.setCursor(9,1);
-  lcd.print("/");
-  lcd.setCursor(11,1);
-  lcd.print(sYY);
-}
+#endif
 
-//------------------------------------------------ Birth Setup Screen ---------------------------------------------------------------------
+//------------------------------------------------ Alarm Control ---------------------------------------------------------------------
       
-void setBirthDay(int up_state, int down_state)
+//Check the alarm time, once a second
+void callAlarm()
 {
-  lcd.setCursor(10,1);
-  lcd.print(" ");
-  lcd.setCursor(0,1);
-  lcd.print(">");
-  if (up_state == LOW){
-    if (BD<31){
-      BD++;
-    }
-    else {
-      BD=1;
-    }
-    delay(350);
+  if (!alarmON)
+  {
+    return;
   }
-  if (down_state == LOW){
-    if (BD>1){
-      BD--;
-    }
-    else {
-      BD=31;
-    }
-    delay(350);
+  if (!turnItOn && AM==M && AH==H && S>=0 && S<=2){
+    eventPost(EVENT_ALARM_FIRED);
   }
-  displayBirthSetupScreen();
-}
-
-void setBirthMonth(int up_state, int down_state)
-{
-  lcd.setCursor(0,1);
-  lcd.print(" ");
-  lcd.setCursor(5,1);
-  lcd.print(">");
-  if (up_state == LOW){
-    if (BM<12){
-      BM++;
-    }
-    else {
-      BM=1;
-    }
-    delay(350);
-  }
-  if (down_state == LOW){
-    if (BM>1){
-      BM--;
-    }
-    else {
-      BM=12;
-    }
-    delay(350);
+  //Stop after five minutes, wrapping past the hour for alarms set at minute 55 or later
+  if (turnItOn && M==((AM+5) % 60)){
+    eventPost(EVENT_ALARM_STOPPED);
   }
-  displayBirthSetupScreen();
 }
 
-void setBirthYear(int up_state, int down_state)
+void ringingEntry()
 {
-  lcd.setCursor(5,1);
-  lcd.print(" ");
-  lcd.setCursor(10,1);
-  lcd.print(">");
-  if (up_state == LOW){
-    if (BY<2999){
-      BY++;
-    }
-    else {
-      BY=1900;
-    }
-    delay(350);
-  }
-  if (down_state == LOW){
-    if (BY>1900){
-      BY--;
-    }
-    else {
-      BY=2999;
-    }
-    delay(350);
-  }
-  displayBirthSetupScreen();
+  turnItOn = true;
+  shakeTimes = 0;
+  switchBacklight(true);
 }
 
-void displayBirthSetupScreen()
+void ringingExit()
 {
-  lcd.setCursor(0,0);
-  lcd.print(" SET BIRTH DATE");
-  lcd.setCursor(1,1);
-  lcd.print(sBD);
-  lcd.setCursor(4,1);
-  lcd.print("/");
-  lcd.setCursor(6,1);
-  lcd.print(sBM);
-  lcd.setCursor(9,1);
-  lcd.print("/");
-  lcd.setCursor(11,1);
-  lcd.print(sBY);
+  turnItOn = false;
+  noTone(SPEAKER);
 }
 
-//------------------------------------------------ Alarm Setup Screen ---------------------------------------------------------------------
-      
-void setAlarmHour(int up_state, int down_state)
+//Shaking the clock six times stops the alarm
+void ringingReact(byte signal, const Event *event)
 {
-  lcd.setCursor(9,1);
-  lcd.print(" ");
-  lcd.setCursor(4,1);
-  lcd.print(">");
-  if (up_state == LOW){
-    if (AH<23){
-      AH++;
-    }
-    else {
-      AH=0;
-    }
-    delay(350);
-  }
-  if (down_state == LOW){
-    if (AH>0){
-      AH--;
-    }
-    else {
-      AH=23;
-    }
-    delay(350);
-  }
-  displayAlarmSetupScreen();
-}
-
-void setAlarmMinute(int up_state, int down_state)
-{
-  lcd.setCursor(4,1);
-  lcd.print(" ");
-  lcd.setCursor(9,1);
-  lcd.print(">");
-  if (up_state == LOW){
-    if (AM<59){
-      AM++;
-    }
-    else {
-      AM=0;
-    }
-    delay(350);
-  }
-  if (down_state == LOW){
-    if (AM>0){
-      AM--;
-    }
-    else {
-      AM=59;
+  if (event->arg)
+  {
+    shakeTimes++;
+    Serial.print(shakeTimes);
+    if (shakeTimes >= 6)
+    {
+      eventPost(EVENT_ALARM_STOPPED);
     }
-    delay(350);
   }
-  displayAlarmSetupScreen();
-}
-
-void displayAlarmSetupScreen()
-{
-  lcd.setCursor(0,0);
-  lcd.print(" SET ALARM TIME");
-  lcd.setCursor(0,1);
-  lcd.print("    ");
-  lcd.setCursor(7,1);
-  lcd.print(" :");
-  lcd.setCursor(12,1);
-  lcd.print("    ");
-  lcd.setCursor(5,1);
-  lcd.print(aH);
-  lcd.setCursor(10,1);
-  lcd.print(aM);
 }
 
-//------------------------------------------------ Alarm Control ---------------------------------------------------------------------
-      
-void callAlarm()
+//Play the next note of the alarm melody when it is due
+void playAlarm()
 {
-  if (aM==sM && aH==sH && S>=0 && S<=2){
-    turnItOn = true;
-  }
-  if(alarm_state==LOW || shakeTimes>=6 || (M==(AM+5))){
-    turnItOn = false;
-    alarmON=true;
-    delay(500);
-  } 
-  if(digitalRead(BTN_TILT) == LOW){
-    shakeTimes++;
-    Serial.print(shakeTimes);
-    delay(150);
-  }
-  if (turnItOn){
-    unsigned long currentMillis = millis();
-    if(currentMillis - prevAlarmMillis > interval) {
-      prevAlarmMillis = currentMillis;   
-      tone(SPEAKER,melody[i],100);
-      i++; 
-      if(i>3){i=0; };
-    }
-  }
-  else{
-    noTone(SPEAKER);
-    shakeTimes=0;
+  unsigned long currentMillis = millis();
+  if(currentMillis - prevAlarmMillis > interval) {
+    prevAlarmMillis = currentMillis;   
+    tone(SPEAKER,melody[i],100);
+    i++; 
+    if(i>3){i=0; };
   }
 }
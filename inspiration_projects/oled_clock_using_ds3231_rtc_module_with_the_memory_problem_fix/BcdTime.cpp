@@ -0,0 +1,79 @@
+#include "BcdTime.h"
+
+// ----------------------------------------------------------------------------------------------------
+byte bcdToBin(byte bcd)
+{
+  return (bcd >> 4) * 10 + (bcd & 0x0F);
+}
+
+// ----------------------------------------------------------------------------------------------------
+byte binToBcd(byte bin)
+{
+  return ((bin / 10) << 4) | (bin % 10);
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Two ASCII digits straight to BCD; a leading space counts as 0.
+static byte asciiToBcd(const char *p)
+{
+  return ((p[0] == ' ' ? 0 : p[0] - '0') << 4) | (p[1] - '0');
+}
+
+// ----------------------------------------------------------------------------------------------------
+void bcdFromBuildTime(BcdTime *t, const char *date, const char *time)
+{
+  static const char months[] = "JanFebMarAprMayJunJulAugSepOctNovDec";
+  static const byte monthOffsets[12] = { 0, 3, 2, 5, 0, 3, 5, 1, 4, 6, 2, 4 };
+  byte month = 0;
+
+  while (month < 11 && strncmp(months + month * 3, date, 3) != 0)
+  {
+    month++;
+  }
+
+  t->hour = asciiToBcd(time);
+  t->minute = asciiToBcd(time + 3);
+  t->second = asciiToBcd(time + 6);
+  t->date = asciiToBcd(date + 4);
+  t->month = binToBcd(month + 1);
+  t->year = asciiToBcd(date + 9);
+
+  // Sakamoto's method gives 0 for Sunday
+  unsigned int y = 2000 + bcdToBin(t->year) - (month < 2);
+  byte dow = (y + y / 4 - y / 100 + y / 400 + monthOffsets[month] + bcdToBin(t->date)) % 7;
+  t->dayOfWeek = (dow == 0) ? 7 : dow;
+}
+
+// ----------------------------------------------------------------------------------------------------
+char *bcdFormat(char *dest, byte bcd)
+{
+  *dest++ = '0' + (bcd >> 4);
+  *dest++ = '0' + (bcd & 0x0F);
+  return dest;
+}
+
+// ----------------------------------------------------------------------------------------------------
+char *bcdTimeText(char *dest, const BcdTime *t)
+{
+  char *p = bcdFormat(dest, t->hour);
+  *p++ = ':';
+  p = bcdFormat(p, t->minute);
+  *p++ = ':';
+  p = bcdFormat(p, t->second);
+  *p = 0;
+  return dest;
+}
+
+// ----------------------------------------------------------------------------------------------------
+char *bcdDateText(char *dest, const BcdTime *t)
+{
+  char *p = bcdFormat(dest, t->date);
+  *p++ = '.';
+  p = bcdFormat(p, t->month);
+  *p++ = '.';
+  *p++ = '2';
+  *p++ = '0';
+  p = bcdFormat(p, t->year);
+  *p = 0;
+  return dest;
+}
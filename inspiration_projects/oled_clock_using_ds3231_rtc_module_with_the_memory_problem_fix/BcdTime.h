@@ -0,0 +1,40 @@
+#ifndef BCDTIME_H_
+#define BCDTIME_H_
+
+// Time snapshot kept in the DS3231's own BCD register format (read with
+// ds3231Read(), see Ds3231Regs.h).
+//
+// Each register byte already holds the two decimal digits of its field, one
+// per nibble, so display text is produced by adding '0' to each nibble; no
+// division is needed on the per-second display path. Fields are only decoded
+// to binary (bcdToBin()) where arithmetic needs them, such as alarm checks.
+
+#include "Arduino.h"
+
+typedef struct BcdTime {
+  byte second;        // 00-59
+  byte minute;        // 00-59
+  byte hour;          // 00-23, the clock is run in 24 hour mode
+  byte dayOfWeek;     // 1-7, binary (a single digit reads the same either way)
+  byte date;          // 01-31
+  byte month;         // 01-12, century bit masked off
+  byte year;          // 00-99, years since 2000
+} BcdTime;
+
+// Conversions for the few places that need arithmetic.
+extern byte bcdToBin(byte bcd);
+extern byte binToBcd(byte bin);
+
+// Fills t from the compiler's __DATE__ ("Mmm dd yyyy") and __TIME__ ("hh:mm:ss").
+// dayOfWeek is 1 for Monday to 7 for Sunday.
+extern void bcdFromBuildTime(BcdTime *t, const char *date, const char *time);
+
+// Writes the two digits of a BCD field and returns the position after them (no terminator).
+extern char *bcdFormat(char *dest, byte bcd);
+
+// "HH:MM:SS", dest needs 9 bytes.
+extern char *bcdTimeText(char *dest, const BcdTime *t);
+// "DD.MM.20YY", dest needs 11 bytes.
+extern char *bcdDateText(char *dest, const BcdTime *t);
+
+#endif
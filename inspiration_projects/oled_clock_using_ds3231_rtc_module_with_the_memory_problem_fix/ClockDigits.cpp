@@ -0,0 +1,106 @@
+#include "ClockDigits.h"
+
+const byte largeDigits[10][LARGE_DIGIT_PAGES][LARGE_DIGIT_WIDTH] PROGMEM = {
+  { // 0
+    {0x1F,0x1F,0x1F,0xE3,0xE3,0xE3,0xE3,0xE3,0xE3,0xE3,0xE3,0xE3,0x1F,0x1F,0x1F},
+    {0x00,0x00,0x00,0x3F,0x3F,0x3F,0xC7,0xC7,0xC7,0xF8,0xF8,0xF8,0x00,0x00,0x00},
+    {0xF0,0xF0,0xF0,0x8E,0x8E,0x8E,0x8F,0x8F,0x8F,0x8F,0x8F,0x8F,0xF0,0xF0,0xF0},
+  },
+  { // 1
+    {0xFF,0xFF,0xFF,0x1F,0x1F,0x1F,0x03,0x03,0x03,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF},
+    {0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0x00,0x00,0x00,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF},
+    {0xFF,0xFF,0xFF,0x8F,0x8F,0x8F,0x80,0x80,0x80,0x8F,0x8F,0x8F,0xFF,0xFF,0xFF},
+  },
+  { // 2
+    {0x1F,0x1F,0x1F,0xE3,0xE3,0xE3,0xE3,0xE3,0xE3,0xE3,0xE3,0xE3,0x1F,0x1F,0x1F},
+    {0x3F,0x3F,0x3F,0xC7,0xC7,0xC7,0xC7,0xC7,0xC7,0xC7,0xC7,0xC7,0xF8,0xF8,0xF8},
+    {0x80,0x80,0x80,0x8F,0x8F,0x8F,0x8F,0x8F,0x8F,0x8F,0x8F,0x8F,0x8F,0x8F,0x8F},
+  },
+  { // 3
+    {0xE3,0xE3,0xE3,0xE3,0xE3,0xE3,0xE3,0xE3,0xE3,0xE3,0xE3,0xE3,0x03,0x03,0x03},
+    {0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xC7,0xC7,0xC7,0xC0,0xC0,0xC0,0x3F,0x3F,0x3F},
+    {0xF1,0xF1,0xF1,0x8F,0x8F,0x8F,0x8F,0x8F,0x8F,0x8F,0x8F,0x8F,0xF0,0xF0,0xF0},
+  },
+  { // 4
+    {0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0x1F,0x1F,0x1F,0x03,0x03,0x03,0xFF,0xFF,0xFF},
+    {0x07,0x07,0x07,0x38,0x38,0x38,0x3F,0x3F,0x3F,0x00,0x00,0x00,0x3F,0x3F,0x3F},
+    {0xFE,0xFE,0xFE,0xFE,0xFE,0xFE,0xFE,0xFE,0xFE,0x80,0x80,0x80,0xFE,0xFE,0xFE},
+  },
+  { // 5
+    {0x03,0x03,0x03,0xE3,0xE3,0xE3,0xE3,0xE3,0xE3,0xE3,0xE3,0xE3,0xE3,0xE3,0xE3},
+    {0xF8,0xF8,0xF8,0xF8,0xF8,0xF8,0xF8,0xF8,0xF8,0xF8,0xF8,0xF8,0x07,0x07,0x07},
+    {0xF1,0xF1,0xF1,0x8F,0x8F,0x8F,0x8F,0x8F,0x8F,0x8F,0x8F,0x8F,0xF0,0xF0,0xF0},
+  },
+  { // 6
+    {0xFF,0xFF,0xFF,0x1F,0x1F,0x1F,0xE3,0xE3,0xE3,0xE3,0xE3,0xE3,0xE3,0xE3,0xE3},
+    {0x00,0x00,0x00,0xC7,0xC7,0xC7,0xC7,0xC7,0xC7,0xC7,0xC7,0xC7,0x3F,0x3F,0x3F},
+    {0xF0,0xF0,0xF0,0x8F,0x8F,0x8F,0x8F,0x8F,0x8F,0x8F,0x8F,0x8F,0xF0,0xF0,0xF0},
+  },
+  { // 7
+    {0xE3,0xE3,0xE3,0xE3,0xE3,0xE3,0xE3,0xE3,0xE3,0xE3,0xE3,0xE3,0x03,0x03,0x03},
+    {0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0x3F,0x3F,0x3F,0xC7,0xC7,0xC7,0xF8,0xF8,0xF8},
+    {0x8F,0x8F,0x8F,0xF1,0xF1,0xF1,0xFE,0xFE,0xFE,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF},
+  },
+  { // 8
+    {0x1F,0x1F,0x1F,0xE3,0xE3,0xE3,0xE3,0xE3,0xE3,0xE3,0xE3,0xE3,0x1F,0x1F,0x1F},
+    {0x38,0x38,0x38,0xC7,0xC7,0xC7,0xC7,0xC7,0xC7,0xC7,0xC7,0xC7,0x38,0x38,0x38},
+    {0xF0,0xF0,0xF0,0x8F,0x8F,0x8F,0x8F,0x8F,0x8F,0x8F,0x8F,0x8F,0xF0,0xF0,0xF0},
+  },
+  { // 9
+    {0x1F,0x1F,0x1F,0xE3,0xE3,0xE3,0xE3,0xE3,0xE3,0xE3,0xE3,0xE3,0x1F,0x1F,0x1F},
+    {0xF8,0xF8,0xF8,0xC7,0xC7,0xC7,0xC7,0xC7,0xC7,0xC7,0xC7,0xC7,0x00,0x00,0x00},
+    {0x8F,0x8F,0x8F,0x8F,0x8F,0x8F,0x8F,0x8F,0x8F,0xF1,0xF1,0xF1,0xFE,0xFE,0xFE},
+  },
+};
+
+const byte smallDigits[10][SMALL_DIGIT_PAGES][SMALL_DIGIT_WIDTH] PROGMEM = {
+  { // 0
+    {0x0F,0x0F,0xF3,0xF3,0xF3,0xF3,0x33,0x33,0x0F,0x0F},
+    {0xC0,0xC0,0x33,0x33,0x3C,0x3C,0x3F,0x3F,0xC0,0xC0},
+  },
+  { // 1
+    {0xFF,0xFF,0xCF,0xCF,0x03,0x03,0xFF,0xFF,0xFF,0xFF},
+    {0xFF,0xFF,0x3F,0x3F,0x00,0x00,0x3F,0x3F,0xFF,0xFF},
+  },
+  { // 2
+    {0xCF,0xCF,0xF3,0xF3,0xF3,0xF3,0xF3,0xF3,0x0F,0x0F},
+    {0x03,0x03,0x3C,0x3C,0x3C,0x3C,0x3C,0x3C,0x3F,0x3F},
+  },
+  { // 3
+    {0xF3,0xF3,0xF3,0xF3,0xF3,0xF3,0x33,0x33,0xC3,0xC3},
+    {0xCF,0xCF,0x3F,0x3F,0x3C,0x3C,0x3C,0x3C,0xC3,0xC3},
+  },
+  { // 4
+    {0xFF,0xFF,0x3F,0x3F,0xCF,0xCF,0x03,0x03,0xFF,0xFF},
+    {0xF0,0xF0,0xF3,0xF3,0xF3,0xF3,0x00,0x00,0xF3,0xF3},
+  },
+  { // 5
+    {0x03,0x03,0x33,0x33,0x33,0x33,0x33,0x33,0xF3,0xF3},
+    {0xCF,0xCF,0x3F,0x3F,0x3F,0x3F,0x3F,0x3F,0xC0,0xC0},
+  },
+  { // 6
+    {0x3F,0x3F,0xCF,0xCF,0xF3,0xF3,0xF3,0xF3,0xF3,0xF3},
+    {0xC0,0xC0,0x3C,0x3C,0x3C,0x3C,0x3C,0x3C,0xC3,0xC3},
+  },
+  { // 7
+    {0xF3,0xF3,0xF3,0xF3,0xF3,0xF3,0xF3,0xF3,0x03,0x03},
+    {0x3F,0x3F,0xCF,0xCF,0xF3,0xF3,0xFC,0xFC,0xFF,0xFF},
+  },
+  { // 8
+    {0x0F,0x0F,0xF3,0xF3,0xF3,0xF3,0xF3,0xF3,0x0F,0x0F},
+    {0xC3,0xC3,0x3C,0x3C,0x3C,0x3C,0x3C,0x3C,0xC3,0xC3},
+  },
+  { // 9
+    {0x0F,0x0F,0xF3,0xF3,0xF3,0xF3,0xF3,0xF3,0x0F,0x0F},
+    {0x3F,0x3F,0x3C,0x3C,0x3C,0x3C,0xCC,0xCC,0xF0,0xF0},
+  },
+};
+
+// ----------------------------------------------------------------------------------------------------
+void digitCopy(byte *band, byte bandPage, byte x, byte page, const byte *bitmap, byte width, byte pages)
+{
+  if (bandPage >= page && bandPage < page + pages)
+  {
+    memcpy_P(band + x, bitmap + (bandPage - page) * width, width);
+  }
+}
@@ -0,0 +1,28 @@
+#ifndef CLOCKDIGITS_H_
+#define CLOCKDIGITS_H_
+
+// Pre-rendered clock digits for the SSD1306.
+//
+// The digits are the Adafruit GFX 5x7 font scaled by 3 (hours and minutes)
+// and by 2 (seconds), rasterised ahead of time into SSD1306 page format:
+// one byte per column per 8 pixel page, page by page, lit pixels as the white
+// background so they sit in the white band of the clock face. The glyphs start
+// 2 pixels into their first page. Changing a digit is then a transfer of just
+// those columns (StripDisplay::blitP()), instead of a GFX render and a full
+// screen flush.
+
+#include "Arduino.h"
+
+#define LARGE_DIGIT_WIDTH 15
+#define LARGE_DIGIT_PAGES 3
+#define SMALL_DIGIT_WIDTH 10
+#define SMALL_DIGIT_PAGES 2
+
+extern const byte largeDigits[10][LARGE_DIGIT_PAGES][LARGE_DIGIT_WIDTH] PROGMEM;
+extern const byte smallDigits[10][SMALL_DIGIT_PAGES][SMALL_DIGIT_WIDTH] PROGMEM;
+
+// Copies the slice of a page-aligned PROGMEM bitmap that falls in bandPage into
+// a 128 column band buffer (see StripDisplay::getBuffer()).
+extern void digitCopy(byte *band, byte bandPage, byte x, byte page, const byte *bitmap, byte width, byte pages);
+
+#endif
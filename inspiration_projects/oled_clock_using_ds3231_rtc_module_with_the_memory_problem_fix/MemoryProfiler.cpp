@@ -0,0 +1,113 @@
+#include "MemoryProfiler.h"
+
+#define STACK_CANARY 0xC5
+
+// avr-libc internals
+struct __freelist {
+  size_t sz;
+  struct __freelist *nx;
+};
+
+extern char _end;
+extern char __stack;
+extern char __heap_start;
+extern char *__brkval;
+extern struct __freelist *__flp;
+
+// Paints RAM from the end of .bss up to the top of the stack before main() runs.
+// Runs in .init1, before r1 is cleared, so it is written in assembler.
+void memoryPaint() __attribute__ ((naked, used, section (".init1")));
+
+void memoryPaint()
+{
+  __asm volatile ("    ldi r30,lo8(_end)\n"
+                  "    ldi r31,hi8(_end)\n"
+                  "    ldi r24,lo8(0xC5)\n"   // STACK_CANARY
+                  "    ldi r25,hi8(__stack)\n"
+                  "    rjmp 2f\n"
+                  "1:\n"
+                  "    st Z+,r24\n"
+                  "2:\n"
+                  "    cpi r30,lo8(__stack)\n"
+                  "    cpc r31,r25\n"
+                  "    brlo 1b\n"
+                  "    breq 1b" ::);
+}
+
+// ----------------------------------------------------------------------------------------------------
+void memoryStats(MemoryStats *stats)
+{
+  char *heapEnd = (__brkval) ? __brkval : &__heap_start;
+  char *stackPointer = (char *)SP;
+
+  stats->heapUsed = heapEnd - &__heap_start;
+
+  // Free list: freed blocks below the heap break.
+  unsigned int freeTotal = 0;
+  unsigned int freeLargest = 0;
+  unsigned char freeBlocks = 0;
+
+  for (struct __freelist *block = __flp; block; block = block->nx)
+  {
+    freeTotal += block->sz;
+    if (block->sz > freeLargest)
+    {
+      freeLargest = block->sz;
+    }
+    freeBlocks++;
+  }
+
+  // Gap between the heap break and the stack, less malloc's stack margin.
+  unsigned int gap = (stackPointer > heapEnd) ? stackPointer - heapEnd : 0;
+  gap = (gap > __malloc_margin) ? gap - __malloc_margin : 0;
+  freeTotal += gap;
+  if (gap > freeLargest)
+  {
+    freeLargest = gap;
+  }
+
+  stats->freeTotal = freeTotal;
+  stats->freeLargest = freeLargest;
+  stats->freeBlocks = freeBlocks;
+
+  // Stack: the first overwritten canary above the heap marks the deepest point reached.
+  char *p = heapEnd;
+  while (p < stackPointer && *(unsigned char *)p == STACK_CANARY)
+  {
+    p++;
+  }
+  stats->headroom = p - heapEnd;
+  stats->stackUsed = &__stack - stackPointer;
+  stats->stackMax = &__stack - p + 1;
+}
+
+// ----------------------------------------------------------------------------------------------------
+bool memoryWithinBudget()
+{
+  MemoryStats stats;
+  memoryStats(&stats);
+  return stats.headroom >= MEMORY_BUDGET_HEADROOM;
+}
+
+// ----------------------------------------------------------------------------------------------------
+void memoryReport(Print &out)
+{
+  MemoryStats stats;
+  memoryStats(&stats);
+
+  out.print(F("heap "));
+  out.print(stats.heapUsed);
+  out.print(F(" free "));
+  out.print(stats.freeTotal);
+  out.print('/');
+  out.print(stats.freeLargest);
+  out.print(F(" ("));
+  out.print(stats.freeBlocks);
+  out.print(F(") stack "));
+  out.print(stats.stackUsed);
+  out.print('/');
+  out.print(stats.stackMax);
+  out.print(F(" room "));
+  out.print(stats.headroom);
+  out.println((stats.headroom >= MEMORY_BUDGET_HEADROOM) ? F(" OK") : F(" OVER BUDGET"));
+}
@@ -0,0 +1,37 @@
+#ifndef MEMORYPROFILER_H_
+#define MEMORYPROFILER_H_
+
+// RAM profiler for the ATmega328 (2 KB SRAM).
+//
+// At reset, everything between the end of .bss and the top of RAM is painted
+// with a canary byte. The stack high-water mark is then the lowest address
+// the stack has overwritten. The malloc free list is walked to compare the
+// largest free block against the total free memory, which shows
+// fragmentation from String churn. Heap that grew and was released again
+// also counts as touched, so the stack figure is an upper bound.
+
+#include "Arduino.h"
+
+// Warn when the untouched gap between heap and stack drops below this.
+#ifndef MEMORY_BUDGET_HEADROOM
+#define MEMORY_BUDGET_HEADROOM 128
+#endif
+
+typedef struct MemoryStats {
+  unsigned int heapUsed;        // bytes from __heap_start to the heap break
+  unsigned int freeTotal;       // free-list blocks plus the gap between heap and stack
+  unsigned int freeLargest;     // largest single block malloc() could return
+  unsigned char freeBlocks;     // number of blocks on the free list
+  unsigned int stackUsed;       // current stack depth
+  unsigned int stackMax;        // deepest stack seen since reset
+  unsigned int headroom;        // never-touched bytes between heap and stack
+} MemoryStats;
+
+// Takes a snapshot of the heap and stack.
+extern void memoryStats(MemoryStats *stats);
+// Returns true if the never-touched headroom is at least MEMORY_BUDGET_HEADROOM.
+extern bool memoryWithinBudget();
+// Writes a one-line report, e.g. "heap 1041 free 612/580 (2) stack 94/210 room 370 OK".
+extern void memoryReport(Print &out);
+
+#endif
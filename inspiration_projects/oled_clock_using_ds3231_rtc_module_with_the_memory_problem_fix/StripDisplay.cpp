@@ -0,0 +1,187 @@
+#include "StripDisplay.h"
+#include <Wire.h>
+
+// The Wire buffer is 32 bytes, one of which is the control byte.
+#define DATA_CHUNK 31
+
+// Power-up sequence for a 128x64 panel with the internal charge pump.
+static const byte initSequence[] PROGMEM = {
+  0xAE,         // display off
+  0xD5, 0x80,   // clock divide ratio
+  0xA8, 0x3F,   // multiplex ratio, 64 rows
+  0xD3, 0x00,   // display offset
+  0x40,         // start line 0
+  0x8D, 0x14,   // charge pump on
+  0x20, 0x00,   // horizontal addressing mode
+  0xA1,         // column 127 mapped to SEG0
+  0xC8,         // scan COM63 to COM0
+  0xDA, 0x12,   // COM pins configuration
+  0x81, 0xCF,   // contrast
+  0xD9, 0xF1,   // precharge period
+  0xDB, 0x40,   // VCOMH deselect level
+  0xA4,         // display follows RAM
+  0xA6,         // not inverted
+  0x2E,         // scrolling off
+  0xAF          // display on
+};
+
+// ----------------------------------------------------------------------------------------------------
+StripDisplay::StripDisplay(byte address) : Adafruit_GFX(STRIP_WIDTH, STRIP_HEIGHT), address(address), bandPage(0)
+{
+}
+
+// ----------------------------------------------------------------------------------------------------
+bool StripDisplay::begin()
+{
+  Wire.begin();
+  Wire.beginTransmission(address);
+  Wire.write((byte)0x00);               // command stream
+  for (byte i = 0; i < sizeof(initSequence); i++)
+  {
+    Wire.write(pgm_read_byte(&initSequence[i]));
+  }
+  return Wire.endTransmission() == 0;
+}
+
+// ----------------------------------------------------------------------------------------------------
+void StripDisplay::setWindow(byte firstPage, byte lastPage, byte firstCol, byte lastCol)
+{
+  // In horizontal addressing mode the data wraps from page to page inside this window.
+  Wire.beginTransmission(address);
+  Wire.write((byte)0x00);               // command stream
+  Wire.write((byte)0x21);               // column address
+  Wire.write(firstCol);
+  Wire.write(lastCol);
+  Wire.write((byte)0x22);               // page address
+  Wire.write(firstPage);
+  Wire.write(lastPage);
+  Wire.endTransmission();
+}
+
+// ----------------------------------------------------------------------------------------------------
+void StripDisplay::sendData(const byte *data, byte count, bool progmem)
+{
+  while (count)
+  {
+    byte chunk = (count > DATA_CHUNK) ? DATA_CHUNK : count;
+
+    Wire.beginTransmission(address);
+    Wire.write((byte)0x40);             // data stream
+    for (byte i = 0; i < chunk; i++)
+    {
+      Wire.write(progmem ? pgm_read_byte(data + i) : data[i]);
+    }
+    Wire.endTransmission();
+    data += chunk;
+    count -= chunk;
+  }
+}
+
+// ----------------------------------------------------------------------------------------------------
+void StripDisplay::render(void (*scene)(StripDisplay &display))
+{
+  render(scene, 0, STRIP_PAGES - 1, 0, STRIP_WIDTH - 1);
+}
+
+// ----------------------------------------------------------------------------------------------------
+void StripDisplay::render(void (*scene)(StripDisplay &display), byte firstPage, byte lastPage, byte firstCol, byte lastCol)
+{
+  setWindow(firstPage, lastPage, firstCol, lastCol);
+  for (bandPage = firstPage; bandPage <= lastPage; bandPage++)
+  {
+    memset(band, 0, sizeof(band));
+    scene(*this);
+    sendData(band + firstCol, lastCol - firstCol + 1, false);
+  }
+  bandPage = firstPage;
+}
+
+// ----------------------------------------------------------------------------------------------------
+byte StripDisplay::page()
+{
+  return bandPage;
+}
+
+// ----------------------------------------------------------------------------------------------------
+byte *StripDisplay::getBuffer()
+{
+  return band;
+}
+
+// ----------------------------------------------------------------------------------------------------
+void StripDisplay::blitP(byte x, byte page, const byte *bitmap, byte width, byte pages)
+{
+  setWindow(page, page + pages - 1, x, x + width - 1);
+  for (byte p = 0; p < pages; p++)
+  {
+    sendData(bitmap + p * width, width, true);
+  }
+}
+
+// ----------------------------------------------------------------------------------------------------
+void StripDisplay::drawPixel(int16_t x, int16_t y, uint16_t color)
+{
+  fillRect(x, y, 1, 1, color);
+}
+
+// ----------------------------------------------------------------------------------------------------
+void StripDisplay::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color)
+{
+  fillRect(x, y, 1, h, color);
+}
+
+// ----------------------------------------------------------------------------------------------------
+void StripDisplay::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+{
+  fillRect(x, y, w, 1, color);
+}
+
+// ----------------------------------------------------------------------------------------------------
+void StripDisplay::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+  int16_t top = bandPage * 8;
+
+  // Clip to the screen width and the current band
+  if (x < 0)
+  {
+    w += x;
+    x = 0;
+  }
+  if (x + w > STRIP_WIDTH)
+  {
+    w = STRIP_WIDTH - x;
+  }
+  if (y < top)
+  {
+    h -= top - y;
+    y = top;
+  }
+  if (y + h > top + 8)
+  {
+    h = top + 8 - y;
+  }
+  if (w <= 0 || h <= 0)
+  {
+    return;
+  }
+
+  byte mask = ((1 << h) - 1) << (y - top);
+  byte *column = band + x;
+
+  while (w--)
+  {
+    switch (color)
+    {
+      case STRIP_WHITE: *column |= mask; break;
+      case STRIP_BLACK: *column &= ~mask; break;
+      case STRIP_INVERSE: *column ^= mask; break;
+    }
+    column++;
+  }
+}
+
+// ----------------------------------------------------------------------------------------------------
+void StripDisplay::fillScreen(uint16_t color)
+{
+  fillRect(0, 0, STRIP_WIDTH, STRIP_HEIGHT, color);
+}
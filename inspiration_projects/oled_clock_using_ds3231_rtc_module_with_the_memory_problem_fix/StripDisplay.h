@@ -0,0 +1,62 @@
+#ifndef STRIPDISPLAY_H_
+#define STRIPDISPLAY_H_
+
+// Page-band renderer for a 128x64 SSD1306 on I2C.
+//
+// Instead of a 1 KB framebuffer, only one 8 pixel high page (128 bytes) is
+// held in RAM. render() clears the band, calls the scene callback to draw the
+// whole screen with the usual Adafruit_GFX calls (anything outside the band is
+// clipped away), streams the band to the panel and moves on to the next page.
+// The scene therefore runs once per page, so it should only draw from state
+// prepared beforehand (no sensor reads or String building inside it).
+//
+// Rotation is not supported.
+
+#include "Arduino.h"
+#include <Adafruit_GFX.h>
+
+#define STRIP_WIDTH   128
+#define STRIP_HEIGHT  64
+#define STRIP_PAGES   (STRIP_HEIGHT / 8)
+
+#define STRIP_BLACK   0
+#define STRIP_WHITE   1
+#define STRIP_INVERSE 2
+
+class StripDisplay : public Adafruit_GFX
+{
+  public:
+    StripDisplay(byte address = 0x3C);
+
+    // Initialises the controller. Returns false if it does not answer.
+    bool begin();
+
+    // Draws the scene page by page and sends the whole screen.
+    void render(void (*scene)(StripDisplay &display));
+    // Same, but only pages firstPage..lastPage and columns firstCol..lastCol are drawn and sent.
+    void render(void (*scene)(StripDisplay &display), byte firstPage, byte lastPage, byte firstCol, byte lastCol);
+
+    // Page being drawn by render() and its 128 byte buffer (column x is buffer[x], bit 0 on top).
+    byte page();
+    byte *getBuffer();
+
+    // Sends a PROGMEM bitmap in page format (width bytes per page, page by page) straight to the panel.
+    void blitP(byte x, byte page, const byte *bitmap, byte width, byte pages);
+
+    // Adafruit_GFX
+    void drawPixel(int16_t x, int16_t y, uint16_t color);
+    void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+    void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+    void fillScreen(uint16_t color);
+
+  private:
+    void setWindow(byte firstPage, byte lastPage, byte firstCol, byte lastCol);
+    void sendData(const byte *data, byte count, bool progmem);
+
+    byte address;
+    byte bandPage;
+    byte band[STRIP_WIDTH];
+};
+
+#endif
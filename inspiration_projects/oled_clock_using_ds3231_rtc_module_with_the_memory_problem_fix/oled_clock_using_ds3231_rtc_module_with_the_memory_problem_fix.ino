@@ -1,43 +1,54 @@
 //Marios Ideas
 //DS3231 Tutorial
-//Using DS3232.h library
+//Using one burst read of all DS3231 registers (Ds3231Regs.h)
 //Formating date and time with custom functions
 
 #include <Wire.h>
-#include <DS3231.h>
 #include <Adafruit_GFX.h>
-#include <Adafruit_SSD1306.h>
+#include "MemoryProfiler.h"
+#include "ClockDigits.h"
+#include "StripDisplay.h"
+#include "Ds3231Regs.h"
 
 int pause=1000;
 
-DS3231 clock;
-RTCDateTime dt;
-// DateTime dt;
+// Time (in BCD), status and temperature, refreshed by one I2C burst per loop
+Ds3231Registers rtc;
 
-#define SCREEN_WIDTH 128 // OLED display width, in pixels
-#define SCREEN_HEIGHT 64 // OLED display height, in pixels
+#define SCREEN_ADDRESS 0x3C
 
+// 128x64 panel drawn one 8 row page at a time, 128 bytes of RAM instead of 1 KB
+StripDisplay display(SCREEN_ADDRESS);
 
-#define OLED_RESET     -1// Reset pin # (or -1 if sharing Arduino reset pin)
-Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET);
+// Clock digits are blitted straight to the panel (see ClockDigits.h).
+// HH:MM uses the large digits and the seconds the small ones, all in the white
+// band starting at page 4 (y = 32).
+#define DIGIT_PAGE 4
+const byte digitX[6] = { 3, 21, 57, 75, 100, 112 };
+byte shownDigits[6];          // digits on the panel
+uint8_t shownDay = 0;         // the rest of the face only changes once a day (BCD)...
+uint8_t shownMinute = 0xFF;   // ...and the temperature once a minute (BCD)
+
+// What the face shows, prepared before rendering since the scene is drawn once per page
+String dayText;
+String dateText;
+float temperature;
 
 void setup() {
 Serial.begin(9600);
-    clock.begin();
+    Wire.begin();
   // Set sketch compiling time
-    clock.setDateTime(__DATE__, __TIME__);
+    BcdTime buildTime;
+    bcdFromBuildTime(&buildTime, __DATE__, __TIME__);
+    ds3231SetTime(&buildTime);
  
-   // SSD1306_SWITCHCAPVCC = generate display voltage from 3.3V internally
-  if(!display.begin(SSD1306_SWITCHCAPVCC, 0x3C)) { // Address 0x3D for 128x64
-    Serial.println(F("SSD1306 allocation failed"));
+  if(!display.begin()) { // Address 0x3D for some 128x64 panels
+    Serial.println(F("SSD1306 not found"));
     for(;;); // Don't proceed, loop forever
   }
-  display.display(); //display initial Adafruit logo
-    delay(2000); 
 
-  // Clear the buffer
-  display.clearDisplay(); 
-  display.display();
+  // RAM left with the display running; send 'm' at any time for a fresh report
+  memoryReport(Serial);
 
 }
 
@@ -80,56 +91,105 @@ String DayMonthYear(uint8_t Day,uint8_t Month,uint16_t Year){
   return DayMonthYearText;
 }
 
-String AddLeadingZero(uint8_t x){
-  String AddLeadingZeroText;
-  if(x<10) AddLeadingZeroText="0"; 
-  else AddLeadingZeroText=""; 
-  AddLeadingZeroText=AddLeadingZeroText+x;
-  return AddLeadingZeroText;
+// Splits the current time into the six clock digits, one BCD nibble each
+void getDigits(byte *digits){
+  digits[0] = rtc.time.hour >> 4;
+  digits[1] = rtc.time.hour & 0x0F;
+  digits[2] = rtc.time.minute >> 4;
+  digits[3] = rtc.time.minute & 0x0F;
+  digits[4] = rtc.time.second >> 4;
+  digits[5] = rtc.time.second & 0x0F;
 }
 
-String CurrentTime(uint8_t H, uint8_t I ){
-  String CurrentTimeText="";
-  CurrentTimeText=CurrentTimeText + AddLeadingZero(H) +":"+AddLeadingZero(I);
-  return CurrentTimeText;
+const byte *digitBitmap(byte i, byte digit){
+  return (i < 4) ? &largeDigits[digit][0][0] : &smallDigits[digit][0][0];
 }
 
-void loop() {
-  dt = clock.getDateTime();
+// Sends the digits that changed straight to the panel
+void showDigits(){
+  byte digits[6];
+  getDigits(digits);
+
+  for (byte i = 0; i < 6; i++) {
+    if (digits[i] == shownDigits[i]) continue;
+    shownDigits[i] = digits[i];
+
+    if (i < 4) display.blitP(digitX[i], DIGIT_PAGE, digitBitmap(i, digits[i]), LARGE_DIGIT_WIDTH, LARGE_DIGIT_PAGES);
+    else display.blitP(digitX[i], DIGIT_PAGE, digitBitmap(i, digits[i]), SMALL_DIGIT_WIDTH, SMALL_DIGIT_PAGES);
+  }
+}
 
-  display.fillRect(0,0,128,16,SSD1306_WHITE);
-  display.fillRect(0,17,128,16,SSD1306_BLACK);
-  display.fillRect(0,31,128,33,SSD1306_WHITE);
+// The whole face. Called by display.render() once for each page.
+void drawFace(StripDisplay &display){
+  display.fillRect(0,0,128,16,STRIP_WHITE);
+  display.fillRect(0,17,128,16,STRIP_BLACK);
+  display.fillRect(0,31,128,33,STRIP_WHITE);
 
     display.setCursor(1,1); 
     display.setTextSize(2);
-    display.setTextColor(SSD1306_BLACK); 
-    display.println(DayOfTheWeek(dt.dayOfWeek));
+    display.setTextColor(STRIP_BLACK); 
+    display.println(dayText);
 
   display.setCursor(1,18); 
   display.setTextSize(1);
-  display.setTextColor(SSD1306_WHITE); 
-  display.println(DayMonthYear(dt.day,dt.month,dt.year));
+  display.setTextColor(STRIP_WHITE); 
+  display.println(dateText);
 
-    display.setCursor(3,35); 
-    display.setTextSize(3);  
-    display.setTextColor(SSD1306_BLACK); 
-    display.println(CurrentTime(dt.hour,dt.minute));
-
-  display.setCursor(100,35); 
-  display.setTextSize(2);
-  display.setTextColor(SSD1306_BLACK); 
-  display.println(AddLeadingZero(dt.second));
-
-  clock.forceConversion();
   display.setCursor(85,18); 
-  display.setTextSize(1);
-display.setTextColor(SSD1306_WHITE); 
-display.print(clock.readTemperature());
+  display.print(temperature);
 display.setCursor(117,16); 
 display.print("o");
 
+    // The colon between hours and minutes never changes
+    display.setCursor(39,34); 
+    display.setTextSize(3);  
+    display.setTextColor(STRIP_BLACK); 
+    display.print(':');
 
-  display.display();
-  delay(1000);
+  for (byte i = 0; i < 6; i++) {
+    byte width = (i < 4) ? LARGE_DIGIT_WIDTH : SMALL_DIGIT_WIDTH;
+    byte pages = (i < 4) ? LARGE_DIGIT_PAGES : SMALL_DIGIT_PAGES;
+    digitCopy(display.getBuffer(), display.page(), digitX[i], DIGIT_PAGE, digitBitmap(i, shownDigits[i]), width, pages);
+  }
+}
+
+// Takes the temperature from the last read and asks for a fresh conversion,
+// which will be in the registers well before the next minute
+void readTemperature(){
+  temperature = rtc.temperature / 256.0;
+  ds3231StartConversion(&rtc);
+}
+
+void loop() {
+  if (!ds3231Read(&rtc)) {
+    delay(100);
+    return;
+  }
+
+  if (rtc.time.date != shownDay) {
+    shownDay = rtc.time.date;
+    shownMinute = rtc.time.minute;
+    dayText = DayOfTheWeek(rtc.time.dayOfWeek);
+    dateText = DayMonthYear(bcdToBin(rtc.time.date),bcdToBin(rtc.time.month),2000+bcdToBin(rtc.time.year));
+    readTemperature();
+    getDigits(shownDigits);
+    display.render(drawFace);
+  }
+  else {
+    if (rtc.time.minute != shownMinute) {
+      shownMinute = rtc.time.minute;
+      readTemperature();
+      // Only the temperature: pages 2-3, columns 85-116
+      display.render(drawFace, 2, 3, 85, 116);
+    }
+    // Usually just the seconds digit, 20 bytes
+    showDigits();
+  }
+
+  if (Serial.available() && Serial.read() == 'm') {
+    memoryReport(Serial);
+  }
+  // Poll often enough that the seconds tick with the RTC; nothing is sent
+  // unless a digit changed.
+  delay(100);
 }
@@ -402,7 +402,7 @@ void callAlarm(){
   if (aM==sM && aH==sH && S>=0 && S<=2){
     turnItOn = true;
   }
-  if(alarm_state==LOW || (M==(AM+5))){
+  if(alarm_state==LOW || (M==((AM+5) % 60))){
     turnItOn = false;
     alarmON=true;
     delay(500);
@@ -0,0 +1,211 @@
+#include "At24c32.h"
+#include <Wire.h>
+#include <util/twi.h>
+
+#define WIRE_CHUNK        32        // Wire's BUFFER_LENGTH
+#define READY_POLLS       200       // about 20 ms of polling at 100 kHz, twice the longest write
+#define TWI_TIMEOUT       10000     // loop turns to wait for one bus step, a few ms
+
+static byte page[AT24C32_PAGE_SIZE];    // the page being appended to
+static unsigned int pageAddress;
+static byte written;                    // bytes of page[] already on the chip
+static byte fill;                       // bytes of page[] in use
+static bool writing = false;            // a write cycle may still be running
+
+// ----------------------------------------------------------------------------------------------------
+// Waits for the TWI hardware to finish a step and returns its status, 0 on timeout.
+static byte twiWait()
+{
+  for (unsigned int i = 0; i < TWI_TIMEOUT; i++)
+  {
+    if (TWCR & _BV(TWINT))
+    {
+      return TW_STATUS;
+    }
+  }
+  return 0;
+}
+
+// ----------------------------------------------------------------------------------------------------
+static bool twiSend(byte value, byte expected)
+{
+  TWDR = value;
+  TWCR = _BV(TWINT) | _BV(TWEN);
+  return twiWait() == expected;
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Writes up to a page in one transaction. The TWI interrupt is kept off so
+// Wire's handler stays out of it, and Wire's idle state is restored afterwards.
+static bool writePage(unsigned int address, const byte *data, byte length)
+{
+  TWCR = _BV(TWINT) | _BV(TWSTA) | _BV(TWEN);
+  bool ok = twiWait() == TW_START &&
+            twiSend(AT24C32_ADDRESS << 1, TW_MT_SLA_ACK) &&
+            twiSend(address >> 8, TW_MT_DATA_ACK) &&
+            twiSend(address, TW_MT_DATA_ACK);
+
+  while (ok && length--)
+  {
+    ok = twiSend(*data++, TW_MT_DATA_ACK);
+  }
+
+  TWCR = _BV(TWINT) | _BV(TWSTO) | _BV(TWEN);
+  for (unsigned int i = 0; i < TWI_TIMEOUT && (TWCR & _BV(TWSTO)); i++)
+  {
+  }
+  TWCR = _BV(TWEN) | _BV(TWIE) | _BV(TWEA);
+
+  writing = true;
+  return ok;
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Polls until the last write has finished. Returns false if the chip never answers.
+static bool waitReady()
+{
+  if (!writing)
+  {
+    return true;
+  }
+  for (byte i = 0; i < READY_POLLS; i++)
+  {
+    if (!at24Busy())
+    {
+      writing = false;
+      return true;
+    }
+  }
+  return false;
+}
+
+// ----------------------------------------------------------------------------------------------------
+bool at24Busy()
+{
+  Wire.beginTransmission(AT24C32_ADDRESS);
+  return Wire.endTransmission() != 0;
+}
+
+// ----------------------------------------------------------------------------------------------------
+bool at24Read(unsigned int address, void *data, unsigned int length)
+{
+  byte *p = (byte *)data;
+
+  address %= AT24C32_SIZE;
+  if (!waitReady())
+  {
+    return false;
+  }
+
+  Wire.beginTransmission(AT24C32_ADDRESS);
+  Wire.write((byte)(address >> 8));
+  Wire.write((byte)address);
+  if (Wire.endTransmission() != 0)
+  {
+    return false;
+  }
+
+  for (unsigned int done = 0; done < length; )
+  {
+    byte chunk = (length - done < WIRE_CHUNK) ? length - done : WIRE_CHUNK;
+
+    if (Wire.requestFrom((byte)AT24C32_ADDRESS, chunk) != chunk)
+    {
+      return false;
+    }
+    while (chunk--)
+    {
+      // The chip has the old contents of bytes that are only buffered so far
+      unsigned int offset = (address + done - pageAddress) % AT24C32_SIZE;
+      byte value = Wire.read();
+
+      p[done++] = (offset >= written && offset < fill) ? page[offset] : value;
+    }
+  }
+  return true;
+}
+
+// ----------------------------------------------------------------------------------------------------
+bool at24Write(unsigned int address, const void *data, unsigned int length)
+{
+  const byte *p = (const byte *)data;
+
+  while (length)
+  {
+    address %= AT24C32_SIZE;
+
+    byte room = AT24C32_PAGE_SIZE - address % AT24C32_PAGE_SIZE;
+    byte count = (length < room) ? length : room;
+
+    if (!waitReady() || !writePage(address, p, count))
+    {
+      return false;
+    }
+    address += count;
+    p += count;
+    length -= count;
+  }
+  return true;
+}
+
+// ----------------------------------------------------------------------------------------------------
+void at24AppendBegin(unsigned int address)
+{
+  address %= AT24C32_SIZE;
+  pageAddress = address - address % AT24C32_PAGE_SIZE;
+  written = address % AT24C32_PAGE_SIZE;
+  fill = written;
+}
+
+// ----------------------------------------------------------------------------------------------------
+bool at24Append(const void *data, unsigned int length)
+{
+  const byte *p = (const byte *)data;
+
+  while (length)
+  {
+    byte count = AT24C32_PAGE_SIZE - fill;
+
+    if (length < count)
+    {
+      count = length;
+    }
+    memcpy(page + fill, p, count);
+    fill += count;
+    p += count;
+    length -= count;
+
+    if (fill == AT24C32_PAGE_SIZE)
+    {
+      if (!at24AppendFlush())
+      {
+        return false;
+      }
+      pageAddress = (pageAddress + AT24C32_PAGE_SIZE) % AT24C32_SIZE;
+      written = 0;
+      fill = 0;
+    }
+  }
+  return true;
+}
+
+// ----------------------------------------------------------------------------------------------------
+bool at24AppendFlush()
+{
+  if (fill == written)
+  {
+    return true;
+  }
+  if (!waitReady() || !writePage(pageAddress + written, page + written, fill - written))
+  {
+    return false;
+  }
+  written = fill;
+  return true;
+}
+
+// ----------------------------------------------------------------------------------------------------
+unsigned int at24AppendAddress()
+{
+  return pageAddress + fill;
+}
@@ -0,0 +1,42 @@
+#ifndef AT24C32_H_
+#define AT24C32_H_
+
+// Driver for the AT24C32 EEPROM (4 KB) on the usual DS3231 breakout.
+//
+// Appended bytes collect in a RAM copy of the current 32 byte page, and a
+// page goes to the chip in one I2C transaction when it is full or on
+// at24AppendFlush(). Wire's 32 byte buffer has no room for a full page plus
+// its two address bytes, so page writes drive the TWI hardware directly;
+// everything else goes through Wire. After a write the chip does not answer
+// for up to 10 ms, so the next access polls for its ACK instead of waiting a
+// fixed time, and usually finds it ready straight away.
+//
+// Reads set the address once and then use the chip's own address counter for
+// as many Wire sized chunks as needed. Bytes still in the append buffer are
+// read from there.
+
+#include "Arduino.h"
+
+#define AT24C32_ADDRESS     0x57    // A0-A2 pulled up on the DS3231 module
+#define AT24C32_SIZE        4096
+#define AT24C32_PAGE_SIZE   32
+
+// Reads length bytes from address on, wrapping at the end. Returns false if the chip does not answer.
+extern bool at24Read(unsigned int address, void *data, unsigned int length);
+
+// Writes length bytes from address on, one transaction per page touched.
+extern bool at24Write(unsigned int address, const void *data, unsigned int length);
+
+// True while the chip is still busy with the last write (one ACK poll).
+extern bool at24Busy();
+
+// Appending: sets where the next appended byte goes. Anything still buffered is dropped.
+extern void at24AppendBegin(unsigned int address);
+// Buffers bytes, writing each page as it fills up. Wraps at the end of the chip.
+extern bool at24Append(const void *data, unsigned int length);
+// Writes the buffered part of the current page.
+extern bool at24AppendFlush();
+// Where the next appended byte goes.
+extern unsigned int at24AppendAddress();
+
+#endif
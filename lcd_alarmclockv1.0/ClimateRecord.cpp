@@ -0,0 +1,66 @@
+#include "ClimateRecord.h"
+#include "Varint.h"
+
+#define KEYFRAME  0
+
+// ----------------------------------------------------------------------------------------------------
+byte climateEncode(byte *dest, const ClimateSample *sample, const ClimateSample *previous)
+{
+  byte *p = dest;
+
+  if (previous == NULL || sample->minuteOfDay <= previous->minuteOfDay)
+  {
+    *p++ = KEYFRAME;
+    p = varintWrite(p, sample->minuteOfDay);
+    p = varintWrite(p, zigzagEncode(sample->celsius));
+    p = varintWrite(p, zigzagEncode(sample->humidity));
+  }
+  else
+  {
+    p = varintWrite(p, sample->minuteOfDay - previous->minuteOfDay);
+    p = varintWrite(p, zigzagEncode((int32_t)sample->celsius - previous->celsius));
+    p = varintWrite(p, zigzagEncode((int32_t)sample->humidity - previous->humidity));
+  }
+  return p - dest;
+}
+
+// ----------------------------------------------------------------------------------------------------
+bool climateDecode(const byte *src, byte length, ClimateSample *sample)
+{
+  const byte *end = src + length;
+  uint32_t minutes;
+  uint32_t celsius;
+  uint32_t humidity;
+
+  if (length == 0)
+  {
+    return false;
+  }
+
+  bool keyframe = (*src == KEYFRAME);
+
+  if (keyframe)
+  {
+    src++;
+  }
+  if ((src = varintRead(src, end, &minutes)) == NULL ||
+      (src = varintRead(src, end, &celsius)) == NULL ||
+      (src = varintRead(src, end, &humidity)) == NULL)
+  {
+    return false;
+  }
+
+  if (keyframe)
+  {
+    sample->minuteOfDay = minutes;
+    sample->celsius = zigzagDecode(celsius);
+    sample->humidity = zigzagDecode(humidity);
+  }
+  else
+  {
+    sample->minuteOfDay += minutes;
+    sample->celsius += zigzagDecode(celsius);
+    sample->humidity += zigzagDecode(humidity);
+  }
+  return true;
+}
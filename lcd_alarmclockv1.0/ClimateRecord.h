@@ -0,0 +1,37 @@
+#ifndef CLIMATERECORD_H_
+#define CLIMATERECORD_H_
+
+// Climate samples for the history log (see FlashLog.h), stored as changes.
+//
+// Ten minutes on, a sample is rarely more than a degree or a few percent
+// away from the one before it, so it is stored as the differences in varints
+// (see Varint.h): 3 bytes instead of 6 for most samples. The first sample of
+// a day, and the first after a reset, is a keyframe with the full values.
+// FlashLog seeks to the start of a day, so reading a day never needs a record
+// from an earlier one.
+//
+// Keyframe:  [0] [minuteOfDay] [celsius] [humidity]
+// Change:    [minutes since the last sample, 1 or more] [celsius change] [humidity change]
+//
+// Temperatures, humidities and their changes are zigzag mapped.
+
+#include "Arduino.h"
+#include "SensorMath.h"
+
+#define CLIMATE_RECORD_MAX  9
+
+typedef struct ClimateSample {
+  unsigned int minuteOfDay;
+  q8_8_t celsius;
+  q8_8_t humidity;
+} ClimateSample;
+
+// Encodes sample as a change from previous, or as a keyframe if previous is
+// NULL or not earlier in the day. Returns the length.
+extern byte climateEncode(byte *dest, const ClimateSample *sample, const ClimateSample *previous);
+
+// Decodes a record into sample, which must hold the previous sample for a
+// change. Returns false if the record is malformed.
+extern bool climateDecode(const byte *src, byte length, ClimateSample *sample);
+
+#endif
@@ -0,0 +1,124 @@
+#include "CsvExport.h"
+#include "SessionLog.h"
+#include "BcdTime.h"
+
+#define ROW_SIZE          44          // the longest row, "2099-12-31,23:59:59,short break,65535,1\r\n", and a terminator
+#define SECONDS_PER_DAY   86400UL
+
+static const char header[] PROGMEM = "date,start,phase,duration_s,interrupted\r\n";
+
+static const char focusName[] PROGMEM = "focus";
+static const char shortBreakName[] PROGMEM = "short break";
+static const char longBreakName[] PROGMEM = "long break";
+static const char *const phaseNames[] PROGMEM = { focusName, shortBreakName, longBreakName };
+
+static HardwareSerial *port;
+static char row[ROW_SIZE];
+static byte length;               // of the row in the buffer
+static byte sent;                 // bytes of it already handed to the port
+static SessionCursor cursor;
+static bool running = false;
+
+// ----------------------------------------------------------------------------------------------------
+// Formats the next session into the row buffer. Returns false after the last one.
+static bool formatRow()
+{
+  SessionRecord record;
+
+  if (!sessionLogNext(&cursor, &record))
+  {
+    return false;
+  }
+
+  BcdTime t;
+  unsigned long seconds = record.start % SECONDS_PER_DAY;
+  char *p = row;
+
+  bcdFromDayNumber(&t, record.start / SECONDS_PER_DAY);
+  *p++ = '2';
+  *p++ = '0';
+  p = bcdFormat(p, t.year);
+  *p++ = '-';
+  p = bcdFormat(p, t.month);
+  *p++ = '-';
+  p = bcdFormat(p, t.date);
+  *p++ = ',';
+
+  p = bcdFormat(p, binToBcd(seconds / 3600));
+  *p++ = ':';
+  p = bcdFormat(p, binToBcd(seconds / 60 % 60));
+  *p++ = ':';
+  p = bcdFormat(p, binToBcd(seconds % 60));
+  *p++ = ',';
+
+  if (record.phase <= SESSION_LONG_BREAK)
+  {
+    strcpy_P(p, (const char *)pgm_read_word(&phaseNames[record.phase]));
+    p += strlen(p);
+  }
+  *p++ = ',';
+
+  utoa(record.duration, p, 10);
+  p += strlen(p);
+  *p++ = ',';
+  *p++ = (record.flags & SESSION_INTERRUPTED) ? '1' : '0';
+  *p++ = '\r';
+  *p++ = '\n';
+
+  length = p - row;
+  sent = 0;
+  return true;
+}
+
+// ----------------------------------------------------------------------------------------------------
+void csvExportBegin(HardwareSerial &serial)
+{
+  port = &serial;
+  sessionLogSeek(&cursor, 0);
+
+  strcpy_P(row, header);
+  length = strlen(row);
+  sent = 0;
+  running = true;
+}
+
+// ----------------------------------------------------------------------------------------------------
+bool csvExportUpdate()
+{
+  if (!running)
+  {
+    return false;
+  }
+
+  int room = port->availableForWrite();
+
+  while (room > 0)
+  {
+    if (sent == length && !formatRow())
+    {
+      running = false;
+      return false;
+    }
+
+    byte count = (room < length - sent) ? room : length - sent;
+
+    port->write((const uint8_t *)row + sent, count);
+    sent += count;
+    room -= count;
+  }
+  return true;
+}
+
+// ----------------------------------------------------------------------------------------------------
+bool csvExportRunning()
+{
+  return running;
+}
+
+// ----------------------------------------------------------------------------------------------------
+byte csvExportProgress()
+{
+  byte pages = sessionLogPages();
+
+  return (running && pages != 0) ? sessionLogPosition(&cursor) * 100U / pages : 100;
+}
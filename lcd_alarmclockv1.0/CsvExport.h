@@ -0,0 +1,29 @@
+#ifndef CSVEXPORT_H_
+#define CSVEXPORT_H_
+
+// Streams the session log (see SessionLog.h) out of a serial port as CSV:
+//
+//   date,start,phase,duration_s,interrupted
+//   2022-09-30,13:35:00,focus,1500,0
+//
+// There is no room to build the file, so one row at a time is formatted into
+// a small buffer and handed to the port only as fast as its transmit buffer
+// empties. csvExportUpdate() never waits for the UART, so the loop, and with
+// it the clock and the display, keeps running for the whole export.
+//
+// Sessions that close during the export are included. Once the log is full,
+// each new page drops the oldest one, which the export may have sent already.
+
+#include "Arduino.h"
+
+// Starts an export to port, header row first.
+extern void csvExportBegin(HardwareSerial &port);
+// Writes as much as the port has room for. Call every loop; returns false once done.
+extern bool csvExportUpdate();
+// True from csvExportBegin() until the last row is written.
+extern bool csvExportRunning();
+
+// How far the export has got, in percent of the log's pages.
+extern byte csvExportProgress();
+
+#endif
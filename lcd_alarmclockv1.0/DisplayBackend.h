@@ -0,0 +1,40 @@
+#ifndef DISPLAYBACKEND_H_
+#define DISPLAYBACKEND_H_
+
+// Backend interface for the widget layer (see Widgets.h).
+//
+// Positions are in character cells: 5x8 characters on an HD44780, 8x8 tiles
+// on an SSD1306. Each backend keeps a shadow copy of what is on the panel and
+// only sends cells that actually change, so screens can redraw everything
+// every time without caring about update cost.
+
+#include "Arduino.h"
+
+class DisplayBackend
+{
+  public:
+    // Size of the panel in cells.
+    virtual byte columns() = 0;
+    virtual byte rows() = 0;
+
+    // Blanks the panel.
+    virtual void clear() = 0;
+
+    // Writes text at a cell position, truncated or padded with spaces to width cells.
+    virtual void drawText(byte col, byte row, const char *text, byte width) = 0;
+
+    // Draws a two row high character ('0'..'9', ':' or ' ') and returns the
+    // number of cells it advanced.
+    virtual byte drawBigChar(byte col, byte row, char c) = 0;
+
+    // Number of fill levels in one bar cell (a full cell is barSteps()).
+    virtual byte barSteps() = 0;
+    // Draws one cell of a horizontal bar, level 0 (empty) to barSteps() (full).
+    virtual void drawBarCell(byte col, byte row, byte level) = 0;
+
+    // Draws a 5x8 icon stored in PROGMEM in HD44780 custom character format
+    // (eight rows, low five bits used). NULL blanks the cell.
+    virtual void drawIcon(byte col, byte row, const byte *bitmap) = 0;
+};
+
+#endif
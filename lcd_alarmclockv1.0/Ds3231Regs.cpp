@@ -0,0 +1,84 @@
+#include "Ds3231Regs.h"
+#include <Wire.h>
+
+#define REG_SECONDS   0x00
+#define REG_CONTROL   0x0E
+#define REG_STATUS    0x0F
+#define REG_COUNT     0x13
+
+// ----------------------------------------------------------------------------------------------------
+static bool writeRegister(byte reg, byte value)
+{
+  Wire.beginTransmission(DS3231_ADDRESS);
+  Wire.write(reg);
+  Wire.write(value);
+  return Wire.endTransmission() == 0;
+}
+
+// ----------------------------------------------------------------------------------------------------
+bool ds3231Read(Ds3231Registers *regs)
+{
+  Wire.beginTransmission(DS3231_ADDRESS);
+  Wire.write((byte)REG_SECONDS);
+  if (Wire.endTransmission() != 0 || Wire.requestFrom(DS3231_ADDRESS, REG_COUNT) != REG_COUNT)
+  {
+    return false;
+  }
+
+  regs->time.second = Wire.read() & 0x7F;
+  regs->time.minute = Wire.read() & 0x7F;
+  regs->time.hour = Wire.read() & 0x3F;
+  regs->time.dayOfWeek = Wire.read() & 0x07;
+  regs->time.date = Wire.read() & 0x3F;
+  regs->time.month = Wire.read() & 0x1F;
+  regs->time.year = Wire.read();
+
+  for (byte i = 0; i < sizeof(regs->alarm1); i++)
+  {
+    regs->alarm1[i] = Wire.read();
+  }
+  for (byte i = 0; i < sizeof(regs->alarm2); i++)
+  {
+    regs->alarm2[i] = Wire.read();
+  }
+  regs->control = Wire.read();
+  regs->status = Wire.read();
+  regs->aging = Wire.read();
+
+  byte msb = Wire.read();
+  byte lsb = Wire.read();
+  regs->temperature = (int16_t)((msb << 8) | lsb);
+  return true;
+}
+
+// ----------------------------------------------------------------------------------------------------
+bool ds3231SetTime(const BcdTime *t)
+{
+  Wire.beginTransmission(DS3231_ADDRESS);
+  Wire.write((byte)REG_SECONDS);
+  Wire.write(t->second);
+  Wire.write(t->minute);
+  Wire.write(t->hour);          // bit 6 clear selects 24 hour mode
+  Wire.write(t->dayOfWeek);
+  Wire.write(t->date);
+  Wire.write(t->month);
+  Wire.write(t->year);
+  if (Wire.endTransmission() != 0)
+  {
+    return false;
+  }
+
+  // The time is valid from now on: clear OSF. Alarm flags written as 1 are left
+  // alone; the 32 kHz output, unused here, is switched off.
+  return writeRegister(REG_STATUS, DS3231_A2F | DS3231_A1F);
+}
+
+// ----------------------------------------------------------------------------------------------------
+bool ds3231StartConversion(const Ds3231Registers *regs)
+{
+  if ((regs->status & DS3231_BSY) || (regs->control & DS3231_CONV))
+  {
+    return false;
+  }
+  return writeRegister(REG_CONTROL, regs->control | DS3231_CONV);
+}
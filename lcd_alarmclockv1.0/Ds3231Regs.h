@@ -0,0 +1,48 @@
+#ifndef DS3231REGS_H_
+#define DS3231REGS_H_
+
+// DS3231 driver built around a single burst read.
+//
+// ds3231Read() fetches registers 0x00-0x12 (time, both alarms, control,
+// status, aging offset and temperature) in one 19 byte I2C transaction, so one
+// read per second delivers everything the UI needs. Temperature conversions
+// are requested with ds3231StartConversion(), which never waits: the new value
+// simply shows up in a later read once the chip has finished (about 200 ms).
+// The DS3231 also converts by itself every 64 seconds.
+
+#include "Arduino.h"
+#include "BcdTime.h"
+
+#define DS3231_ADDRESS    0x68
+
+// Control register (0x0E)
+#define DS3231_CONV       0x20    // start a temperature conversion
+#define DS3231_INTCN      0x04    // INT/SQW pin used for alarm interrupts
+
+// Status register (0x0F)
+#define DS3231_OSF        0x80    // oscillator stopped, time is not valid
+#define DS3231_BSY        0x04    // temperature conversion in progress
+#define DS3231_A2F        0x02    // alarm 2 matched
+#define DS3231_A1F        0x01    // alarm 1 matched
+
+typedef struct Ds3231Registers {
+  BcdTime time;           // 0x00-0x06
+  byte alarm1[4];         // 0x07-0x0A seconds, minutes, hours, day/date (BCD, A1Mx bits in bit 7)
+  byte alarm2[3];         // 0x0B-0x0D minutes, hours, day/date
+  byte control;           // 0x0E
+  byte status;            // 0x0F
+  int8_t aging;           // 0x10
+  int16_t temperature;    // 0x11-0x12, (MSB << 8) | LSB is Celsius in Q8.8 (0.25 degree steps)
+} Ds3231Registers;
+
+// Reads registers 0x00-0x12 in one transaction. Returns false if the DS3231 does not answer.
+extern bool ds3231Read(Ds3231Registers *regs);
+
+// Sets the time and date (24 hour mode) and clears the oscillator stop flag.
+extern bool ds3231SetTime(const BcdTime *t);
+
+// Requests a temperature conversion unless one is already running, based on
+// the control and status bytes of the last read. Returns true if one was started.
+extern bool ds3231StartConversion(const Ds3231Registers *regs);
+
+#endif
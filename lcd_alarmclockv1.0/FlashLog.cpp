@@ -0,0 +1,361 @@
+#include "FlashLog.h"
+#include <stddef.h>
+
+#define FLASH_LOG_MAGIC   0x4C46      // "FL"
+#define NO_DAY            0xFFFF      // an unwritten page
+#define DAY_MARKER        0x00
+#define PAGE_UNUSED       0xFF
+
+typedef struct SectorHeader {
+  uint16_t magic;
+  uint32_t sequence;
+  uint16_t day;           // the first page's day
+} SectorHeader;
+
+// Where the day of the page at address is, and where its first record goes.
+#define PAGE_DAY_OFFSET(address)  (((address) % NOR_SECTOR_SIZE == 0) ? offsetof(SectorHeader, day) : 0)
+#define PAGE_HEADER_SIZE(address) (PAGE_DAY_OFFSET(address) + sizeof(uint16_t))
+
+// ----------------------------------------------------------------------------------------------------
+FlashLog::FlashLog(NorFlash &flash) :
+  flash(flash), size(0), sectors(0), end(0), sequence(0), oldest(0), newest(0), day(0), blank(true)
+{
+}
+
+// ----------------------------------------------------------------------------------------------------
+bool FlashLog::begin()
+{
+  size = flash.capacity();
+  if (size < 3 * NOR_SECTOR_SIZE)
+  {
+    size = 0;
+    sectors = 0;
+    return false;
+  }
+  sectors = size / NOR_SECTOR_SIZE;
+
+  // The newest sector has the highest sequence number and the oldest the lowest
+  uint32_t lowest = 0xFFFFFFFF;
+  bool found = false;
+
+  for (uint16_t s = 0; s < sectors; s++)
+  {
+    SectorHeader header;
+
+    flash.read((uint32_t)s * NOR_SECTOR_SIZE, &header, sizeof(header));
+    if (header.magic != FLASH_LOG_MAGIC || header.sequence == 0xFFFFFFFF)
+    {
+      continue;
+    }
+    if (!found || header.sequence > sequence)
+    {
+      sequence = header.sequence;
+      newest = s;
+    }
+    if (header.sequence < lowest)
+    {
+      lowest = header.sequence;
+      oldest = s;
+    }
+    found = true;
+  }
+
+  if (!found)
+  {
+    // New log: the first append opens sector 0
+    flash.eraseSector(0);
+    blank = true;
+    end = 0;
+    return true;
+  }
+
+  // A reset may have come between opening the newest sector and erasing the
+  // next one. Erase it first, so the walk below cannot run on into it.
+  eraseAhead();
+
+  // Walk the last written page of the newest sector to find the end and the last day
+  uint32_t sector = (uint32_t)newest * NOR_SECTOR_SIZE;
+  byte lo = 0;
+  byte hi = NOR_SECTOR_PAGES - 1;
+
+  while (lo < hi)
+  {
+    byte mid = (lo + hi + 1) / 2;
+
+    if (pageDay(sector + (uint32_t)mid * NOR_PAGE_SIZE) != NO_DAY)
+    {
+      lo = mid;
+    }
+    else
+    {
+      hi = mid - 1;
+    }
+  }
+
+  FlashLogCursor cursor;
+  byte length;
+
+  cursor.address = sector + (uint32_t)lo * NOR_PAGE_SIZE;
+  cursor.day = 0;
+  end = size;                   // no address matches, so locate() runs to the first unwritten page
+  while ((length = locate(&cursor)) != 0)
+  {
+    cursor.address = advance(cursor.address, 1 + length);
+  }
+  end = cursor.address;
+  day = cursor.day;
+  blank = false;
+  return true;
+}
+
+// ----------------------------------------------------------------------------------------------------
+bool FlashLog::append(uint16_t recordDay, const void *data, byte length)
+{
+  if (size == 0 || length == 0 || length > FLASH_LOG_MAX_RECORD || (!blank && recordDay < day))
+  {
+    return false;
+  }
+
+  byte header[4];
+  byte headerLength = 0;
+  unsigned int offset = end % NOR_PAGE_SIZE;
+  unsigned int needed = 1 + length + ((recordDay != day) ? 3 : 0);
+
+  if (offset != 0 && offset + needed > NOR_PAGE_SIZE)
+  {
+    end = advance(end, NOR_PAGE_SIZE - offset);
+    offset = 0;
+  }
+
+  bool opened = end % NOR_SECTOR_SIZE == 0;
+
+  if (opened)
+  {
+    openSector(recordDay);
+  }
+  else if (offset == 0)
+  {
+    flash.program(end, &recordDay, sizeof(recordDay));
+    end += sizeof(recordDay);
+  }
+  else if (recordDay != day)
+  {
+    header[headerLength++] = DAY_MARKER;
+    header[headerLength++] = recordDay;
+    header[headerLength++] = recordDay >> 8;
+  }
+
+  header[headerLength++] = length;
+  flash.program(end, header, headerLength);
+  flash.program(end + headerLength, data, length);
+  end = advance(end, headerLength + length);
+  day = recordDay;
+  blank = false;
+
+  // Only now, so the record does not wait for the erase
+  if (opened)
+  {
+    eraseAhead();
+  }
+  return true;
+}
+
+// ----------------------------------------------------------------------------------------------------
+bool FlashLog::empty()
+{
+  return blank;
+}
+
+// ----------------------------------------------------------------------------------------------------
+uint16_t FlashLog::firstDay()
+{
+  return blank ? NO_DAY : sectorDay(oldest);
+}
+
+// ----------------------------------------------------------------------------------------------------
+uint16_t FlashLog::lastDay()
+{
+  return blank ? NO_DAY : day;
+}
+
+// ----------------------------------------------------------------------------------------------------
+void FlashLog::seek(FlashLogCursor *cursor, uint16_t first, uint16_t last)
+{
+  cursor->lastDay = last;
+  cursor->address = end;
+  if (blank)
+  {
+    return;
+  }
+
+  // The last sector, then the last page in it, that starts before day first:
+  // day first can only begin in that page or after it
+  uint16_t count = (newest + sectors - oldest) % sectors + 1;
+  uint16_t lo = 0;
+  uint16_t hi = count - 1;
+
+  while (lo < hi)
+  {
+    uint16_t mid = (lo + hi + 1) / 2;
+
+    if (sectorDay((oldest + mid) % sectors) < first)
+    {
+      lo = mid;
+    }
+    else
+    {
+      hi = mid - 1;
+    }
+  }
+
+  uint32_t sector = (uint32_t)((oldest + lo) % sectors) * NOR_SECTOR_SIZE;
+  byte page = 0;
+  byte top = NOR_SECTOR_PAGES - 1;
+
+  while (page < top)
+  {
+    byte mid = (page + top + 1) / 2;
+
+    if (pageDay(sector + (uint32_t)mid * NOR_PAGE_SIZE) < first)
+    {
+      page = mid;
+    }
+    else
+    {
+      top = mid - 1;
+    }
+  }
+
+  // Then skip what is left of the days before
+  byte length;
+
+  cursor->address = sector + (uint32_t)page * NOR_PAGE_SIZE;
+  while ((length = locate(cursor)) != 0 && cursor->day < first)
+  {
+    cursor->address = advance(cursor->address, 1 + length);
+  }
+}
+
+// ----------------------------------------------------------------------------------------------------
+byte FlashLog::next(FlashLogCursor *cursor, void *data, byte room, uint16_t *recordDay)
+{
+  byte length = locate(cursor);
+
+  if (length == 0 || cursor->day > cursor->lastDay)
+  {
+    cursor->address = end;
+    return 0;
+  }
+
+  flash.read(cursor->address + 1, data, (length < room) ? length : room);
+  *recordDay = cursor->day;
+  cursor->address = advance(cursor->address, 1 + length);
+  return length;
+}
+
+// ----------------------------------------------------------------------------------------------------
+uint16_t FlashLog::following(uint16_t sector)
+{
+  return (sector + 1 == sectors) ? 0 : sector + 1;
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Moves an address on, wrapping at the end of the chip.
+uint32_t FlashLog::advance(uint32_t address, unsigned int count)
+{
+  address += count;
+  return (address >= size) ? address - size : address;
+}
+
+// ----------------------------------------------------------------------------------------------------
+uint16_t FlashLog::pageDay(uint32_t page)
+{
+  uint16_t value;
+
+  flash.read(page + PAGE_DAY_OFFSET(page), &value, sizeof(value));
+  return value;
+}
+
+// ----------------------------------------------------------------------------------------------------
+uint16_t FlashLog::sectorDay(uint16_t sector)
+{
+  return pageDay((uint32_t)sector * NOR_SECTOR_SIZE);
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Moves the cursor to the length byte of the next record, taking in page
+// headers and day markers on the way. Returns the record's length, or 0 at
+// the end of the log.
+byte FlashLog::locate(FlashLogCursor *cursor)
+{
+  for (;;)
+  {
+    if (cursor->address == end)
+    {
+      return 0;
+    }
+    if (cursor->address % NOR_PAGE_SIZE == 0)
+    {
+      uint16_t value = pageDay(cursor->address);
+
+      if (value == NO_DAY)
+      {
+        return 0;
+      }
+      cursor->day = value;
+      cursor->address += PAGE_HEADER_SIZE(cursor->address);
+      continue;
+    }
+
+    byte length;
+
+    flash.read(cursor->address, &length, 1);
+    if (length == PAGE_UNUSED)
+    {
+      cursor->address = advance(cursor->address, NOR_PAGE_SIZE - cursor->address % NOR_PAGE_SIZE);
+    }
+    else if (length == DAY_MARKER)
+    {
+      flash.read(cursor->address + 1, &(cursor->day), sizeof(cursor->day));
+      cursor->address = advance(cursor->address, 3);
+    }
+    else
+    {
+      return length;
+    }
+  }
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Starts the sector at end, whose first page gets the day in the header. The
+// caller erases the one after it.
+void FlashLog::openSector(uint16_t recordDay)
+{
+  SectorHeader header;
+  uint16_t sector = end / NOR_SECTOR_SIZE;
+
+  header.magic = FLASH_LOG_MAGIC;
+  header.sequence = ++sequence;
+  header.day = recordDay;
+  flash.program(end, &header, PAGE_HEADER_SIZE(end));
+  end += PAGE_HEADER_SIZE(end);
+
+  if (blank)
+  {
+    oldest = sector;
+  }
+  newest = sector;
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Erases the sector after the newest one, dropping the oldest sector if that is the one.
+void FlashLog::eraseAhead()
+{
+  uint16_t spare = following(newest);
+
+  if (spare == oldest)
+  {
+    oldest = following(spare);
+  }
+  flash.eraseSector((uint32_t)spare * NOR_SECTOR_SIZE);
+}
@@ -0,0 +1,84 @@
+#ifndef FLASHLOG_H_
+#define FLASHLOG_H_
+
+// Append-only history log on NOR flash (see NorFlash.h), indexed by day.
+//
+// Records are appended in day order and never rewritten. The chip is used as
+// a ring of 4 KB sectors, each starting with a header that holds a sequence
+// number, so begin() finds the newest and oldest sector after a reset. The
+// sector after the one being written is always kept erased. Erasing it is what
+// drops the oldest sector once the chip is full, so old history is collected a
+// sector at a time and an append never has to wait for an erase.
+//
+// Each 256 byte page starts with the day of its first record, and within a
+// page a day marker is only written when the day changes. The page days are a
+// sparse index that costs nothing extra: seek() binary searches the sector
+// headers and then the pages of one sector, so finding a day on a 4 MB chip
+// reads 14 page headers, and a date range query reads only the pages that
+// hold the range.
+//
+// Page layout:  [sector header, first page only] [day: 2] records... 0xFF
+// Record:       [length: 1-FLASH_LOG_MAX_RECORD] [data]
+// Day marker:   [0] [day: 2]
+//
+// Records do not cross pages; after a reset the rest of the last page is left
+// unused. Appending can erase the oldest sector while a cursor is still in it.
+
+#include "Arduino.h"
+#include "NorFlash.h"
+
+#define FLASH_LOG_MAX_RECORD  240
+
+// Where a query has got to. Only FlashLog changes it.
+typedef struct FlashLogCursor {
+  uint32_t address;     // next record, or the start of a page still to be read
+  uint16_t day;         // day at address
+  uint16_t lastDay;     // next() stops after this day
+} FlashLogCursor;
+
+class FlashLog
+{
+  public:
+    FlashLog(NorFlash &flash);
+
+    // Finds the end of the log, or starts a new one on a chip that has none.
+    // Returns false if there is no chip.
+    bool begin();
+
+    // Appends a record of 1 to FLASH_LOG_MAX_RECORD bytes. Returns false if
+    // begin() failed, the length is out of range or day is before the last one.
+    bool append(uint16_t day, const void *data, byte length);
+
+    // True until the first record is appended.
+    bool empty();
+    // Days of the oldest and the newest record still in the log.
+    uint16_t firstDay();
+    uint16_t lastDay();
+
+    // Places a cursor on the first record of day first or later, for reading up to day last.
+    void seek(FlashLogCursor *cursor, uint16_t first, uint16_t last);
+    // Copies the next record (up to room bytes) to data, sets day and returns
+    // the record's full length. Returns 0 at the end of the range.
+    byte next(FlashLogCursor *cursor, void *data, byte room, uint16_t *day);
+
+  private:
+    uint16_t following(uint16_t sector);
+    uint32_t advance(uint32_t address, unsigned int count);
+    uint16_t pageDay(uint32_t page);
+    uint16_t sectorDay(uint16_t sector);
+    byte locate(FlashLogCursor *cursor);
+    void openSector(uint16_t day);
+    void eraseAhead();
+
+    NorFlash &flash;
+    uint32_t size;          // bytes, 0 until begin() finds a chip
+    uint16_t sectors;       // size / NOR_SECTOR_SIZE
+    uint32_t end;           // where the next record goes
+    uint32_t sequence;      // of the newest sector
+    uint16_t oldest;        // sectors
+    uint16_t newest;
+    uint16_t day;           // of the last record
+    bool blank;
+};
+
+#endif
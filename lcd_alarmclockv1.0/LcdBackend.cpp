@@ -0,0 +1,194 @@
+#include "LcdBackend.h"
+
+#define SEG_TOP     0
+#define SEG_BOTH    1
+#define SEG_BOTTOM  2
+#define BAR_CHAR    3     // slots 3..6 hold bar levels 1..4
+#define ICON_CHAR   7
+#define FULL_CHAR   0xFF
+#define DOT_CHAR    0xA5  // centred dot in the A00 character ROM
+
+#define LOADED_DIGITS 0x01
+#define LOADED_BARS   0x02
+
+static const byte segTop[8] PROGMEM = {0x1F,0x1F,0x1F,0x00,0x00,0x00,0x00,0x00};
+static const byte segBoth[8] PROGMEM = {0x1F,0x1F,0x1F,0x00,0x00,0x1F,0x1F,0x1F};
+static const byte segBottom[8] PROGMEM = {0x00,0x00,0x00,0x00,0x00,0x1F,0x1F,0x1F};
+
+static const byte bigDigits[10][2][3] PROGMEM = {
+  {{ FULL_CHAR, SEG_TOP, FULL_CHAR}, {FULL_CHAR, SEG_BOTTOM, FULL_CHAR}}, //0
+  {{ SEG_TOP, FULL_CHAR, ' '}, {SEG_BOTTOM, FULL_CHAR, SEG_BOTTOM}}, //1
+  {{ SEG_TOP, SEG_TOP, FULL_CHAR}, {FULL_CHAR, SEG_BOTH, SEG_BOTTOM}}, //2
+  {{ SEG_BOTH, SEG_BOTH, FULL_CHAR}, {SEG_BOTH, SEG_BOTH, FULL_CHAR}}, //3
+  {{ FULL_CHAR, SEG_BOTTOM, FULL_CHAR}, {' ', ' ', FULL_CHAR}}, //4
+  {{ FULL_CHAR, SEG_BOTH, SEG_BOTH}, {SEG_BOTTOM, SEG_BOTTOM, FULL_CHAR}}, //5
+  {{ FULL_CHAR, SEG_TOP, SEG_TOP}, {FULL_CHAR, SEG_BOTH, FULL_CHAR}}, //6
+  {{ SEG_TOP, SEG_BOTH, FULL_CHAR}, {' ', SEG_TOP, FULL_CHAR}}, //7
+  {{ FULL_CHAR, SEG_BOTH, FULL_CHAR}, {FULL_CHAR, SEG_BOTH, FULL_CHAR}}, //8
+  {{ FULL_CHAR, SEG_BOTH, FULL_CHAR}, {SEG_BOTTOM, SEG_BOTTOM, FULL_CHAR}}, //9
+};
+
+// ----------------------------------------------------------------------------------------------------
+LcdBackend::LcdBackend(LiquidCrystal &lcd) : lcd(lcd), loaded(0), icon(NULL)
+{
+  // LiquidCrystal::begin() leaves the panel blank.
+  memset(shadow, ' ', sizeof(shadow));
+  cursorCol = 0xFF;
+  cursorRow = 0;
+}
+
+// ----------------------------------------------------------------------------------------------------
+byte LcdBackend::columns()
+{
+  return LCD_BACKEND_COLUMNS;
+}
+
+// ----------------------------------------------------------------------------------------------------
+byte LcdBackend::rows()
+{
+  return LCD_BACKEND_ROWS;
+}
+
+// ----------------------------------------------------------------------------------------------------
+void LcdBackend::clear()
+{
+  lcd.clear();
+  memset(shadow, ' ', sizeof(shadow));
+  cursorCol = 0;
+  cursorRow = 0;
+}
+
+// ----------------------------------------------------------------------------------------------------
+void LcdBackend::put(byte col, byte row, byte c)
+{
+  if (col >= LCD_BACKEND_COLUMNS || row >= LCD_BACKEND_ROWS || shadow[row][col] == c)
+  {
+    return;
+  }
+  if (col != cursorCol || row != cursorRow)
+  {
+    lcd.setCursor(col, row);
+  }
+  lcd.write(c);
+  shadow[row][col] = c;
+
+  // The HD44780 does not wrap to the next visible row, so after the last
+  // column the position is unknown.
+  cursorCol = col + 1;
+  cursorRow = row;
+}
+
+// ----------------------------------------------------------------------------------------------------
+void LcdBackend::loadChar(byte slot, const byte *bitmap)
+{
+  byte buf[8];
+
+  for (byte i = 0; i < 8; i++)
+  {
+    buf[i] = (bitmap != NULL) ? pgm_read_byte(bitmap + i) : 0;
+  }
+  lcd.createChar(slot, buf);
+
+  // createChar() leaves the address counter in CGRAM.
+  cursorCol = 0xFF;
+}
+
+// ----------------------------------------------------------------------------------------------------
+void LcdBackend::drawText(byte col, byte row, const char *text, byte width)
+{
+  for (byte i = 0; i < width; i++)
+  {
+    put(col + i, row, *text ? *text++ : ' ');
+  }
+}
+
+// ----------------------------------------------------------------------------------------------------
+byte LcdBackend::drawBigChar(byte col, byte row, char c)
+{
+  if (c == ':')
+  {
+    put(col, row, DOT_CHAR);
+    put(col, row + 1, DOT_CHAR);
+    return 1;
+  }
+
+  if (c >= '0' && c <= '9')
+  {
+    if (!(loaded & LOADED_DIGITS))
+    {
+      loadChar(SEG_TOP, segTop);
+      loadChar(SEG_BOTH, segBoth);
+      loadChar(SEG_BOTTOM, segBottom);
+      loaded |= LOADED_DIGITS;
+    }
+    for (byte y = 0; y < 2; y++)
+    {
+      for (byte x = 0; x < 3; x++)
+      {
+        put(col + x, row + y, pgm_read_byte(&bigDigits[c - '0'][y][x]));
+      }
+    }
+  }
+  else
+  {
+    drawText(col, row, "", 3);
+    drawText(col, row + 1, "", 3);
+  }
+
+  // One blank column between digits
+  put(col + 3, row, ' ');
+  put(col + 3, row + 1, ' ');
+  return 4;
+}
+
+// ----------------------------------------------------------------------------------------------------
+byte LcdBackend::barSteps()
+{
+  return 5;
+}
+
+// ----------------------------------------------------------------------------------------------------
+void LcdBackend::drawBarCell(byte col, byte row, byte level)
+{
+  if (level == 0)
+  {
+    put(col, row, ' ');
+  }
+  else if (level >= 5)
+  {
+    put(col, row, FULL_CHAR);
+  }
+  else
+  {
+    if (!(loaded & LOADED_BARS))
+    {
+      byte buf[8];
+
+      for (byte i = 1; i < 5; i++)
+      {
+        // The leftmost i of the five pixel columns lit
+        memset(buf, (0x1F << (5 - i)) & 0x1F, sizeof(buf));
+        lcd.createChar(BAR_CHAR + i - 1, buf);
+      }
+      cursorCol = 0xFF;
+      loaded |= LOADED_BARS;
+    }
+    put(col, row, BAR_CHAR + level - 1);
+  }
+}
+
+// ----------------------------------------------------------------------------------------------------
+void LcdBackend::drawIcon(byte col, byte row, const byte *bitmap)
+{
+  if (bitmap == NULL)
+  {
+    put(col, row, ' ');
+    return;
+  }
+  if (bitmap != icon)
+  {
+    loadChar(ICON_CHAR, bitmap);
+    icon = bitmap;
+  }
+  put(col, row, ICON_CHAR);
+}
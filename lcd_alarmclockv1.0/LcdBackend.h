@@ -0,0 +1,50 @@
+#ifndef LCDBACKEND_H_
+#define LCDBACKEND_H_
+
+// HD44780 character LCD backend for the widget layer.
+//
+// A shadow of the character codes on the panel is kept, and only cells that
+// differ are written; the cursor is only moved when the next changed cell is
+// not where the panel's auto-increment left it. The eight custom characters
+// are shared as follows and loaded the first time they are needed:
+//   0-2  big digit segments (the thick square font of the v7 clock)
+//   3-6  bar cells one to four fifths full
+//   7    icon, so only one distinct icon can be on screen at a time
+
+#include "Arduino.h"
+#include <LiquidCrystal.h>
+#include "DisplayBackend.h"
+
+#ifndef LCD_BACKEND_COLUMNS
+#define LCD_BACKEND_COLUMNS 16
+#endif
+#ifndef LCD_BACKEND_ROWS
+#define LCD_BACKEND_ROWS 2
+#endif
+
+class LcdBackend : public DisplayBackend
+{
+  public:
+    LcdBackend(LiquidCrystal &lcd);
+
+    byte columns();
+    byte rows();
+    void clear();
+    void drawText(byte col, byte row, const char *text, byte width);
+    byte drawBigChar(byte col, byte row, char c);
+    byte barSteps();
+    void drawBarCell(byte col, byte row, byte level);
+    void drawIcon(byte col, byte row, const byte *bitmap);
+
+  private:
+    void put(byte col, byte row, byte c);
+    void loadChar(byte slot, const byte *bitmap);
+
+    LiquidCrystal &lcd;
+    byte shadow[LCD_BACKEND_ROWS][LCD_BACKEND_COLUMNS];
+    byte cursorCol, cursorRow;      // where the next write lands, cursorCol > columns when unknown
+    byte loaded;                    // bit 0: digit segments, bit 1: bar cells
+    const byte *icon;               // bitmap in slot 7
+};
+
+#endif
@@ -0,0 +1,152 @@
+#include "LedEffects.h"
+
+#define LED_MASK (LED_GREEN_BIT | LED_RED_BIT | LED_BUZZ_BIT)
+
+typedef struct LedChannel {
+  const LedStep *script;    // NULL when steady
+  const LedStep *step;      // next step to load
+  unsigned int remaining;   // ticks left in the current step, 0 = hold
+  int level;                // 8.8 fixed point, 0 to LED_FULL << 8
+  int target;
+  int delta;                // added every tick while fading
+  byte acc;
+} LedChannel;
+
+static LedChannel channels[LED_CHANNELS];
+static const byte channelBits[LED_CHANNELS] = { LED_GREEN_BIT, LED_RED_BIT, LED_BUZZ_BIT };
+
+const LedStep ledBlink[] PROGMEM = { LED_SET(LED_FULL, 500), LED_SET(0, 500), LED_REPEAT() };
+const LedStep ledBlinkFast[] PROGMEM = { LED_SET(LED_FULL, 100), LED_SET(0, 100), LED_REPEAT() };
+const LedStep ledBreathe[] PROGMEM = { LED_FADE(LED_FULL, 1500), LED_FADE(0, 1500), LED_SET(0, 200), LED_REPEAT() };
+const LedStep alarmGreen[] PROGMEM = { LED_SET(LED_FULL, 500), LED_SET(0, 1000), LED_REPEAT() };
+const LedStep alarmRed[] PROGMEM = { LED_SET(0, 500), LED_SET(LED_FULL, 1000), LED_REPEAT() };
+const LedStep alarmBuzzer[] PROGMEM = { LED_SET(LED_FULL, 1000), LED_SET(0, 500), LED_REPEAT() };
+
+// ----------------------------------------------------------------------------------------------------
+// Loads the next step of a channel's script. Runs once per step, so the fade
+// division is not paid on every tick.
+static void loadStep(LedChannel *ch)
+{
+  byte op = pgm_read_byte(&(ch->step->op));
+
+  if (op == LED_OP_REPEAT && ch->step != ch->script)
+  {
+    ch->step = ch->script;
+    op = pgm_read_byte(&(ch->step->op));
+  }
+  if (op != LED_OP_SET && op != LED_OP_FADE)
+  {
+    ch->remaining = 0;
+    ch->delta = 0;
+    return;
+  }
+
+  unsigned int ticks = pgm_read_word(&(ch->step->ticks));
+
+  ch->target = pgm_read_byte(&(ch->step->level)) << 8;
+  ch->step++;
+  ch->remaining = ticks ? ticks : 1;
+
+  if (op == LED_OP_FADE && ticks > 1)
+  {
+    ch->delta = (ch->target - ch->level) / (int)ticks;
+  }
+  else
+  {
+    ch->level = ch->target;
+    ch->delta = 0;
+  }
+}
+
+// ----------------------------------------------------------------------------------------------------
+void effectsBegin()
+{
+  LED_PORT &= ~LED_MASK;
+  LED_DDR |= LED_MASK;
+  effectsOff();
+
+  // Piggy back on Timer0, which already runs at about 1 kHz for millis().
+  OCR0A = 0xAF;
+  TIMSK0 |= _BV(OCIE0A);
+}
+
+// ----------------------------------------------------------------------------------------------------
+void effectsPlay(byte channel, const LedStep *script)
+{
+  LedChannel *ch = &channels[channel];
+  uint8_t sreg = SREG;
+
+  cli();
+  ch->script = script;
+  ch->step = script;
+  loadStep(ch);
+  SREG = sreg;
+}
+
+// ----------------------------------------------------------------------------------------------------
+void effectsSet(byte channel, byte level)
+{
+  LedChannel *ch = &channels[channel];
+  uint8_t sreg = SREG;
+
+  cli();
+  ch->script = NULL;
+  ch->remaining = 0;
+  ch->delta = 0;
+  ch->level = level << 8;
+  ch->target = ch->level;
+  SREG = sreg;
+}
+
+// ----------------------------------------------------------------------------------------------------
+void effectsOff()
+{
+  for (byte i = 0; i < LED_CHANNELS; i++)
+  {
+    effectsSet(i, 0);
+  }
+}
+
+// ----------------------------------------------------------------------------------------------------
+bool effectsPlaying(byte channel)
+{
+  uint8_t sreg = SREG;
+
+  cli();
+  bool playing = channels[channel].remaining != 0;
+  SREG = sreg;
+  return playing;
+}
+
+// ----------------------------------------------------------------------------------------------------
+void effectsISR()
+{
+  byte bits = 0;
+
+  for (byte i = 0; i < LED_CHANNELS; i++)
+  {
+    LedChannel *ch = &channels[i];
+
+    if (ch->remaining)
+    {
+      if (--ch->remaining == 0)
+      {
+        ch->level = ch->target;
+        loadStep(ch);
+      }
+      else
+      {
+        ch->level += ch->delta;
+      }
+    }
+
+    ch->acc += ch->level >> 8;
+    if (ch->acc >= LED_FULL)
+    {
+      ch->acc -= LED_FULL;
+      bits |= channelBits[i];
+    }
+  }
+
+  LED_PORT = (LED_PORT & ~LED_MASK) | bits;
+}
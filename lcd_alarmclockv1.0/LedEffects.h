@@ -0,0 +1,83 @@
+#ifndef LEDEFFECTS_H_
+#define LEDEFFECTS_H_
+
+// Timer-driven LED and buzzer effects.
+//
+// Each channel runs a PROGMEM script of steps (set a level, fade to a level,
+// repeat, end) from effectsISR(), which the sketch calls from the Timer0
+// compare interrupt at about 1 kHz, so nothing in the main loop waits for a
+// blink to finish. Brightness has 17 levels (0 to LED_FULL) and is made with
+// first-order sigma-delta modulation: per tick each channel adds its level to
+// an accumulator and is on when it overflows, which keeps the flicker rate at
+// 60 Hz or more for every level. All channels sit on one port and are written
+// together with a single port write.
+//
+// The sketch has to forward the interrupt:
+//
+//   SIGNAL(TIMER0_COMPA_vect)
+//   {
+//     effectsISR();
+//   }
+
+#include "Arduino.h"
+
+// Channels and their port bits: pins 8, 9 and 10 on an Uno.
+#ifndef LED_PORT
+#define LED_PORT      PORTB
+#define LED_DDR       DDRB
+#define LED_GREEN_BIT _BV(0)
+#define LED_RED_BIT   _BV(1)
+#define LED_BUZZ_BIT  _BV(2)
+#endif
+
+enum LedChannelId
+{
+  LED_GREEN,
+  LED_RED,
+  LED_BUZZER,       // an active buzzer, so only LED_FULL and 0 make sense
+  LED_CHANNELS
+};
+
+#define LED_FULL 16
+
+enum LedOp
+{
+  LED_OP_SET,       // jump to level and hold it for ticks
+  LED_OP_FADE,      // move linearly to level over ticks
+  LED_OP_REPEAT,    // continue with the first step
+  LED_OP_END        // keep the current level
+};
+
+typedef struct LedStep {
+  byte level;           // 0 to LED_FULL
+  byte op;
+  unsigned int ticks;   // about 1 ms each
+} LedStep;
+
+#define LED_SET(level, ms)  { level, LED_OP_SET, ms }
+#define LED_FADE(level, ms) { level, LED_OP_FADE, ms }
+#define LED_REPEAT()        { 0, LED_OP_REPEAT, 0 }
+#define LED_END()           { 0, LED_OP_END, 0 }
+
+// Sets up the port and enables the Timer0 compare interrupt.
+extern void effectsBegin();
+// Starts a PROGMEM script on a channel, replacing what it was doing.
+extern void effectsPlay(byte channel, const LedStep *script);
+// Sets a channel to a steady level.
+extern void effectsSet(byte channel, byte level);
+// Sets every channel to 0.
+extern void effectsOff();
+// True while a channel's script has steps left.
+extern bool effectsPlaying(byte channel);
+// Advances all channels by one tick. Call from the Timer0 compare interrupt only.
+extern void effectsISR();
+
+// Ready-made scripts.
+extern const LedStep ledBlink[] PROGMEM;        // 0.5 s on, 0.5 s off
+extern const LedStep ledBlinkFast[] PROGMEM;    // 0.1 s on, 0.1 s off
+extern const LedStep ledBreathe[] PROGMEM;      // 1.5 s up, 1.5 s down
+extern const LedStep alarmGreen[] PROGMEM;      // the old Buzzer() pattern, 1.5 s cycle
+extern const LedStep alarmRed[] PROGMEM;
+extern const LedStep alarmBuzzer[] PROGMEM;
+
+#endif
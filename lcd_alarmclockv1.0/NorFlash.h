@@ -0,0 +1,35 @@
+#ifndef NORFLASH_H_
+#define NORFLASH_H_
+
+// Interface to a NOR flash chip, as used by FlashLog (see FlashLog.h).
+//
+// NOR flash reads like memory, but programming can only turn 1 bits into 0
+// and must stay within one page, and the only way back to 1 is erasing a whole
+// sector. Erasing takes tens of milliseconds, so eraseSector() only starts it;
+// every other call waits for a running erase or program to finish first.
+
+#include "Arduino.h"
+
+#define NOR_PAGE_SIZE     256
+#define NOR_SECTOR_SIZE   4096
+#define NOR_SECTOR_PAGES  (NOR_SECTOR_SIZE / NOR_PAGE_SIZE)
+
+class NorFlash
+{
+  public:
+    // Size of the chip in bytes, 0 if no chip answers.
+    virtual uint32_t capacity() = 0;
+
+    virtual void read(uint32_t address, void *data, unsigned int length) = 0;
+
+    // Programs length bytes, which must not cross a page boundary.
+    virtual void program(uint32_t address, const void *data, unsigned int length) = 0;
+
+    // Starts erasing the sector holding address to all 0xFF.
+    virtual void eraseSector(uint32_t address) = 0;
+
+    // True while an erase or program is still running.
+    virtual bool busy() = 0;
+};
+
+#endif
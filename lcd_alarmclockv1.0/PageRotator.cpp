@@ -0,0 +1,70 @@
+#include "PageRotator.h"
+
+static const Page *pageTable = NULL;
+static byte pageCount = 0;
+static byte pageIndex = 0;
+static unsigned long pageShownAt = 0;
+static bool pageEntering = true;
+
+// ----------------------------------------------------------------------------------------------------
+void pagesBegin(const Page *pages, byte count)
+{
+  pageTable = pages;
+  pageCount = count;
+  pageIndex = 0;
+  pageShownAt = millis();
+  pageEntering = true;
+}
+
+// ----------------------------------------------------------------------------------------------------
+void pagesUpdate()
+{
+  if (pageCount == 0)
+  {
+    return;
+  }
+
+  const Page *page = &pageTable[pageIndex];
+  unsigned int dwell = pgm_read_word(&(page->dwell));
+
+  if (dwell != 0 && millis() - pageShownAt >= dwell)
+  {
+    pagesNext();
+    page = &pageTable[pageIndex];
+  }
+
+  bool (*needsRedraw)() = (bool (*)()) pgm_read_word(&(page->needsRedraw));
+
+  if (pageEntering || (needsRedraw != NULL && needsRedraw()))
+  {
+    void (*render)(bool) = (void (*)(bool)) pgm_read_word(&(page->render));
+    bool entering = pageEntering;
+
+    pageEntering = false;
+    render(entering);
+  }
+}
+
+// ----------------------------------------------------------------------------------------------------
+void pagesNext()
+{
+  if (pageCount == 0)
+  {
+    return;
+  }
+  pageIndex = (pageIndex + 1) % pageCount;
+  pageShownAt = millis();
+  pageEntering = true;
+}
+
+// ----------------------------------------------------------------------------------------------------
+void pagesInvalidate()
+{
+  pageEntering = true;
+}
+
+// ----------------------------------------------------------------------------------------------------
+byte pagesCurrent()
+{
+  return pageIndex;
+}
@@ -0,0 +1,31 @@
+#ifndef PAGEROTATOR_H_
+#define PAGEROTATOR_H_
+
+// Timer-driven page pipeline.
+//
+// The sketch declares a PROGMEM table of pages. Each page has a render
+// function, a dwell time and a needsRedraw predicate. pagesUpdate() is called
+// every loop: it never blocks, switches to the next page when the dwell time
+// has elapsed, and renders the active page only when it has just become active
+// or its predicate reports changed data.
+
+#include "Arduino.h"
+
+typedef struct Page {
+  void (*render)(bool entering);    // entering is true on the first render after a switch
+  unsigned int dwell;               // milliseconds on screen, 0 = stay until pagesNext()
+  bool (*needsRedraw)();            // NULL = render only on entry
+} Page;
+
+// Starts the rotation on the first page of a PROGMEM table.
+extern void pagesBegin(const Page *pages, byte count);
+// Advances the rotation and redraws the active page if needed. Call every loop.
+extern void pagesUpdate();
+// Switches to the next page straight away.
+extern void pagesNext();
+// Forces a full redraw of the active page, e.g. after something else used the display.
+extern void pagesInvalidate();
+// Gets the index of the active page.
+extern byte pagesCurrent();
+
+#endif
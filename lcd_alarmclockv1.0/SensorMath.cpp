@@ -0,0 +1,222 @@
+#include "SensorMath.h"
+
+// ----------------------------------------------------------------------------------------------------
+// Product of two Q16.16 values. The result must fit in Q16.16 (|result| < 32768).
+q16_16_t qmul(q16_16_t a, q16_16_t b)
+{
+  bool negative = (a < 0) != (b < 0);
+  uint32_t ua = (a < 0) ? -(uint32_t)a : a;
+  uint32_t ub = (b < 0) ? -(uint32_t)b : b;
+  uint16_t ah = ua >> 16;
+  uint16_t al = ua;
+  uint16_t bh = ub >> 16;
+  uint16_t bl = ub;
+
+  uint32_t result = ((uint32_t)(ah * bh) << 16)
+                  + (uint32_t)ah * bl
+                  + (uint32_t)al * bh
+                  + (((uint32_t)al * bl + 0x8000) >> 16);
+
+  return negative ? -(q16_16_t)result : (q16_16_t)result;
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Quotient of two Q16.16 values by long division. The result must fit in Q16.16.
+q16_16_t qdiv(q16_16_t a, q16_16_t b)
+{
+  if (b == 0)
+  {
+    return (a < 0) ? INT32_MIN : INT32_MAX;
+  }
+
+  bool negative = (a < 0) != (b < 0);
+  uint32_t ua = (a < 0) ? -(uint32_t)a : a;
+  uint32_t ub = (b < 0) ? -(uint32_t)b : b;
+  uint32_t quotient = ua / ub;
+  uint32_t remainder = ua % ub;
+
+  for (byte i = 0; i < 16; i++)
+  {
+    remainder <<= 1;
+    quotient <<= 1;
+    if (remainder >= ub)
+    {
+      remainder -= ub;
+      quotient |= 1;
+    }
+  }
+  return negative ? -(q16_16_t)quotient : (q16_16_t)quotient;
+}
+
+// ----------------------------------------------------------------------------------------------------
+static uint32_t isqrt(uint32_t n)
+{
+  uint32_t root = 0;
+  uint32_t bit = 1UL << 30;
+
+  while (bit > n)
+  {
+    bit >>= 2;
+  }
+  while (bit)
+  {
+    if (n >= root + bit)
+    {
+      n -= root + bit;
+      root = (root >> 1) + bit;
+    }
+    else
+    {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+  return root;
+}
+
+// ----------------------------------------------------------------------------------------------------
+q16_16_t qsqrt(q16_16_t a)
+{
+  if (a <= 0)
+  {
+    return 0;
+  }
+
+  // sqrt(a * 2^16): pre-shift a by as many even bits as fit (up to 16), then scale the root back.
+  uint32_t ua = a;
+  byte shift = 0;
+
+  while (shift < 16 && ua < (1UL << 30))
+  {
+    ua <<= 2;
+    shift += 2;
+  }
+  return isqrt(ua) << ((16 - shift) / 2);
+}
+
+// ----------------------------------------------------------------------------------------------------
+q16_16_t qlog2(q16_16_t a)
+{
+  uint32_t v = a;
+  q16_16_t result = 0;
+
+  // Normalise v to [1, 2) and take the integer part from the shift count.
+  while (v >= 2 * Q16_16_ONE)
+  {
+    v >>= 1;
+    result += Q16_16_ONE;
+  }
+  while (v < Q16_16_ONE)
+  {
+    v <<= 1;
+    result -= Q16_16_ONE;
+  }
+
+  // Each squaring yields one fractional bit.
+  for (q16_16_t bit = Q16_16_ONE >> 1; bit; bit >>= 1)
+  {
+    v = qmul(v, v);
+    if (v >= 2 * Q16_16_ONE)
+    {
+      v >>= 1;
+      result += bit;
+    }
+  }
+  return result;
+}
+
+// ----------------------------------------------------------------------------------------------------
+q16_16_t celsiusToFahrenheit(q16_16_t celsius)
+{
+  return qmul(celsius, Q16_16(1.8)) + Q16_16(32);
+}
+
+// ----------------------------------------------------------------------------------------------------
+q16_16_t fahrenheitToCelsius(q16_16_t fahrenheit)
+{
+  return qmul(fahrenheit - Q16_16(32), Q16_16(5.0 / 9.0));
+}
+
+// ----------------------------------------------------------------------------------------------------
+q16_16_t computeHeatIndex(q16_16_t temperature, q16_16_t percentHumidity, bool isFahrenheit)
+{
+  q16_16_t t = isFahrenheit ? temperature : celsiusToFahrenheit(temperature);
+  q16_16_t h = percentHumidity;
+
+  // Steadman's simple formula, 0.5 * (T + 61 + (T - 68) * 1.2 + H * 0.094)
+  q16_16_t hi = qmul(t, Q16_16(1.1)) - Q16_16(10.3) + qmul(h, Q16_16(0.047));
+
+  if (hi > Q16_16(79))
+  {
+    // Rothfusz regression, evaluated on T/128 and H/128 with the coefficients scaled
+    // to match, so every partial sum stays well inside Q16.16.
+    q16_16_t ts = t >> 7;
+    q16_16_t hs = h >> 7;
+
+    q16_16_t c0 = Q16_16(-42.379)
+                + qmul(hs, Q16_16(10.14333127 * 128) + qmul(hs, Q16_16(-0.05481717 * 16384)));
+    q16_16_t c1 = Q16_16(2.04901523 * 128)
+                + qmul(hs, Q16_16(-0.22475541 * 16384) + qmul(hs, Q16_16(0.00085282 * 2097152)));
+    q16_16_t c2 = Q16_16(-0.00683783 * 16384)
+                + qmul(hs, Q16_16(0.00122874 * 2097152) + qmul(hs, Q16_16(-0.00000199 * 268435456)));
+
+    hi = c0 + qmul(ts, c1 + qmul(ts, c2));
+
+    if ((h < Q16_16(13)) && (t >= Q16_16(80)) && (t <= Q16_16(112)))
+    {
+      q16_16_t distance = (t > Q16_16(95)) ? t - Q16_16(95) : Q16_16(95) - t;
+      hi -= qmul(qmul(Q16_16(13) - h, Q16_16(0.25)), qsqrt(qmul(Q16_16(17) - distance, Q16_16(0.05882))));
+    }
+    else if ((h > Q16_16(85)) && (t >= Q16_16(80)) && (t <= Q16_16(87)))
+    {
+      hi += qmul(qmul(h - Q16_16(85), Q16_16(0.1)), qmul(Q16_16(87) - t, Q16_16(0.2)));
+    }
+  }
+  return isFahrenheit ? hi : fahrenheitToCelsius(hi);
+}
+
+// ----------------------------------------------------------------------------------------------------
+q16_16_t computeDewPoint(q16_16_t celsius, q16_16_t percentHumidity)
+{
+  // Magnus formula with b = 17.62, c = 243.12:
+  // gamma = ln(RH / 100) + b * T / (c + T), dew point = c * gamma / (b - gamma)
+  if (percentHumidity < Q16_16(1))
+  {
+    percentHumidity = Q16_16(1);
+  }
+  q16_16_t lnRatio = qmul(qlog2(percentHumidity) - Q16_16(6.64385619), Q16_16(0.69314718));
+  q16_16_t gamma = lnRatio + qmul(Q16_16(17.62), qdiv(celsius, Q16_16(243.12) + celsius));
+
+  return qmul(Q16_16(243.12), qdiv(gamma, Q16_16(17.62) - gamma));
+}
+
+// ----------------------------------------------------------------------------------------------------
+char *formatTenths(char *dest, q16_16_t value)
+{
+  char digits[7];
+  byte count = 0;
+  char *p = dest;
+  uint32_t magnitude = (value < 0) ? -(uint32_t)value : value;
+  uint32_t tenths = (magnitude * 10 + 0x8000) >> 16;
+
+  if (value < 0 && tenths != 0)
+  {
+    *p++ = '-';
+  }
+
+  digits[count++] = '0' + tenths % 10;
+  digits[count++] = '.';
+  tenths /= 10;
+  do
+  {
+    digits[count++] = '0' + tenths % 10;
+    tenths /= 10;
+  } while (tenths && count < sizeof(digits));
+
+  while (count)
+  {
+    *p++ = digits[--count];
+  }
+  *p = 0;
+  return dest;
+}
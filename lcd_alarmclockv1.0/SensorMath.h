@@ -0,0 +1,41 @@
+#ifndef SENSORMATH_H_
+#define SENSORMATH_H_
+
+// Integer-only temperature and humidity math.
+//
+// Sensor samples are stored as Q8.8 (1/256 steps, -128..127.99), which covers
+// Celsius and relative humidity. Derived values are computed and returned as
+// Q16.16 so Fahrenheit and heat index have headroom. Multiplication uses
+// 16x16 partial products, so nothing pulls in 64-bit or soft-float code.
+
+#include "Arduino.h"
+
+typedef int16_t q8_8_t;
+typedef int32_t q16_16_t;
+
+#define Q16_16_ONE                (65536L)
+#define Q16_16(x)                 ((q16_16_t)((x) * 65536.0 + ((x) < 0 ? -0.5 : 0.5)))   // constants only
+#define Q8_8_TO_Q16_16(x)         ((q16_16_t)(x) << 8)
+#define Q16_16_TO_Q8_8(x)         ((q8_8_t)((x) >> 8))
+
+// Basic arithmetic on Q16.16 values.
+extern q16_16_t qmul(q16_16_t a, q16_16_t b);
+extern q16_16_t qdiv(q16_16_t a, q16_16_t b);
+extern q16_16_t qsqrt(q16_16_t a);
+extern q16_16_t qlog2(q16_16_t a);    // a must be > 0
+
+// Temperature scale conversion.
+extern q16_16_t celsiusToFahrenheit(q16_16_t celsius);
+extern q16_16_t fahrenheitToCelsius(q16_16_t fahrenheit);
+
+// Heat index using the same Steadman/Rothfusz formulas as DHT::computeHeatIndex().
+extern q16_16_t computeHeatIndex(q16_16_t temperature, q16_16_t percentHumidity, bool isFahrenheit = true);
+
+// Dew point in Celsius (Magnus formula).
+extern q16_16_t computeDewPoint(q16_16_t celsius, q16_16_t percentHumidity);
+
+// Formats a value (below 6553.6 in magnitude) rounded to one decimal place, e.g. "-12.3".
+// dest needs 8 bytes.
+extern char *formatTenths(char *dest, q16_16_t value);
+
+#endif
@@ -0,0 +1,195 @@
+#include "SensorModel.h"
+
+// Bits of derivedValid; a set bit means the cached value is current.
+#define DERIVED_FAHRENHEIT    0x01
+#define DERIVED_HEAT_INDEX    0x02
+#define DERIVED_DEW_POINT     0x04
+#define DERIVED_TIME_TEXT     0x08
+#define DERIVED_TEMP_TEXT     0x10
+#define DERIVED_HUM_TEXT      0x20
+#define DERIVED_DATE_TEXT     0x40
+
+// Derived values that depend on each source.
+#define DEPENDS_ON_TIME       (DERIVED_TIME_TEXT | DERIVED_DATE_TEXT)
+#define DEPENDS_ON_CLIMATE    (DERIVED_FAHRENHEIT | DERIVED_HEAT_INDEX | DERIVED_DEW_POINT | DERIVED_TEMP_TEXT | DERIVED_HUM_TEXT)
+
+static unsigned int versions[MODEL_SOURCES];
+static byte derivedValid = 0;
+
+static BcdTime sampleTime;
+static q8_8_t sampleCelsius, sampleHumidity;
+static bool samplePresent = false;
+
+static q16_16_t fahrenheit, heatIndex, dewPoint;
+static char timeText[9];
+static char dateText[11];
+static char temperatureText[8];
+static char humidityText[8];
+
+// ----------------------------------------------------------------------------------------------------
+// Marks a source as changed and drops the derived values that depend on it.
+static void changed(byte source, byte dependents)
+{
+  if (++versions[source] == 0)
+  {
+    versions[source] = 1;
+  }
+  derivedValid &= ~dependents;
+}
+
+// ----------------------------------------------------------------------------------------------------
+void modelPublishTime(const BcdTime *t)
+{
+  if (versions[MODEL_TIME] == 0 || memcmp(t, &sampleTime, sizeof(BcdTime)) != 0)
+  {
+    sampleTime = *t;
+    changed(MODEL_TIME, DEPENDS_ON_TIME);
+  }
+}
+
+// ----------------------------------------------------------------------------------------------------
+void modelPublishClimate(q8_8_t c, q8_8_t h)
+{
+  if (versions[MODEL_CLIMATE] == 0 || c != sampleCelsius || h != sampleHumidity)
+  {
+    sampleCelsius = c;
+    sampleHumidity = h;
+    changed(MODEL_CLIMATE, DEPENDS_ON_CLIMATE);
+  }
+}
+
+// ----------------------------------------------------------------------------------------------------
+void modelPublishPresence(bool p)
+{
+  if (versions[MODEL_PRESENCE] == 0 || p != samplePresent)
+  {
+    samplePresent = p;
+    changed(MODEL_PRESENCE, 0);
+  }
+}
+
+// ----------------------------------------------------------------------------------------------------
+unsigned int modelVersion(byte source)
+{
+  return (source < MODEL_SOURCES) ? versions[source] : 0;
+}
+
+// ----------------------------------------------------------------------------------------------------
+const BcdTime *modelTime()
+{
+  return &sampleTime;
+}
+
+// ----------------------------------------------------------------------------------------------------
+byte modelHour()
+{
+  return bcdToBin(sampleTime.hour);
+}
+
+// ----------------------------------------------------------------------------------------------------
+byte modelMinute()
+{
+  return bcdToBin(sampleTime.minute);
+}
+
+// ----------------------------------------------------------------------------------------------------
+byte modelSecond()
+{
+  return bcdToBin(sampleTime.second);
+}
+
+// ----------------------------------------------------------------------------------------------------
+q8_8_t modelCelsius()
+{
+  return sampleCelsius;
+}
+
+// ----------------------------------------------------------------------------------------------------
+q8_8_t modelHumidity()
+{
+  return sampleHumidity;
+}
+
+// ----------------------------------------------------------------------------------------------------
+bool modelPresence()
+{
+  return samplePresent;
+}
+
+// ----------------------------------------------------------------------------------------------------
+q16_16_t modelFahrenheit()
+{
+  if (!(derivedValid & DERIVED_FAHRENHEIT))
+  {
+    fahrenheit = celsiusToFahrenheit(Q8_8_TO_Q16_16(sampleCelsius));
+    derivedValid |= DERIVED_FAHRENHEIT;
+  }
+  return fahrenheit;
+}
+
+// ----------------------------------------------------------------------------------------------------
+q16_16_t modelHeatIndex()
+{
+  if (!(derivedValid & DERIVED_HEAT_INDEX))
+  {
+    // Reuse the cached Fahrenheit value rather than converting again.
+    heatIndex = fahrenheitToCelsius(computeHeatIndex(modelFahrenheit(), Q8_8_TO_Q16_16(sampleHumidity)));
+    derivedValid |= DERIVED_HEAT_INDEX;
+  }
+  return heatIndex;
+}
+
+// ----------------------------------------------------------------------------------------------------
+q16_16_t modelDewPoint()
+{
+  if (!(derivedValid & DERIVED_DEW_POINT))
+  {
+    dewPoint = computeDewPoint(Q8_8_TO_Q16_16(sampleCelsius), Q8_8_TO_Q16_16(sampleHumidity));
+    derivedValid |= DERIVED_DEW_POINT;
+  }
+  return dewPoint;
+}
+
+// ----------------------------------------------------------------------------------------------------
+const char *modelTimeText()
+{
+  if (!(derivedValid & DERIVED_TIME_TEXT))
+  {
+    bcdTimeText(timeText, &sampleTime);
+    derivedValid |= DERIVED_TIME_TEXT;
+  }
+  return timeText;
+}
+
+// ----------------------------------------------------------------------------------------------------
+const char *modelDateText()
+{
+  if (!(derivedValid & DERIVED_DATE_TEXT))
+  {
+    bcdDateText(dateText, &sampleTime);
+    derivedValid |= DERIVED_DATE_TEXT;
+  }
+  return dateText;
+}
+
+// ----------------------------------------------------------------------------------------------------
+const char *modelTemperatureText()
+{
+  if (!(derivedValid & DERIVED_TEMP_TEXT))
+  {
+    formatTenths(temperatureText, Q8_8_TO_Q16_16(sampleCelsius));
+    derivedValid |= DERIVED_TEMP_TEXT;
+  }
+  return temperatureText;
+}
+
+// ----------------------------------------------------------------------------------------------------
+const char *modelHumidityText()
+{
+  if (!(derivedValid & DERIVED_HUM_TEXT))
+  {
+    formatTenths(humidityText, Q8_8_TO_Q16_16(sampleHumidity));
+    derivedValid |= DERIVED_HUM_TEXT;
+  }
+  return humidityText;
+}
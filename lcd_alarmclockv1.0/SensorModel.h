@@ -0,0 +1,52 @@
+#ifndef SENSORMODEL_H_
+#define SENSORMODEL_H_
+
+// Demand-driven sensor data model.
+//
+// The loop publishes raw samples (time, temperature/humidity, presence). A
+// publish that changes a value bumps that source's version, so a page can tell
+// whether it needs redrawing. Derived values (Fahrenheit, heat index, dew point,
+// formatted text) are computed on first access and cached until one of their
+// inputs changes, so nothing is derived that no page shows and nothing is
+// recomputed between sensor updates.
+
+#include "Arduino.h"
+#include "SensorMath.h"
+#include "BcdTime.h"
+
+enum ModelSource
+{
+  MODEL_TIME,
+  MODEL_CLIMATE,        // temperature and humidity, published together
+  MODEL_PRESENCE,
+  MODEL_SOURCES
+};
+
+// Publish raw samples. Republishing an unchanged value is a no-op.
+extern void modelPublishTime(const BcdTime *t);
+extern void modelPublishClimate(q8_8_t celsius, q8_8_t percentHumidity);
+extern void modelPublishPresence(bool present);
+
+// Gets the version of a source. It changes every time the source's value does;
+// 0 means nothing has been published yet.
+extern unsigned int modelVersion(byte source);
+
+// Raw samples. The time stays in BCD; modelHour() and friends decode it for arithmetic.
+extern const BcdTime *modelTime();
+extern byte modelHour();
+extern byte modelMinute();
+extern byte modelSecond();
+extern q8_8_t modelCelsius();
+extern q8_8_t modelHumidity();
+extern bool modelPresence();
+
+// Derived values, computed on demand.
+extern q16_16_t modelFahrenheit();
+extern q16_16_t modelHeatIndex();   // Celsius
+extern q16_16_t modelDewPoint();    // Celsius
+extern const char *modelTimeText();         // "HH:MM:SS"
+extern const char *modelDateText();         // "DD.MM.YYYY"
+extern const char *modelTemperatureText();  // e.g. "23.5"
+extern const char *modelHumidityText();     // e.g. "41.0"
+
+#endif
@@ -0,0 +1,344 @@
+#include "SessionLog.h"
+#include "Varint.h"
+
+#define NO_START      0xFFFFFFFF    // an unwritten page
+#define KEY_SIZE      sizeof(uint32_t)
+#define RECORD_MAX    (2 * VARINT_MAX_SIZE)
+#define MAX_GAP       0x1FFFFFFFUL  // what fits above the phase and flag bits; longer gaps start a page
+
+static byte oldest;
+static byte newest;
+static bool blank = true;
+static uint32_t lastStart;
+static uint32_t lastEnd;
+
+// ----------------------------------------------------------------------------------------------------
+static uint32_t pageKey(byte page)
+{
+  uint32_t key;
+
+  if (!at24Read(page * AT24C32_PAGE_SIZE, &key, sizeof(key)))
+  {
+    return NO_START;
+  }
+  return key;
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Encodes a session that starts after end, the end of the one before it.
+static byte encode(byte *dest, const SessionRecord *record, uint32_t end)
+{
+  uint32_t head = ((record->start - end) << 3) | ((record->flags & SESSION_INTERRUPTED) ? 0x04 : 0) | record->phase;
+  byte *p = varintWrite(dest, head);
+
+  // Timed sessions last whole minutes, which fit in a byte
+  if (record->duration % 60 == 0)
+  {
+    p = varintWrite(p, (uint32_t)record->duration / 60 << 1);
+  }
+  else
+  {
+    p = varintWrite(p, (uint32_t)record->duration << 1 | 1);
+  }
+  return p - dest;
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Decodes the record at the cursor. Returns false at the end of the page.
+static bool decode(SessionCursor *cursor, SessionRecord *record)
+{
+  const byte *end = cursor->data + AT24C32_PAGE_SIZE;
+  const byte *p = cursor->data + cursor->offset;
+  uint32_t head;
+  uint32_t duration;
+
+  if (p >= end || *p == 0xFF)
+  {
+    return false;
+  }
+  if ((p = varintRead(p, end, &head)) == NULL || (p = varintRead(p, end, &duration)) == NULL)
+  {
+    return false;
+  }
+
+  record->start = cursor->end + (head >> 3);
+  record->duration = (duration & 1) ? duration >> 1 : (duration >> 1) * 60;
+  record->phase = head & 0x03;
+  record->flags = (head & 0x04) ? SESSION_INTERRUPTED : 0;
+  cursor->offset = p - cursor->data;
+  cursor->end = record->start + record->duration;
+  return true;
+}
+
+// ----------------------------------------------------------------------------------------------------
+static void loadPage(SessionCursor *cursor, byte page)
+{
+  cursor->page = page;
+  cursor->offset = KEY_SIZE;
+  cursor->newest = (page == newest);
+  if (!at24Read(page * AT24C32_PAGE_SIZE, cursor->data, AT24C32_PAGE_SIZE))
+  {
+    cursor->data[KEY_SIZE] = 0xFF;
+  }
+  memcpy(&cursor->end, cursor->data, KEY_SIZE);
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Starts the page after the newest with record, dropping the oldest page if the ring is full.
+static bool openPage(const SessionRecord *record)
+{
+  byte data[AT24C32_PAGE_SIZE];
+  byte page = blank ? 0 : (newest + 1) % SESSION_LOG_PAGES;
+
+  if (!at24AppendFlush())
+  {
+    return false;
+  }
+
+  memset(data, 0xFF, sizeof(data));
+  memcpy(data, &record->start, KEY_SIZE);
+
+  byte length = encode(data + KEY_SIZE, record, record->start);
+
+  if (!at24Write(page * AT24C32_PAGE_SIZE, data, sizeof(data)))
+  {
+    return false;
+  }
+
+  if (blank)
+  {
+    oldest = page;
+  }
+  else if (page == oldest)
+  {
+    oldest = (oldest + 1) % SESSION_LOG_PAGES;
+  }
+  newest = page;
+  blank = false;
+  at24AppendBegin(page * AT24C32_PAGE_SIZE + KEY_SIZE + length);
+  return true;
+}
+
+// ----------------------------------------------------------------------------------------------------
+bool sessionLogBegin()
+{
+  uint32_t first;
+
+  blank = true;
+  oldest = 0;
+  newest = 0;
+  lastStart = 0;
+  lastEnd = 0;
+  at24AppendBegin(0);         // only what is on the chip counts
+  if (!at24Read(0, &first, sizeof(first)))
+  {
+    return false;
+  }
+  if (first == NO_START)
+  {
+    return true;
+  }
+
+  // Pages after the newest are either unwritten or older than page 0, which
+  // was written after them; the ones before it are newer than page 0.
+  byte lo = 1;
+  byte hi = SESSION_LOG_PAGES;
+
+  while (lo < hi)
+  {
+    byte mid = (lo + hi) / 2;
+    uint32_t key = pageKey(mid);
+
+    if (key == NO_START || key < first)
+    {
+      hi = mid;
+    }
+    else
+    {
+      lo = mid + 1;
+    }
+  }
+
+  newest = lo - 1;
+  oldest = lo % SESSION_LOG_PAGES;
+  if (pageKey(oldest) == NO_START)
+  {
+    oldest = 0;
+  }
+  blank = false;
+
+  // Appending carries on at the end of the newest page
+  SessionCursor cursor;
+  SessionRecord record;
+
+  loadPage(&cursor, newest);
+  while (decode(&cursor, &record))
+  {
+    lastStart = record.start;
+  }
+  lastEnd = cursor.end;
+  at24AppendBegin(newest * AT24C32_PAGE_SIZE + cursor.offset);
+  return true;
+}
+
+// ----------------------------------------------------------------------------------------------------
+bool sessionLogAppend(const SessionRecord *record)
+{
+  if (record->phase > SESSION_LONG_BREAK || record->start == NO_START || (!blank && record->start < lastStart))
+  {
+    return false;
+  }
+
+  // A full page, or a session that overlaps the last one, starts a new page
+  byte data[RECORD_MAX];
+  byte offset = at24AppendAddress() % AT24C32_PAGE_SIZE;
+  byte length = 0;
+
+  if (!blank && offset != 0 && record->start >= lastEnd && record->start - lastEnd <= MAX_GAP)
+  {
+    length = encode(data, record, lastEnd);
+  }
+
+  if (length != 0 && offset + length <= AT24C32_PAGE_SIZE)
+  {
+    if (!at24Append(data, length))
+    {
+      return false;
+    }
+  }
+  else if (!openPage(record))
+  {
+    return false;
+  }
+
+  lastStart = record->start;
+  lastEnd = record->start + record->duration;
+  return true;
+}
+
+// ----------------------------------------------------------------------------------------------------
+bool sessionLogFlush()
+{
+  return at24AppendFlush();
+}
+
+// ----------------------------------------------------------------------------------------------------
+bool sessionLogEmpty()
+{
+  return blank;
+}
+
+// ----------------------------------------------------------------------------------------------------
+byte sessionLogPages()
+{
+  return blank ? 0 : (newest + SESSION_LOG_PAGES - oldest) % SESSION_LOG_PAGES + 1;
+}
+
+// ----------------------------------------------------------------------------------------------------
+void sessionLogSeek(SessionCursor *cursor, uint32_t start)
+{
+  if (blank)
+  {
+    cursor->page = newest;
+    cursor->offset = AT24C32_PAGE_SIZE;
+    cursor->newest = false;
+    return;
+  }
+
+  // The last page that starts before start: start can only begin in it or after it
+  byte lo = 0;
+  byte hi = sessionLogPages() - 1;
+
+  while (lo < hi)
+  {
+    byte mid = (lo + hi + 1) / 2;
+
+    if (pageKey((oldest + mid) % SESSION_LOG_PAGES) < start)
+    {
+      lo = mid;
+    }
+    else
+    {
+      hi = mid - 1;
+    }
+  }
+  loadPage(cursor, (oldest + lo) % SESSION_LOG_PAGES);
+
+  // Then skip the sessions before it
+  SessionRecord record;
+
+  for (;;)
+  {
+    byte offset = cursor->offset;
+    uint32_t end = cursor->end;
+
+    if (!decode(cursor, &record) || record.start >= start)
+    {
+      cursor->offset = offset;
+      cursor->end = end;
+      return;
+    }
+  }
+}
+
+// ----------------------------------------------------------------------------------------------------
+bool sessionLogNext(SessionCursor *cursor, SessionRecord *record)
+{
+  while (!decode(cursor, record))
+  {
+    if (blank)
+    {
+      return false;
+    }
+
+    // Sessions may have been added to the newest page since it was read
+    if (cursor->newest)
+    {
+      byte offset = cursor->offset;
+      uint32_t end = cursor->end;
+
+      loadPage(cursor, cursor->page);
+      cursor->offset = offset;
+      cursor->end = end;
+      if (decode(cursor, record))
+      {
+        return true;
+      }
+    }
+    if (cursor->page == newest)
+    {
+      return false;
+    }
+    loadPage(cursor, (cursor->page + 1) % SESSION_LOG_PAGES);
+  }
+  return true;
+}
+
+// ----------------------------------------------------------------------------------------------------
+byte sessionLogPosition(const SessionCursor *cursor)
+{
+  return (cursor->page + SESSION_LOG_PAGES - oldest) % SESSION_LOG_PAGES;
+}
+
+// ----------------------------------------------------------------------------------------------------
+bool sessionLogClear()
+{
+  byte data[AT24C32_PAGE_SIZE];
+
+  memset(data, 0xFF, sizeof(data));
+  for (unsigned int address = 0; address < AT24C32_SIZE; address += AT24C32_PAGE_SIZE)
+  {
+    if (!at24Write(address, data, sizeof(data)))
+    {
+      return false;
+    }
+  }
+
+  blank = true;
+  oldest = 0;
+  newest = 0;
+  lastStart = 0;
+  lastEnd = 0;
+  at24AppendBegin(0);
+  return true;
+}
@@ -0,0 +1,78 @@
+#ifndef SESSIONLOG_H_
+#define SESSIONLOG_H_
+
+// Log of finished pomodoro sessions in the AT24C32 (see At24c32.h).
+//
+// The chip is a ring of 128 pages of 32 bytes. Each page starts with the full
+// start time of its first session, a keyframe, and the sessions after it are
+// stored as changes in varints (see Varint.h):
+//
+//   Page:     [start: 4] record... 0xFF
+//   Record:   [gap << 3 | interrupted << 2 | phase] [minutes << 1 or seconds << 1 | 1]
+//
+// gap is the seconds since the end of the previous session in the page, and a
+// duration of whole minutes is stored in minutes, so a session that follows
+// on from the last one within 15 seconds takes 2 bytes instead of 8. With the
+// keyframes that is about 3 bytes a session, some 1300 sessions on the chip.
+// No page depends on another: seeking to a time is a binary search over the
+// keyframes, and so is finding the newest page after a reset. Phase 3 is
+// never used, so a record never starts with 0xFF.
+//
+// Opening a page writes all of it, blank tail included, so no stale bytes from
+// the last time round the ring are ever read as records; once the ring is full
+// this drops the oldest page. The sessions after the first one in a page are
+// buffered until the page is full. Call sessionLogFlush() before a planned
+// power off, or lose the buffered ones on an unplanned one.
+
+#include "Arduino.h"
+#include "At24c32.h"
+
+#define SESSION_FOCUS           0
+#define SESSION_SHORT_BREAK     1
+#define SESSION_LONG_BREAK      2
+
+#define SESSION_INTERRUPTED     0x01    // flags: stopped before the timer ran out, the only flag kept
+
+#define SESSION_LOG_PAGES       (AT24C32_SIZE / AT24C32_PAGE_SIZE)
+
+typedef struct SessionRecord {
+  uint32_t start;       // seconds since 1 January 2000
+  uint16_t duration;    // seconds
+  byte phase;           // SESSION_FOCUS...
+  byte flags;
+} SessionRecord;
+
+// Where a read has got to. Only SessionLog changes it.
+typedef struct SessionCursor {
+  byte data[AT24C32_PAGE_SIZE];   // copy of the page being read
+  byte page;
+  byte offset;                    // of the next record in data
+  bool newest;                    // the page was still being written when it was read
+  uint32_t end;                   // of the previous session in the page
+} SessionCursor;
+
+// Finds the newest page. Returns false if the chip does not answer.
+extern bool sessionLogBegin();
+
+// Appends a session. Returns false if it starts before the last one, the
+// phase is not one of the above or the chip fails.
+extern bool sessionLogAppend(const SessionRecord *record);
+// Writes buffered sessions to the chip.
+extern bool sessionLogFlush();
+
+// True while there are no sessions.
+extern bool sessionLogEmpty();
+// Pages in use, up to SESSION_LOG_PAGES.
+extern byte sessionLogPages();
+
+// Places a cursor on the first session starting at start or later (0 for the oldest).
+extern void sessionLogSeek(SessionCursor *cursor, uint32_t start);
+// Reads the next session. Returns false at the end of the log.
+extern bool sessionLogNext(SessionCursor *cursor, SessionRecord *record);
+// Pages before the cursor's, out of sessionLogPages(), to show progress.
+extern byte sessionLogPosition(const SessionCursor *cursor);
+
+// Blanks the whole chip, which takes about 0.7 s.
+extern bool sessionLogClear();
+
+#endif
@@ -0,0 +1,234 @@
+#include "SessionStats.h"
+#include "BcdTime.h"
+
+#define SECONDS_PER_DAY   86400UL
+
+typedef struct DaySummary {
+  uint16_t minutes;       // focused, interrupted sessions included
+  byte sessions;          // completed focus sessions
+} DaySummary;
+
+static DaySummary summaries[STATS_DAYS];     // indexed by day % STATS_DAYS
+static unsigned int lastDay;                 // newest day in the table
+static bool started = false;                 // the table holds at least one day
+
+static unsigned int streak;                  // the run of days that ends on streakDay
+static unsigned int streakDay;
+static unsigned int bestStreak;
+
+// ----------------------------------------------------------------------------------------------------
+static unsigned int firstDay(byte range, unsigned int today)
+{
+  if (range == STATS_WEEK)
+  {
+    // Day 0 was a Saturday, so Monday is 5 days after it
+    return today - (today + 5) % 7;
+  }
+  if (range == STATS_MONTH)
+  {
+    BcdTime t;
+
+    bcdFromDayNumber(&t, today);
+    return today - bcdToBin(t.date) + 1;
+  }
+  return today;
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Cuts the range down to the days in the table. Returns how many are left and
+// sets first to the first of them and index to its summary; days after
+// lastDay have no sessions, and older ones have dropped out of the table.
+static byte window(byte range, unsigned int today, unsigned int *first, byte *index)
+{
+  unsigned int last = (today < lastDay) ? today : lastDay;
+
+  *first = firstDay(range, today);
+  if (!started || *first > last)
+  {
+    return 0;
+  }
+  if (lastDay - *first >= STATS_DAYS)
+  {
+    *first = lastDay - (STATS_DAYS - 1);
+  }
+  *index = *first % STATS_DAYS;
+  return (*first <= last) ? last - *first + 1 : 0;
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Folds a session into its day's summary and the streaks. Sessions come in time order.
+static void statsAdd(const SessionRecord *record)
+{
+  if (record->phase != SESSION_FOCUS)
+  {
+    return;
+  }
+
+  unsigned int day = record->start / SECONDS_PER_DAY;
+
+  // Blank the days between the newest one and this one
+  if (!started || day > lastDay)
+  {
+    unsigned int blank = (started && day - lastDay < STATS_DAYS) ? day - lastDay : STATS_DAYS;
+
+    while (blank--)
+    {
+      memset(&summaries[(day - blank) % STATS_DAYS], 0, sizeof(DaySummary));
+    }
+    lastDay = day;
+    started = true;
+  }
+  else if (lastDay - day >= STATS_DAYS)
+  {
+    return;
+  }
+
+  DaySummary *s = &summaries[day % STATS_DAYS];
+
+  s->minutes += (record->duration + 30) / 60;
+  if (record->flags & SESSION_INTERRUPTED)
+  {
+    return;
+  }
+  if (s->sessions < 255)
+  {
+    s->sessions++;
+  }
+
+  if (streak == 0 || day > streakDay + 1)
+  {
+    streak = 1;
+  }
+  else if (day == streakDay + 1)
+  {
+    streak++;
+  }
+  streakDay = day;
+  if (streak > bestStreak)
+  {
+    bestStreak = streak;
+  }
+}
+
+// ----------------------------------------------------------------------------------------------------
+void statsBegin()
+{
+  SessionCursor cursor;
+  SessionRecord record;
+
+  started = false;
+  streak = 0;
+  bestStreak = 0;
+  sessionLogSeek(&cursor, 0);
+  while (sessionLogNext(&cursor, &record))
+  {
+    statsAdd(&record);
+  }
+}
+
+// ----------------------------------------------------------------------------------------------------
+bool sessionClose(const SessionRecord *record)
+{
+  if (!sessionLogAppend(record))
+  {
+    return false;
+  }
+  statsAdd(record);
+  return true;
+}
+
+// ----------------------------------------------------------------------------------------------------
+unsigned int statsFocusMinutes(byte range, unsigned int today)
+{
+  unsigned int total = 0;
+  unsigned int first;
+  byte index;
+
+  for (byte count = window(range, today, &first, &index); count != 0; count--)
+  {
+    total += summaries[index].minutes;
+    if (++index == STATS_DAYS)
+    {
+      index = 0;
+    }
+  }
+  return total;
+}
+
+// ----------------------------------------------------------------------------------------------------
+unsigned int statsSessions(byte range, unsigned int today)
+{
+  unsigned int total = 0;
+  unsigned int first;
+  byte index;
+
+  for (byte count = window(range, today, &first, &index); count != 0; count--)
+  {
+    total += summaries[index].sessions;
+    if (++index == STATS_DAYS)
+    {
+      index = 0;
+    }
+  }
+  return total;
+}
+
+// ----------------------------------------------------------------------------------------------------
+unsigned int statsBestDay(byte range, unsigned int today, unsigned int *bestDay)
+{
+  unsigned int best = 0;
+  unsigned int day;
+  byte index;
+
+  for (byte count = window(range, today, &day, &index); count != 0; count--, day++)
+  {
+    if (summaries[index].minutes > best)
+    {
+      best = summaries[index].minutes;
+      if (bestDay != NULL)
+      {
+        *bestDay = day;
+      }
+    }
+    if (++index == STATS_DAYS)
+    {
+      index = 0;
+    }
+  }
+  return best;
+}
+
+// ----------------------------------------------------------------------------------------------------
+byte statsStreak(byte range, unsigned int today)
+{
+  byte best = 0;
+  byte run = 0;
+  unsigned int first;
+  byte index;
+
+  for (byte count = window(range, today, &first, &index); count != 0; count--)
+  {
+    run = (summaries[index].sessions > 0) ? run + 1 : 0;
+    if (run > best)
+    {
+      best = run;
+    }
+    if (++index == STATS_DAYS)
+    {
+      index = 0;
+    }
+  }
+  return best;
+}
+
+// ----------------------------------------------------------------------------------------------------
+unsigned int statsCurrentStreak(unsigned int today)
+{
+  return (streak != 0 && streakDay + 1 >= today) ? streak : 0;
+}
+
+// ----------------------------------------------------------------------------------------------------
+unsigned int statsBestStreak()
+{
+  return bestStreak;
+}
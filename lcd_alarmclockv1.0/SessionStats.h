@@ -0,0 +1,54 @@
+#ifndef SESSIONSTATS_H_
+#define SESSIONSTATS_H_
+
+// Pomodoro statistics for the stats screens, answered from per-day summaries.
+//
+// Each day gets a 3 byte summary in a RAM table of the last 35 days, which
+// covers the longest month and five weeks. sessionClose() appends a finished
+// session to the session log (see SessionLog.h) and folds it into its day's
+// summary, and statsBegin() rebuilds the table after a reset with one pass
+// over the log. Sessions appended with sessionLogAppend() alone are not seen
+// until the next statsBegin().
+// The current and best streaks are kept as running values, so they are not
+// limited to the table.
+//
+// Cost of the queries: each walks at most 31 summaries in RAM, a few tens of
+// microseconds, on under 10 bytes of stack; STATS_MONTH adds a day number to
+// date conversion. None of them reads the EEPROM. The table and the streaks
+// take 114 bytes of RAM in all.
+//
+// Only focus sessions count. Minutes include interrupted sessions, since the
+// time was still spent focusing; the session count and the streaks only
+// include completed ones. A streak is a run of days with at least one.
+
+#include "Arduino.h"
+#include "SessionLog.h"
+
+#define STATS_DAYS    35
+
+// Ranges, each ending with today
+#define STATS_TODAY   0
+#define STATS_WEEK    1       // since Monday
+#define STATS_MONTH   2       // since the 1st
+
+// Rebuilds the summaries from the session log, up to 0.5 s on a full log.
+extern void statsBegin();
+// Appends a finished session to the log and adds it to the summaries. Returns
+// false, leaving both as they were, if sessionLogAppend() refuses it.
+extern bool sessionClose(const SessionRecord *record);
+
+// Minutes focused in the range ending on today (a bcdDayNumber()).
+extern unsigned int statsFocusMinutes(byte range, unsigned int today);
+// Completed focus sessions in the range.
+extern unsigned int statsSessions(byte range, unsigned int today);
+// Most minutes focused on one day of the range; sets day to that day if it is not NULL.
+extern unsigned int statsBestDay(byte range, unsigned int today, unsigned int *day);
+// Longest streak of days within the range.
+extern byte statsStreak(byte range, unsigned int today);
+
+// The streak that today or yesterday ended, 0 if neither had a completed session.
+extern unsigned int statsCurrentStreak(unsigned int today);
+// The longest streak in the whole log.
+extern unsigned int statsBestStreak();
+
+#endif
@@ -0,0 +1,148 @@
+#include "SpiNorFlash.h"
+
+#define NOR_READ          0x03
+#define NOR_PAGE_PROGRAM  0x02
+#define NOR_SECTOR_ERASE  0x20
+#define NOR_WRITE_ENABLE  0x06
+#define NOR_READ_STATUS   0x05
+#define NOR_JEDEC_ID      0x9F
+#define NOR_WAKE          0xAB
+
+#define NOR_STATUS_BUSY   0x01
+
+#define SELECT()          (NOR_CS_PORT &= ~NOR_CS_BIT)
+#define DESELECT()        (NOR_CS_PORT |= NOR_CS_BIT)
+
+// ----------------------------------------------------------------------------------------------------
+// SPI mode 0: data changes while the clock is low and is sampled on the rising edge.
+static byte transfer(byte out)
+{
+  byte in = 0;
+
+  for (byte bit = 0x80; bit; bit >>= 1)
+  {
+    if (out & bit)
+    {
+      NOR_MOSI_PORT |= NOR_MOSI_BIT;
+    }
+    else
+    {
+      NOR_MOSI_PORT &= ~NOR_MOSI_BIT;
+    }
+    NOR_SCK_PORT |= NOR_SCK_BIT;
+    if (NOR_MISO_PIN & NOR_MISO_BIT)
+    {
+      in |= bit;
+    }
+    NOR_SCK_PORT &= ~NOR_SCK_BIT;
+  }
+  return in;
+}
+
+// ----------------------------------------------------------------------------------------------------
+void SpiNorFlash::begin()
+{
+  DESELECT();
+  NOR_CS_DDR |= NOR_CS_BIT;
+  NOR_SCK_PORT &= ~NOR_SCK_BIT;
+  NOR_SCK_DDR |= NOR_SCK_BIT;
+  NOR_MOSI_DDR |= NOR_MOSI_BIT;
+
+  SELECT();
+  transfer(NOR_WAKE);
+  DESELECT();
+  delayMicroseconds(30);
+}
+
+// ----------------------------------------------------------------------------------------------------
+uint32_t SpiNorFlash::capacity()
+{
+  waitReady();
+  SELECT();
+  transfer(NOR_JEDEC_ID);
+  byte maker = transfer(0);
+  transfer(0);
+  byte size = transfer(0);      // log2 of the size in bytes
+  DESELECT();
+
+  if (maker == 0x00 || maker == 0xFF || size < 16 || size > 24)
+  {
+    return 0;
+  }
+  return 1UL << size;
+}
+
+// ----------------------------------------------------------------------------------------------------
+void SpiNorFlash::read(uint32_t address, void *data, unsigned int length)
+{
+  byte *p = (byte *)data;
+
+  waitReady();
+  command(NOR_READ, address);
+  while (length--)
+  {
+    *p++ = transfer(0);
+  }
+  DESELECT();
+}
+
+// ----------------------------------------------------------------------------------------------------
+void SpiNorFlash::program(uint32_t address, const void *data, unsigned int length)
+{
+  const byte *p = (const byte *)data;
+
+  waitReady();
+  writeEnable();
+  command(NOR_PAGE_PROGRAM, address);
+  while (length--)
+  {
+    transfer(*p++);
+  }
+  DESELECT();
+}
+
+// ----------------------------------------------------------------------------------------------------
+void SpiNorFlash::eraseSector(uint32_t address)
+{
+  waitReady();
+  writeEnable();
+  command(NOR_SECTOR_ERASE, address);
+  DESELECT();
+}
+
+// ----------------------------------------------------------------------------------------------------
+bool SpiNorFlash::busy()
+{
+  SELECT();
+  transfer(NOR_READ_STATUS);
+  byte status = transfer(0);
+  DESELECT();
+  return status & NOR_STATUS_BUSY;
+}
+
+// ----------------------------------------------------------------------------------------------------
+void SpiNorFlash::waitReady()
+{
+  while (busy())
+  {
+  }
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Selects the chip and sends an opcode with a 24 bit address. The caller deselects.
+void SpiNorFlash::command(byte op, uint32_t address)
+{
+  SELECT();
+  transfer(op);
+  transfer(address >> 16);
+  transfer(address >> 8);
+  transfer(address);
+}
+
+// ----------------------------------------------------------------------------------------------------
+void SpiNorFlash::writeEnable()
+{
+  SELECT();
+  transfer(NOR_WRITE_ENABLE);
+  DESELECT();
+}
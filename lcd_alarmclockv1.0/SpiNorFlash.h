@@ -0,0 +1,49 @@
+#ifndef SPINORFLASH_H_
+#define SPINORFLASH_H_
+
+// SPI NOR flash (Winbond W25Qxx and the many chips with the same commands)
+// for the NorFlash interface.
+//
+// The hardware SPI pins 11 and 12 drive the LCD's E and RS lines, so SPI is
+// bit-banged on pins the clock does not use, with direct port access: a bit
+// takes under a microsecond and a 256 byte page about 2 ms. Every port
+// change is a single set or clear bit instruction, so the LED interrupt's
+// writes to PORTB cannot undo them.
+
+#include "Arduino.h"
+#include "NorFlash.h"
+
+// Chip select on pin 7, clock on 13, data in on A0 and out on A1.
+#ifndef NOR_CS_PORT
+#define NOR_CS_PORT     PORTD
+#define NOR_CS_DDR      DDRD
+#define NOR_CS_BIT      _BV(7)
+#define NOR_SCK_PORT    PORTB
+#define NOR_SCK_DDR     DDRB
+#define NOR_SCK_BIT     _BV(5)
+#define NOR_MOSI_PORT   PORTC
+#define NOR_MOSI_DDR    DDRC
+#define NOR_MOSI_BIT    _BV(0)
+#define NOR_MISO_PIN    PINC
+#define NOR_MISO_BIT    _BV(1)
+#endif
+
+class SpiNorFlash : public NorFlash
+{
+  public:
+    // Sets up the pins and wakes the chip from power down.
+    void begin();
+
+    uint32_t capacity();
+    void read(uint32_t address, void *data, unsigned int length);
+    void program(uint32_t address, const void *data, unsigned int length);
+    void eraseSector(uint32_t address);
+    bool busy();
+
+  private:
+    void waitReady();
+    void command(byte op, uint32_t address);
+    void writeEnable();
+};
+
+#endif
@@ -0,0 +1,44 @@
+#include "Varint.h"
+
+// ----------------------------------------------------------------------------------------------------
+byte *varintWrite(byte *dest, uint32_t value)
+{
+  while (value >= 0x80)
+  {
+    *dest++ = (byte)value | 0x80;
+    value >>= 7;
+  }
+  *dest++ = value;
+  return dest;
+}
+
+// ----------------------------------------------------------------------------------------------------
+const byte *varintRead(const byte *src, const byte *end, uint32_t *value)
+{
+  uint32_t result = 0;
+
+  for (byte shift = 0; src < end && shift < 7 * VARINT_MAX_SIZE; shift += 7)
+  {
+    byte b = *src++;
+
+    result |= (uint32_t)(b & 0x7F) << shift;
+    if (!(b & 0x80))
+    {
+      *value = result;
+      return src;
+    }
+  }
+  return NULL;
+}
+
+// ----------------------------------------------------------------------------------------------------
+uint32_t zigzagEncode(int32_t value)
+{
+  return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+// ----------------------------------------------------------------------------------------------------
+int32_t zigzagDecode(uint32_t value)
+{
+  return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
@@ -0,0 +1,23 @@
+#ifndef VARINT_H_
+#define VARINT_H_
+
+// Variable length integers for the history logs.
+//
+// Seven bits go in each byte, low bits first, and the top bit is set on every
+// byte but the last, so values below 128 take one byte and values below
+// 16384 two. Signed changes are zigzag mapped first (0, -1, 1, -2... become
+// 0, 1, 2, 3...), so small steps either way stay short too.
+
+#include "Arduino.h"
+
+#define VARINT_MAX_SIZE   5       // a full 32 bit value
+
+// Writes value and returns the position after it.
+extern byte *varintWrite(byte *dest, uint32_t value);
+// Reads a value and returns the position after it, or NULL if it runs on past end.
+extern const byte *varintRead(const byte *src, const byte *end, uint32_t *value);
+
+extern uint32_t zigzagEncode(int32_t value);
+extern int32_t zigzagDecode(uint32_t value);
+
+#endif
@@ -0,0 +1,69 @@
+#include "Widgets.h"
+
+// ----------------------------------------------------------------------------------------------------
+TextField::TextField(DisplayBackend &display, byte col, byte row, byte width) :
+  display(display), col(col), row(row), width(width)
+{
+}
+
+// ----------------------------------------------------------------------------------------------------
+void TextField::set(const char *text)
+{
+  display.drawText(col, row, text, width);
+}
+
+// ----------------------------------------------------------------------------------------------------
+BigDigits::BigDigits(DisplayBackend &display, byte col, byte row) :
+  display(display), col(col), row(row)
+{
+}
+
+// ----------------------------------------------------------------------------------------------------
+void BigDigits::set(const char *text)
+{
+  byte x = col;
+
+  while (*text && x < display.columns())
+  {
+    x += display.drawBigChar(x, row, *text++);
+  }
+}
+
+// ----------------------------------------------------------------------------------------------------
+Gauge::Gauge(DisplayBackend &display, byte col, byte row, byte width) :
+  display(display), col(col), row(row), width(width)
+{
+}
+
+// ----------------------------------------------------------------------------------------------------
+void Gauge::set(int value, int max)
+{
+  byte steps = display.barSteps();
+  unsigned int total = (unsigned int)width * steps;
+  unsigned int filled = 0;
+
+  if (max > 0 && value > 0)
+  {
+    filled = (value >= max) ? total : (unsigned long)value * total / max;
+  }
+
+  for (byte i = 0; i < width; i++)
+  {
+    byte level = (filled > steps) ? steps : filled;
+
+    display.drawBarCell(col + i, row, level);
+    filled -= level;
+  }
+}
+
+// ----------------------------------------------------------------------------------------------------
+Icon::Icon(DisplayBackend &display, byte col, byte row) :
+  display(display), col(col), row(row)
+{
+}
+
+// ----------------------------------------------------------------------------------------------------
+void Icon::set(const byte *bitmap)
+{
+  display.drawIcon(col, row, bitmap);
+}
@@ -0,0 +1,62 @@
+#ifndef WIDGETS_H_
+#define WIDGETS_H_
+
+// Display widgets.
+//
+// Widgets only remember where they are; the backend decides how to draw them
+// and what actually needs to reach the panel. A screen written against these
+// runs unchanged on the 16x2 LCD (LcdBackend.h) and the SSD1306 OLED
+// (OledBackend.h, with the OLED sketch).
+
+#include "Arduino.h"
+#include "DisplayBackend.h"
+
+// Single line of text of fixed width.
+class TextField
+{
+  public:
+    TextField(DisplayBackend &display, byte col, byte row, byte width);
+    void set(const char *text);
+
+  private:
+    DisplayBackend &display;
+    byte col, row, width;
+};
+
+// Two row high clock digits, e.g. "12:34".
+class BigDigits
+{
+  public:
+    BigDigits(DisplayBackend &display, byte col, byte row);
+    void set(const char *text);
+
+  private:
+    DisplayBackend &display;
+    byte col, row;
+};
+
+// Horizontal bar showing value out of max.
+class Gauge
+{
+  public:
+    Gauge(DisplayBackend &display, byte col, byte row, byte width);
+    void set(int value, int max);
+
+  private:
+    DisplayBackend &display;
+    byte col, row, width;
+};
+
+// Single cell icon (see DisplayBackend::drawIcon()).
+class Icon
+{
+  public:
+    Icon(DisplayBackend &display, byte col, byte row);
+    void set(const byte *bitmap);
+
+  private:
+    DisplayBackend &display;
+    byte col, row;
+};
+
+#endif
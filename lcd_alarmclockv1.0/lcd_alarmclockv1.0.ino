@@ -15,7 +15,7 @@
 * 2. Arduino DS3231 Real Time Clock Module Tutorial, created by Dejan Nedelkovski --> www.HowToMechatronics.com
 * Link: https://howtomechatronics.com/tutorials/arduino/arduino-ds3231-real-time-clock-tutorial/
 * 
-* 2.1 Download the DS3231 libary from http://www.rinkydinkelectronics.com
+* 2.1 The DS3231 libary from http://www.rinkydinkelectronics.com has since been replaced by Ds3231Regs.h
 * 
 * 3. How to Make an Arduino Alarm Clock Using a Real-Time Clock and LCD Screen
 * Link: https://maker.pro/arduino/projects/arduino-alarm-clock-using-real-time-clock-lcd-screen
@@ -25,20 +25,30 @@
 * 
 */
 
-#include <DS3231.h>
 #include <Wire.h>
 #include <LiquidCrystal.h>
 #include "DHT.h"
-
-// The pins the LED is connected to
-#define green_led 8
-#define red_led 9
+#include "Ds3231Regs.h"
+#include "SensorModel.h"
+#include "PageRotator.h"
+#include "LcdBackend.h"
+#include "Widgets.h"
+#include "LedEffects.h"
+#include "SessionLog.h"
+#include "CsvExport.h"
+#include "SessionStats.h"
+
+// Uncomment if a SPI NOR flash (W25Qxx) is fitted on pins 7, 13, A0 and A1 (see SpiNorFlash.h),
+// to keep a climate sample every 10 minutes for as long as the chip has room (see FlashLog.h).
+//#define CLIMATE_HISTORY
 
 // Initialise the LCD with the arduino. 
 LiquidCrystal lcd(12, 11, 5, 4, 3, 2);
-DS3231 rtc(SDA, SCL);
 
-Time ti ;
+// All DS3231 registers, refreshed with one I2C burst every RTC_READ_INTERVAL ms
+#define RTC_READ_INTERVAL 250
+Ds3231Registers rtc;
+unsigned long prevRtcMillis = 0;
 
 // Digital pin connected to the DHT sensor
 #define DHTPIN 6
@@ -46,17 +56,121 @@ Time ti ;
 
 DHT dht(DHTPIN, DHTTYPE);
 
-// Assign via number to the buzzer
-#define buz 10
+// Minimum time between DHT reads (the DHT11 needs at least 1 second)
+#define DHT_UPDATE_INTERVAL 2000
+
+unsigned long prevDhtMillis = 0;
+bool dhtFailed = false;
+
+// Version of the model data each page last drew
+unsigned int drawnTimeVersion = 0;
+unsigned int drawnClimateVersion = 0;
+bool drawnDhtFailed = false;
+
+// True while the alarm has the display, the LEDs and the buzzer
+bool alarmRinging = false;
+
+// Sending 'e' over serial exports the session log as CSV (see CsvExport.h)
+#define EXPORT_COMMAND 'e'
+byte drawnExportProgress = 0;
+
+#ifdef CLIMATE_HISTORY
+#include "SpiNorFlash.h"
+#include "FlashLog.h"
+#include "ClimateRecord.h"
+
+#define HISTORY_INTERVAL 600000UL
+
+SpiNorFlash norFlash;
+FlashLog history(norFlash);
+unsigned long prevHistoryMillis = 0;
+
+// The last sample logged and its day; the next one is stored as the change from it
+ClimateSample lastSample;
+unsigned int lastSampleDay = 0xFFFF;
+#endif
+
+// Screens are drawn through the widget layer; the backend only sends changed cells
+LcdBackend display(lcd);
+TextField line1(display, 0, 0, 16);
+TextField line2(display, 0, 1, 16);
+TextField timeField(display, 6, 0, 10);
+TextField dateField(display, 6, 1, 10);
+Gauge exportGauge(display, 0, 1, 16);
+
+// Export progress, shown instead of the pages while an export runs
+void renderExport(bool entering) {
+  if (entering) {
+    display.clear();
+  }
+  drawnExportProgress = csvExportProgress();
+
+  char line[17];
+
+  strcpy(line, "Export ");
+  utoa(drawnExportProgress, line + strlen(line), 10);
+  strcat(line, " %");
+  line1.set(line);
+  exportGauge.set(drawnExportProgress, 100);
+}
+
+// Page 1: time and date
+void renderTimePage(bool entering) {
+  if (entering) {
+    display.clear();
+    line1.set("Time:");
+    line2.set("Date:");
+  }
+  drawnTimeVersion = modelVersion(MODEL_TIME);
 
-// Define the time elements
-int Hor, Min, Sec;
+  timeField.set(modelTimeText());
+  dateField.set(modelDateText());
+}
+
+bool timePageChanged() {
+  return modelVersion(MODEL_TIME) != drawnTimeVersion;
+}
+
+// Page 2: humidity and temperature
+void renderClimatePage(bool entering) {
+  if (entering || dhtFailed != drawnDhtFailed) {
+    display.clear();
+  }
+  drawnClimateVersion = modelVersion(MODEL_CLIMATE);
+  drawnDhtFailed = dhtFailed;
+
+  if (dhtFailed) {
+    line1.set("Failed to read");
+    line2.set("from DHT sensor!");
+    return;
+  }
+
+  char line[17];
+
+  strcpy(line, "Humid. ");
+  strcat(line, modelHumidityText());
+  strcat(line, " %");
+  line1.set(line);
+
+  strcpy(line, "Temp. ");
+  strcat(line, modelTemperatureText());
+  strcat(line, " C.");
+  line2.set(line);
+
+  //Here you could also add a Heat Index or dew point, both in Celcius and Fahrerheit, with modelHeatIndex() and modelDewPoint() from SensorModel.
+}
+
+bool climatePageChanged() {
+  return modelVersion(MODEL_CLIMATE) != drawnClimateVersion || dhtFailed != drawnDhtFailed;
+}
+
+// The screens shown in turn, 5 seconds each
+const Page pages[] PROGMEM = {
+  { renderTimePage, 5000, timePageChanged },
+  { renderClimatePage, 5000, climatePageChanged },
+};
 
 void setup() {
-  // Declare the LEDs as an output
-  pinMode(green_led, OUTPUT);
-  pinMode(red_led, OUTPUT);
-  
   // Switch on the LCD screen
   lcd.begin(16, 2);
 
@@ -66,15 +180,27 @@ void setup() {
   // Uncomment the next line if you are using an Arduino Leonardo
   //while (!Serial) {}
   
-  // Initialize the rtc object
-  rtc.begin();
-
   // Setup Serial connection
   Serial.begin(9600);
 
-  pinMode(buz, OUTPUT);
+  // The LEDs on pins 8 and 9 and the buzzer on pin 10 (see LedEffects.h)
+  effectsBegin();
   lcd.begin(16,2);
 
+  // Pomodoro sessions are kept in the EEPROM on the DS3231 module
+  if (!sessionLogBegin()) {
+    Serial.println("No session EEPROM found");
+  }
+  // Per-day summaries for the statistics, from one pass over the log (see SessionStats.h)
+  statsBegin();
+
+#ifdef CLIMATE_HISTORY
+  norFlash.begin();
+  if (!history.begin()) {
+    Serial.println("No history flash found");
+  }
+#endif
+
   // Welcome Messages:
   lcd.setCursor(0,0);
   lcd.print("Welcome to");
@@ -96,130 +222,116 @@ void setup() {
   delay(2000);
   lcd.clear();
 
-  // Set the date and time
-  // Set Day-of-Week to SUNDAY
-  rtc.setDOW(FRIDAY);
-  
-  // Set the time to 12:00:00 (24hr format)
-  rtc.setTime(13, 35, 0);
-  
-  // Set the date to January 1st, 20
-  rtc.setDate(30, 9, 2022);  
+  // Set the date and time, all fields in BCD:
+  // 13:35:00 (24hr format), Friday (Monday is 1), 30.09.2022
+  BcdTime start = { 0x00, 0x35, 0x13, 5, 0x30, 0x09, 0x22 };
+  ds3231SetTime(&start);
   
   delay(500);
+
+  pagesBegin(pages, sizeof(pages) / sizeof(pages[0]));
 }
 
 
 
 void loop() {
   // DHT
-  // Read Humidity
-  float h = dht.readHumidity();
-  
-  // Read Temperature
-  float temp = dht.readTemperature();
-  
-  // Read temperature as Fahrenheit (isFahrenheit = true)
-  float f = dht.readTemperature(true);
-
-  // Check if any reads failed and exit early (to try again)
-  if (isnan(h) || isnan(temp) || isnan(f)) {
-    lcd.setCursor(0,0);
-    lcd.print("Failed to read ");
-    lcd.setCursor(0,1);
-    lcd.print("from DHT sensor!");
-    delay(500);
-    return;
-  }
+  unsigned long currentMillis = millis();
+  if (currentMillis - prevDhtMillis >= DHT_UPDATE_INTERVAL) {
+    prevDhtMillis = currentMillis;
 
-  // Compute heat index in Fahrenheit (the default)
-  float hif = dht.computeHeatIndex(f, h);
-
-  // Compute heat index in Celsius (isFahreheit = false)
-  float hic = dht.computeHeatIndex(temp, h, false);
+    // Read Humidity
+    float h = dht.readHumidity();
   
-  // RTC
-  ti = rtc.getTime();
-  Hor = ti.hour;
-  Min = ti.min;
-  Sec = ti.sec;
-
- lcd.setCursor(0,0);
-
- lcd.print("Time: ");
-
- lcd.print(rtc.getTimeStr());
-
- lcd.setCursor(0,1);
-
- lcd.print("Date: ");
-
- lcd.print(rtc.getDateStr());
-
- delay (5000);
-
- // Display the Temperature and Humidity:
- 
-  lcd.setCursor(0,0);
-
-  lcd.print("Humid. ");
-
-  lcd.print(h);
-
-  lcd.print(" %");
-
-  lcd.setCursor(0,1);
-
-  lcd.print("Temp. ");
-
-  lcd.print(temp);
-
-  lcd.print(" C.  ");
-
-  //Here you could also add a Heat Index, both in Celcius and Fahrerheit. Check the original project (#3) on further instructions.
+    // Read Temperature
+    float temp = dht.readTemperature();
 
-  delay (5000);
- 
-  //Comparing the current time with the Alarm time 
-  if( Hor == 13 && (Min == 36 || Min == 00)) {
+    // On a failed read keep the last good sample; the climate page shows the error
+    dhtFailed = isnan(h) || isnan(temp);
 
-  Buzzer();
-
-  Buzzer();
+    // From here on everything is fixed point (see SensorMath.h). Derived values
+    // and their text are only computed when a page asks for them (see SensorModel.h).
+    if (!dhtFailed) {
+      modelPublishClimate(temp * 256, h * 256);
+    }
+  }
+  
+  // RTC, kept in BCD all the way to the display (see BcdTime.h)
+  if (currentMillis - prevRtcMillis >= RTC_READ_INTERVAL) {
+    prevRtcMillis = currentMillis;
+    if (ds3231Read(&rtc)) {
+      modelPublishTime(&rtc.time);
+    }
+  }
 
-  lcd.clear();
+#ifdef CLIMATE_HISTORY
+  // Once there is a time and a sample to go with it
+  if (currentMillis - prevHistoryMillis >= HISTORY_INTERVAL && modelVersion(MODEL_TIME) && modelVersion(MODEL_CLIMATE)) {
+    prevHistoryMillis = currentMillis;
 
-  lcd.print("Alarm ON");
+    // Records are filed under bcdDayNumber() of their date; a keyframe starts each day and each run
+    ClimateSample sample = { modelHour() * 60U + modelMinute(), modelCelsius(), modelHumidity() };
+    unsigned int day = bcdDayNumber(modelTime());
+    byte record[CLIMATE_RECORD_MAX];
+    byte length = climateEncode(record, &sample, (day == lastSampleDay) ? &lastSample : NULL);
 
-  lcd.setCursor(0,1);
-
-  lcd.print("Alarming!!");
+    history.append(day, record, length);
+    lastSample = sample;
+    lastSampleDay = day;
+  }
+#endif
+
+  // The export goes out a row at a time as the serial buffer empties, so the clock keeps running
+  if (Serial.available() && Serial.read() == EXPORT_COMMAND && !csvExportRunning()) {
+    csvExportBegin(Serial);
+    if (!alarmRinging) {
+      renderExport(true);
+    }
+  }
+  if (csvExportRunning()) {
+    if (!csvExportUpdate() && !alarmRinging) {
+      pagesInvalidate();
+    }
+    else if (!alarmRinging && csvExportProgress() != drawnExportProgress) {
+      renderExport(false);
+    }
+  }
 
-  Buzzer();
+  //Comparing the current time with the Alarm time (BCD, so 13:36 is 0x13 and 0x36)
+  bool alarmTime = modelTime()->hour == 0x13 && (modelTime()->minute == 0x36 || modelTime()->minute == 0x00);
 
-  Buzzer();
+  if (alarmTime && !alarmRinging) {
+    alarmRinging = true;
 
-  } 
+    // Green and red alternate while the buzzer sounds, all from the timer interrupt
+    effectsPlay(LED_GREEN, alarmGreen);
+    effectsPlay(LED_RED, alarmRed);
+    effectsPlay(LED_BUZZER, alarmBuzzer);
 
- delay(500); 
+    display.clear();
+    line1.set("Alarm ON");
+    line2.set("Alarming!!");
+  }
+  else if (!alarmTime && alarmRinging) {
+    alarmRinging = false;
+    effectsOff();
+
+    // The alarm took over the display
+    if (csvExportRunning()) {
+      renderExport(true);
+    }
+    else {
+      pagesInvalidate();
+    }
+  }
 
+  // Display the current page, switching pages when its time is up
+  if (!alarmRinging && !csvExportRunning()) {
+    pagesUpdate();
+  }
 }
 
-void Buzzer() {
-
-  digitalWrite(buz,HIGH);
-  
-  // Turn the LED on
-  digitalWrite(green_led, HIGH);
-  digitalWrite(red_led, LOW);
-  delay(500);
-  digitalWrite(green_led, LOW);
-  digitalWrite(red_led, HIGH);
-  delay(500);
-  digitalWrite(buz, LOW);
-
-
- // Wait half a second before repeating
-  delay(500);
-
+// Runs the LED and buzzer scripts, about once per millisecond
+SIGNAL(TIMER0_COMPA_vect) {
+  effectsISR();
 }
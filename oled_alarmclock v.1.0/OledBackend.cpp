@@ -0,0 +1,151 @@
+#include "OledBackend.h"
+
+// Shadow keys. Characters use their own code (below 0x80).
+#define KEY_BIG       0x80    // + big character index * 4 + quadrant
+#define KEY_BAR       0xC0    // + level
+#define KEY_NONE      0xFF    // unknown, always redrawn
+
+#define BAR_PIXELS    0x7E    // rows 1-6 of a tile column
+
+// ----------------------------------------------------------------------------------------------------
+OledBackend::OledBackend(U8X8 &u8x8) : u8x8(u8x8)
+{
+  memset(shadow, KEY_NONE, sizeof(shadow));
+}
+
+// ----------------------------------------------------------------------------------------------------
+byte OledBackend::columns()
+{
+  return OLED_BACKEND_COLUMNS;
+}
+
+// ----------------------------------------------------------------------------------------------------
+byte OledBackend::rows()
+{
+  return OLED_BACKEND_ROWS;
+}
+
+// ----------------------------------------------------------------------------------------------------
+void OledBackend::clear()
+{
+  u8x8.clearDisplay();
+  memset(shadow, ' ', sizeof(shadow));
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Records key for a tile and returns true if it differs from what is there.
+bool OledBackend::changed(byte col, byte row, byte key)
+{
+  if (col >= OLED_BACKEND_COLUMNS || row >= OLED_BACKEND_ROWS)
+  {
+    return false;
+  }
+  if (shadow[row][col] == key && key != KEY_NONE)
+  {
+    return false;
+  }
+  shadow[row][col] = key;
+  return true;
+}
+
+// ----------------------------------------------------------------------------------------------------
+void OledBackend::drawText(byte col, byte row, const char *text, byte width)
+{
+  for (byte i = 0; i < width; i++)
+  {
+    char c = *text ? *text++ : ' ';
+
+    if (changed(col + i, row, c & 0x7F))
+    {
+      u8x8.drawGlyph(col + i, row, c);
+    }
+  }
+}
+
+// ----------------------------------------------------------------------------------------------------
+byte OledBackend::drawBigChar(byte col, byte row, char c)
+{
+  byte index;
+
+  if (c >= '0' && c <= '9')
+  {
+    index = c - '0';
+  }
+  else if (c == ':')
+  {
+    index = 10;
+  }
+  else
+  {
+    c = ' ';
+    index = 11;
+  }
+
+  // All four quadrants are checked (no short-circuit) so the shadow is complete.
+  byte key = KEY_BIG + index * 4;
+  bool dirty = changed(col, row, key);
+  dirty |= changed(col + 1, row, key + 1);
+  dirty |= changed(col, row + 1, key + 2);
+  dirty |= changed(col + 1, row + 1, key + 3);
+
+  if (dirty)
+  {
+    u8x8.draw2x2Glyph(col, row, c);
+  }
+  return 2;
+}
+
+// ----------------------------------------------------------------------------------------------------
+byte OledBackend::barSteps()
+{
+  return 8;
+}
+
+// ----------------------------------------------------------------------------------------------------
+void OledBackend::drawBarCell(byte col, byte row, byte level)
+{
+  if (level > 8)
+  {
+    level = 8;
+  }
+  // An empty cell looks the same as a blank character
+  if (changed(col, row, (level == 0) ? ' ' : KEY_BAR + level))
+  {
+    byte tile[8];
+
+    for (byte x = 0; x < 8; x++)
+    {
+      tile[x] = (x < level) ? BAR_PIXELS : 0;
+    }
+    u8x8.drawTile(col, row, 1, tile);
+  }
+}
+
+// ----------------------------------------------------------------------------------------------------
+void OledBackend::drawIcon(byte col, byte row, const byte *bitmap)
+{
+  if (bitmap == NULL)
+  {
+    drawText(col, row, "", 1);
+    return;
+  }
+  if (changed(col, row, KEY_NONE))
+  {
+    // Turn the five pixel wide rows into tile columns, centred in the tile.
+    byte tile[8] = { 0 };
+
+    for (byte y = 0; y < 8; y++)
+    {
+      byte line = pgm_read_byte(bitmap + y);
+
+      for (byte x = 0; x < 5; x++)
+      {
+        if (line & (0x10 >> x))
+        {
+          tile[x + 1] |= 1 << y;
+        }
+      }
+    }
+    u8x8.drawTile(col, row, 1, tile);
+  }
+}
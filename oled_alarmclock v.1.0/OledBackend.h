@@ -0,0 +1,48 @@
+#ifndef OLEDBACKEND_H_
+#define OLEDBACKEND_H_
+
+// SSD1306 (or SH1106) tile backend for the widget layer, drawn through U8x8.
+//
+// A shadow holds one key byte per 8x8 tile describing what was last drawn
+// there (a character, a quarter of a big character, or a bar level), and only
+// tiles whose key changes are sent over I2C. Icons have no key and are always
+// sent; they are a single tile each. Text uses whatever font the sketch set
+// with u8x8.setFont(), and big characters are the same font drawn 2x2.
+//
+// It lives with the OLED sketch, which depends on U8g2. The Arduino builder
+// only compiles a sketch's own folder, so DisplayBackend.h is a copy of the
+// one in lcd_alarmclockv1.0, kept the same.
+
+#include "Arduino.h"
+#include <U8x8lib.h>
+#include "DisplayBackend.h"
+
+#ifndef OLED_BACKEND_COLUMNS
+#define OLED_BACKEND_COLUMNS 16
+#endif
+#ifndef OLED_BACKEND_ROWS
+#define OLED_BACKEND_ROWS 8
+#endif
+
+class OledBackend : public DisplayBackend
+{
+  public:
+    OledBackend(U8X8 &u8x8);
+
+    byte columns();
+    byte rows();
+    void clear();
+    void drawText(byte col, byte row, const char *text, byte width);
+    byte drawBigChar(byte col, byte row, char c);
+    byte barSteps();
+    void drawBarCell(byte col, byte row, byte level);
+    void drawIcon(byte col, byte row, const byte *bitmap);
+
+  private:
+    bool changed(byte col, byte row, byte key);
+
+    U8X8 &u8x8;
+    byte shadow[OLED_BACKEND_ROWS][OLED_BACKEND_COLUMNS];
+};
+
+#endif
@@ -2,12 +2,15 @@
 #include <U8x8lib.h>
 #include <Wire.h> 
 #include <ds3231.h>
+#include "OledBackend.h"
 
 #ifdef U8X8_HAVE_HW_SPI
 #include <SPI.h>
 #endif
 
 U8X8_SSD1306_128X64_NONAME_SW_I2C u8x8(/* clock=*/ SCL, /* data=*/ SDA, /* reset=*/ U8X8_PIN_NONE);
+OledBackend display(u8x8);    // only sends the tiles that change
+struct ts t;
 
 void setup(void)
 {
@@ -23,6 +26,7 @@ void setup(void)
   
   u8x8.begin();
   u8x8.setPowerSave(0);
+  u8x8.setFont(u8x8_font_chroma48medium8_r);
   
   Wire.begin();
   DS3231_init(DS3231_CONTROL_INTCN);
@@ -30,7 +34,7 @@ void setup(void)
   t.min=30;
   t.sec=0;
   t.mday=29;
-  t.mon=09;
+  t.mon=9;
   t.year=2022;
   DS3231_set(t); 
  
@@ -38,7 +42,7 @@ void setup(void)
     if(t.hour>0){
 //       lcd.setCursor(3,0);
 //       lcd.print("Good Morning !");
-        u8x8.drawString(1,3,"Good Morning !");
+        display.drawText(1,3,"Good Morning !",14);
 
   }
   }
@@ -46,14 +50,14 @@ void setup(void)
     if(t.hour>19){
 //       lcd.setCursor(4,0);
 //       lcd.print("Good Night !");
-         u8x8.drawString(2,3,"Good Night !");
+         display.drawText(2,3,"Good Night !",12);
     }
   }
    if(t.hour<20){
     if(t.hour>12){
 //       lcd.setCursor(2,0);
 //       lcd.print("Good Afternoon !");
-         u8x8.drawString(2,3,"Good Afternoon !");        
+         display.drawText(0,3,"Good Afternoon !",16);        
     }
    }
 }
@@ -61,7 +65,12 @@ void setup(void)
 void loop(){ 
  DS3231_get(&t);
 
-  u8x8.setFont(u8x8_font_chroma48medium8_r);
+  // HH:MM in 2x2 characters on the top two rows
+  char text[6] = { (char)('0' + t.hour / 10), (char)('0' + t.hour % 10), ':',
+                   (char)('0' + t.min / 10), (char)('0' + t.min % 10), 0 };
+  for (byte i = 0, col = 3; text[i]; i++) {
+    col += display.drawBigChar(col, 0, text[i]);
+  }
 //  u8x8.drawString(1,3,"Hello World!");
 //  u8x8.drawString(3,3,"Hello World!");
 //  u8x8.drawString(5,3,"Hello World!");